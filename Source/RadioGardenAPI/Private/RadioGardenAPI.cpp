@@ -2,152 +2,436 @@
 
 #include "IRadioGardenAPI.h"
 #include "RadioGardenHttpRequest.h"
+#include "RadioGardenSingleFlight.h"
+#include "RadioGardenCancellation.h"
+#include "RadioGardenParsedCache.h"
+#include "RadioGardenResponseCache.h"
+#include "RadioGardenPlacesCatalog.h"
+#include "RadioGardenGeoArea.h"
+#include "RadioGardenRoute.h"
+#include "RadioGardenPrefetcher.h"
+#include "RadioGardenResponseParser.h"
+#include "RadioGardenStats.h"
+#include "RadioGardenScheduler.h"
 #include "Async/Async.h"
 #include "Dom/JsonObject.h"
-#include "Dom/JsonValue.h"
+#include "HAL/IConsoleManager.h"
+#include "Containers/Ticker.h"
+
+static TAutoConsoleVariable<int32> CVarRadioGardenNearbyMaxConcurrentRequests(
+    TEXT("RadioGarden.Nearby.MaxConcurrentRequests"),
+    6,
+    TEXT("Сколько мест поиск ближайших станций запрашивает одновременно"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarRadioGardenNearbyResultCachePrecision(
+    TEXT("RadioGarden.Nearby.ResultCache.Precision"),
+    6,
+    TEXT("Длина геохэша ячейки кэша результатов поиска ближайших станций (6 - около 1.2 x 0.6 км, 0 - кэш выключен)"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRadioGardenGeolocationRefreshSeconds(
+    TEXT("RadioGarden.Geolocation.RefreshSeconds"),
+    0.0f,
+    TEXT("Через сколько секунд геолокация сессии обновляется в фоне (0 - определяется один раз за сессию)"),
+    ECVF_Default);
 
-// ========== Places (Места) ==========
-
-void IRadioGardenAPI::GetPlaces(FRadioGardenPlacesResponse& OutResponse)
+namespace
 {
-    OutResponse = FRadioGardenPlacesResponse();
+    // Перенести ошибку HTTP уровня в ответ API
+    bool CheckHttpResult(const FRadioGardenHttpResult& Result, FRadioGardenApiResponse& OutResponse)
+    {
+        OutResponse.HttpResponseCode = Result.ResponseCode;
+
+        if (!Result.bSuccess)
+        {
+            if (Result.ResponseCode != 0)
+            {
+                OutResponse.Status = FRadioGardenHttpRequest::ConvertHttpStatus(Result.ResponseCode, Result.GetContentAsString());
+            }
+            else
+            {
+                OutResponse.Status = Result.bTimedOut ? ERadioGardenStatus::Timeout : ERadioGardenStatus::NetworkError;
+            }
+            OutResponse.ErrorMessage = Result.ErrorMessage;
+            OutResponse.bSuccessful = false;
+            return false;
+        }
 
-    FString ResponseContent;
-    FString ErrorMessage;
+        return true;
+    }
 
-    if (!FRadioGardenHttpRequest::ExecuteGet(TEXT("/ara/content/places"), ResponseContent, ErrorMessage))
+    bool IsCancelled(const FRadioGardenCancellationPtr& Cancellation)
     {
-        OutResponse.Status = ERadioGardenStatus::NetworkError;
-        OutResponse.ErrorMessage = ErrorMessage;
-        OutResponse.bSuccessful = false;
-        return;
+        return Cancellation.IsValid() && Cancellation->IsCancelled();
     }
 
-    TSharedPtr<FJsonObject> JsonObject;
-    if (!FRadioGardenHttpRequest::ParseJson(ResponseContent, JsonObject))
+    // Доставить ответ делегату в игровом потоке. Отмена проверяется и в игровом потоке,
+    // поэтому после CancelRequest из игрового потока делегат уже не вызывается
+    template <typename DelegateType, typename ResponseType>
+    void DispatchToGameThread(const DelegateType& OnCompleted, ResponseType Response, const FRadioGardenCancellationPtr& Cancellation = nullptr)
     {
-        OutResponse.Status = ERadioGardenStatus::ParseError;
-        OutResponse.ErrorMessage = TEXT("Failed to parse JSON");
-        return;
+        if (IsCancelled(Cancellation))
+        {
+            return;
+        }
+
+        AsyncTask(ENamedThreads::GameThread, [OnCompleted, Response = MoveTemp(Response), Cancellation]()
+        {
+            if (!IsCancelled(Cancellation))
+            {
+                OnCompleted.ExecuteIfBound(Response);
+            }
+        });
+    }
+
+    // Доставить общий (объединённый) ответ делегату в игровом потоке
+    template <typename DelegateType, typename ResponseType>
+    void DispatchSharedToGameThread(const DelegateType& OnCompleted, const TSharedRef<const ResponseType, ESPMode::ThreadSafe>& Response,
+        const FRadioGardenCancellationPtr& Cancellation = nullptr)
+    {
+        if (IsCancelled(Cancellation))
+        {
+            return;
+        }
+
+        AsyncTask(ENamedThreads::GameThread, [OnCompleted, Response, Cancellation]()
+        {
+            if (!IsCancelled(Cancellation))
+            {
+                OnCompleted.ExecuteIfBound(*Response);
+            }
+        });
     }
 
-    // Получаем массив мест
-    const TArray<TSharedPtr<FJsonValue>>* PlacesArray;
-    if (!FRadioGardenHttpRequest::GetArraySafe(JsonObject, TEXT("data.list"), PlacesArray))
+    // Запросы одного типа ответа: объединение одновременных запросов и распаршенные ответы по версии содержимого
+    template <typename ResponseType>
+    struct TCoalescedEndpoint
     {
-        // Проверяем альтернативный путь
-        TSharedPtr<FJsonObject> DataObj;
-        if (FRadioGardenHttpRequest::GetObjectSafe(JsonObject, TEXT("data"), DataObj))
+        TRadioGardenSingleFlight<ResponseType> Flight;
+        TRadioGardenParsedCache<ResponseType> Parsed;
+    };
+
+    // Выполнить GET запрос, объединяя его с идентичными запросами, которые уже выполняются.
+    // Ответ скачивается и парсится один раз, результат получают все присоединившиеся.
+    // Если кэш ответов вернул ту же версию содержимого, берётся ранее распаршенный ответ.
+    // Присоединение более важного вызывающего поднимает приоритет ещё ожидающего запроса.
+    // Запрос отменяется, когда отменили свои вызовы все присоединившиеся; ответ отменённого запроса не разбирается
+    template <typename ResponseType>
+    void ExecuteCoalesced(TCoalescedEndpoint<ResponseType>& Target, const FString& Endpoint,
+        TFunction<void(const FRadioGardenHttpResult&, ResponseType&)>&& Parse,
+        typename TRadioGardenSingleFlight<ResponseType>::FWaiter&& OnParsed,
+        ERadioGardenRequestPriority Priority,
+        const FRadioGardenCancellationPtr& Cancellation)
+    {
+        const typename TRadioGardenSingleFlight<ResponseType>::FFlightPtr LeadFlight = Target.Flight.Join(Endpoint, MoveTemp(OnParsed), Cancellation);
+        if (!LeadFlight.IsValid())
+        {
+            FRadioGardenRequestScheduler::Get().Promote(Endpoint, Priority);
+            return;
+        }
+
+        const FRadioGardenCancellationRef FlightCancellation = LeadFlight->Cancellation;
+        FRadioGardenHttpRequest::ExecuteGetAsync(Endpoint, [&Target, Flight = LeadFlight.ToSharedRef(), Endpoint, Parse = MoveTemp(Parse)](FRadioGardenHttpResult&& Result)
         {
-            if (!FRadioGardenHttpRequest::GetArraySafe(DataObj, TEXT("list"), PlacesArray))
+            if (Flight->Cancellation->IsCancelled())
             {
-                OutResponse.Status = ERadioGardenStatus::ParseError;
-                OutResponse.ErrorMessage = TEXT("Invalid response format");
+                ResponseType Response;
+                Response.Status = ERadioGardenStatus::NetworkError;
+                Response.ErrorMessage = TEXT("Request cancelled");
+                Target.Flight.Complete(Flight, MoveTemp(Response));
                 return;
             }
+
+            if (Result.bSuccess)
+            {
+                if (TSharedPtr<const ResponseType, ESPMode::ThreadSafe> Cached = Target.Parsed.Find(Endpoint, Result.ContentVersion))
+                {
+                    FRadioGardenStats::ParseSkips.fetch_add(1, std::memory_order_relaxed);
+                    Target.Flight.Complete(Flight, Cached.ToSharedRef());
+                    return;
+                }
+            }
+
+            ResponseType Response;
+            Parse(Result, Response);
+
+            const TSharedRef<const ResponseType, ESPMode::ThreadSafe> SharedResponse = MakeShared<const ResponseType, ESPMode::ThreadSafe>(MoveTemp(Response));
+            if (SharedResponse->bSuccessful)
+            {
+                Target.Parsed.Add(Endpoint, Result.ContentVersion, SharedResponse);
+            }
+            Target.Flight.Complete(Flight, SharedResponse);
+        }, Priority, FlightCancellation);
+    }
+
+    FCriticalSection RequestsCriticalSection;
+    TMap<int32, TWeakPtr<FRadioGardenCancellationToken, ESPMode::ThreadSafe>> ActiveRequests;
+    int32 NextRequestId = 1;
+
+    // Реестр вычищается от завершённых вызовов, когда вырастает до этого размера (или вдвое)
+    constexpr int32 ActiveRequestsMinPrune = 64;
+    int32 ActiveRequestsPruneAt = ActiveRequestsMinPrune;
+
+    // Начать отменяемый вызов: токен отмены регистрируется под новым дескриптором.
+    // Реестр держит токен слабо: его держат продолжения вызова, с доставкой ответа запись становится пустой
+    FRadioGardenCancellationRef BeginCancellableRequest(FRadioGardenRequestHandle& OutHandle)
+    {
+        const FRadioGardenCancellationRef Cancellation = MakeShared<FRadioGardenCancellationToken, ESPMode::ThreadSafe>();
+
+        FScopeLock Lock(&RequestsCriticalSection);
+
+        if (ActiveRequests.Num() >= ActiveRequestsPruneAt)
+        {
+            for (auto It = ActiveRequests.CreateIterator(); It; ++It)
+            {
+                if (!It->Value.IsValid())
+                {
+                    It.RemoveCurrent();
+                }
+            }
+            ActiveRequestsPruneAt = FMath::Max(ActiveRequestsMinPrune, ActiveRequests.Num() * 2);
         }
-        else
+
+        OutHandle.Id = NextRequestId++;
+        ActiveRequests.Add(OutHandle.Id, Cancellation);
+        return Cancellation;
+    }
+}
+
+// ========== Cancellation (Отмена) ==========
+
+void IRadioGardenAPI::CancelRequest(const FRadioGardenRequestHandle& Handle)
+{
+    FRadioGardenCancellationPtr Cancellation;
+    {
+        FScopeLock Lock(&RequestsCriticalSection);
+        if (const TWeakPtr<FRadioGardenCancellationToken, ESPMode::ThreadSafe>* Found = ActiveRequests.Find(Handle.Id))
+        {
+            Cancellation = Found->Pin();
+            ActiveRequests.Remove(Handle.Id);
+        }
+    }
+
+    if (Cancellation.IsValid() && Cancellation->Cancel())
+    {
+        FRadioGardenStats::CancelledRequests.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// ========== Places (Места) ==========
+
+namespace
+{
+    const TCHAR* PlacesEndpoint = TEXT("/ara/content/places");
+
+    void ParsePlaces(const FRadioGardenHttpResult& Result, FRadioGardenPlacesResponse& OutResponse)
+    {
+        if (!CheckHttpResult(Result, OutResponse))
+        {
+            return;
+        }
+
+        if (!FRadioGardenResponseParser::ParsePlaces(Result.GetContentView(), OutResponse.Places, OutResponse.ErrorMessage))
         {
             OutResponse.Status = ERadioGardenStatus::ParseError;
-            OutResponse.ErrorMessage = TEXT("Invalid response format");
             return;
         }
+
+        OutResponse.Status = ERadioGardenStatus::Success;
+        OutResponse.bSuccessful = true;
     }
 
-    // Парсим места
-    for (const TSharedPtr<FJsonValue>& PlaceValue : *PlacesArray)
+    void ParsePlaceDetails(const FRadioGardenHttpResult& Result, FRadioGardenPlacesResponse& OutResponse)
     {
-        const TSharedPtr<FJsonObject>& PlaceObj = PlaceValue->AsObject();
-        if (!PlaceObj.IsValid())
+        if (!CheckHttpResult(Result, OutResponse))
+        {
+            return;
+        }
+
+        TSharedPtr<FJsonObject> JsonObject;
+        if (!FRadioGardenHttpRequest::ParseJson(Result.GetContentView(), JsonObject))
         {
-            continue;
+            OutResponse.Status = ERadioGardenStatus::ParseError;
+            OutResponse.ErrorMessage = TEXT("Failed to parse JSON");
+            return;
         }
 
-        FRadioGardenPlace Place;
-        Place.Id = FRadioGardenHttpRequest::GetStringSafe(PlaceObj, TEXT("id"));
-        Place.Title = FRadioGardenHttpRequest::GetStringSafe(PlaceObj, TEXT("title"));
-        Place.Country = FRadioGardenHttpRequest::GetStringSafe(PlaceObj, TEXT("country"));
-        Place.Url = FRadioGardenHttpRequest::GetStringSafe(PlaceObj, TEXT("url"));
-        Place.Size = static_cast<int32>(FRadioGardenHttpRequest::GetNumberSafe(PlaceObj, TEXT("size")));
-        Place.bBoost = FRadioGardenHttpRequest::GetBoolSafe(PlaceObj, TEXT("boost"));
+        // В реальной реализации здесь нужно парсить детальную информацию о месте
+        // Для упрощения возвращаем базовый ответ
+        OutResponse.Status = ERadioGardenStatus::Success;
+        OutResponse.bSuccessful = true;
+    }
+
+    void ParsePlaceChannels(const FRadioGardenHttpResult& Result, FRadioGardenChannelsResponse& OutResponse)
+    {
+        if (!CheckHttpResult(Result, OutResponse))
+        {
+            return;
+        }
 
-        // Парсим координаты
-        const TArray<TSharedPtr<FJsonValue>>* GeoArray;
-        if (PlaceObj->TryGetArrayField(TEXT("geo"), GeoArray) && GeoArray->Num() >= 2)
+        if (!FRadioGardenResponseParser::ParsePlaceChannels(Result.GetContentView(), OutResponse.Channels, OutResponse.ErrorMessage))
         {
-            Place.Geo.Longitude = (*GeoArray)[0]->AsNumber();
-            Place.Geo.Latitude = (*GeoArray)[1]->AsNumber();
+            OutResponse.Status = ERadioGardenStatus::ParseError;
+            return;
         }
 
-        OutResponse.Places.Add(Place);
+        OutResponse.Status = ERadioGardenStatus::Success;
+        OutResponse.bSuccessful = true;
     }
 
-    OutResponse.Status = ERadioGardenStatus::Success;
-    OutResponse.bSuccessful = true;
-}
+    FString MakePlaceChannelsEndpoint(const FString& PlaceId)
+    {
+        return FString::Printf(TEXT("/ara/content/page/%s/channels"), *PlaceId);
+    }
 
-void IRadioGardenAPI::GetPlacesAsync(const FOnRadioGardenPlacesReceived& OnCompleted)
-{
-    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [OnCompleted]()
+    TCoalescedEndpoint<FRadioGardenPlacesResponse> PlacesRequests;
+    TCoalescedEndpoint<FRadioGardenPlacesResponse> PlaceDetailsRequests;
+    TCoalescedEndpoint<FRadioGardenChannelsResponse> PlaceChannelsRequests;
+
+    void FetchPlacesFromNetwork(ERadioGardenRequestPriority Priority, const FRadioGardenCancellationPtr& Cancellation,
+        TRadioGardenSingleFlight<FRadioGardenPlacesResponse>::FWaiter&& OnParsed)
     {
-        FRadioGardenPlacesResponse Response;
-        GetPlaces(Response);
+        ExecuteCoalesced<FRadioGardenPlacesResponse>(PlacesRequests, PlacesEndpoint, &ParsePlaces, MoveTemp(OnParsed), Priority, Cancellation);
+    }
+
+    // Обновить каталог мест в фоне, если он устарел
+    void RefreshPlacesCatalog()
+    {
+        if (FRadioGardenPlacesCatalog::Get().TryBeginRefresh())
+        {
+            FetchPlacesFromNetwork(ERadioGardenRequestPriority::Background, nullptr, [](const FRadioGardenPlacesCatalog::FPlacesRef& Places)
+            {
+                FRadioGardenPlacesCatalog::Get().FinishRefresh(Places);
+            });
+        }
+    }
+
+    // Получить список мест: загруженный каталог (в том числе снимок с диска) отдаётся сразу
+    // и обновляется в фоне, без каталога места запрашиваются из сети.
+    // Продолжение вызывается в фоновом потоке, в том числе после отмены Cancellation
+    void FetchPlaces(const FRadioGardenCancellationPtr& Cancellation, TRadioGardenSingleFlight<FRadioGardenPlacesResponse>::FWaiter&& OnParsed)
+    {
+        AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Cancellation, OnParsed = MoveTemp(OnParsed)]() mutable
+        {
+            if (const FRadioGardenPlacesCatalog::FPlacesPtr Places = FRadioGardenPlacesCatalog::Get().GetPlaces())
+            {
+                RefreshPlacesCatalog();
+                OnParsed(Places.ToSharedRef());
+                return;
+            }
+
+            FetchPlacesFromNetwork(ERadioGardenRequestPriority::Normal, Cancellation, [OnParsed = MoveTemp(OnParsed)](const FRadioGardenPlacesCatalog::FPlacesRef& Places)
+            {
+                if (Places->bSuccessful)
+                {
+                    FRadioGardenPlacesCatalog::Get().Update(Places);
+                }
+                OnParsed(Places);
+            });
+        });
+    }
+
+    void ExecutePlaceChannels(const FString& PlaceId, ERadioGardenRequestPriority Priority, const FRadioGardenCancellationPtr& Cancellation,
+        TRadioGardenSingleFlight<FRadioGardenChannelsResponse>::FWaiter&& OnParsed)
+    {
+        ExecuteCoalesced<FRadioGardenChannelsResponse>(PlaceChannelsRequests, MakePlaceChannelsEndpoint(PlaceId),
+            [PlaceId](const FRadioGardenHttpResult& Result, FRadioGardenChannelsResponse& OutResponse)
+            {
+                OutResponse.PlaceId = PlaceId;
+                ParsePlaceChannels(Result, OutResponse);
+            },
+            MoveTemp(OnParsed), Priority, Cancellation);
+    }
 
-        AsyncTask(ENamedThreads::GameThread, [Response, OnCompleted]()
+    // Обычный запрос станций места: упреждение на это время уступает ему сеть.
+    // Продолжение вызывается и после отмены, поэтому упреждение не остаётся приостановленным
+    void FetchPlaceChannels(const FString& PlaceId, ERadioGardenRequestPriority Priority, const FRadioGardenCancellationPtr& Cancellation,
+        TRadioGardenSingleFlight<FRadioGardenChannelsResponse>::FWaiter&& OnParsed)
+    {
+        FRadioGardenPrefetcher::Get().BeginForegroundRequest(PlaceId);
+        ExecutePlaceChannels(PlaceId, Priority, Cancellation, [OnParsed = MoveTemp(OnParsed)](const TSharedRef<const FRadioGardenChannelsResponse, ESPMode::ThreadSafe>& Response)
         {
-            OnCompleted.ExecuteIfBound(Response);
+            FRadioGardenPrefetcher::Get().EndForegroundRequest();
+            OnParsed(Response);
         });
-    });
+    }
 }
 
-void IRadioGardenAPI::GetPlaceDetails(const FString& PlaceId, FRadioGardenPlacesResponse& OutResponse)
+void IRadioGardenAPI::GetPlaces(FRadioGardenPlacesResponse& OutResponse)
 {
     OutResponse = FRadioGardenPlacesResponse();
 
-    if (!IsValidId(PlaceId))
+    if (const FRadioGardenPlacesCatalog::FPlacesPtr Places = FRadioGardenPlacesCatalog::Get().GetPlaces())
     {
-        OutResponse.Status = ERadioGardenStatus::InvalidResponse;
-        OutResponse.ErrorMessage = TEXT("Invalid Place ID");
+        RefreshPlacesCatalog();
+        OutResponse = *Places;
         return;
     }
 
-    const FString Endpoint = FString::Printf(TEXT("/ara/content/page/%s"), *PlaceId);
-    FString ResponseContent;
-    FString ErrorMessage;
+    FRadioGardenHttpResult Result;
+    FRadioGardenHttpRequest::ExecuteGet(PlacesEndpoint, Result);
+    ParsePlaces(Result, OutResponse);
 
-    if (!FRadioGardenHttpRequest::ExecuteGet(Endpoint, ResponseContent, ErrorMessage))
+    if (OutResponse.bSuccessful)
     {
-        OutResponse.Status = ERadioGardenStatus::NetworkError;
-        OutResponse.ErrorMessage = ErrorMessage;
-        return;
+        FRadioGardenPlacesCatalog::Get().Update(MakeShared<const FRadioGardenPlacesResponse, ESPMode::ThreadSafe>(OutResponse));
     }
+}
+
+FRadioGardenRequestHandle IRadioGardenAPI::GetPlacesAsync(const FOnRadioGardenPlacesReceived& OnCompleted)
+{
+    FRadioGardenRequestHandle Handle;
+    const FRadioGardenCancellationRef Cancellation = BeginCancellableRequest(Handle);
+
+    FetchPlaces(Cancellation, [OnCompleted, Cancellation](const TSharedRef<const FRadioGardenPlacesResponse, ESPMode::ThreadSafe>& Response)
+    {
+        DispatchSharedToGameThread(OnCompleted, Response, Cancellation);
+    });
+    return Handle;
+}
+
+void IRadioGardenAPI::GetPlaceDetails(const FString& PlaceId, FRadioGardenPlacesResponse& OutResponse)
+{
+    OutResponse = FRadioGardenPlacesResponse();
 
-    TSharedPtr<FJsonObject> JsonObject;
-    if (!FRadioGardenHttpRequest::ParseJson(ResponseContent, JsonObject))
+    if (!IsValidId(PlaceId))
     {
-        OutResponse.Status = ERadioGardenStatus::ParseError;
-        OutResponse.ErrorMessage = TEXT("Failed to parse JSON");
+        OutResponse.Status = ERadioGardenStatus::InvalidResponse;
+        OutResponse.ErrorMessage = TEXT("Invalid Place ID");
         return;
     }
 
-    // В реальной реализации здесь нужно парсить детальную информацию о месте
-    // Для упрощения возвращаем базовый ответ
-    OutResponse.Status = ERadioGardenStatus::Success;
-    OutResponse.bSuccessful = true;
+    const FString Endpoint = FString::Printf(TEXT("/ara/content/page/%s"), *PlaceId);
+
+    FRadioGardenHttpResult Result;
+    FRadioGardenHttpRequest::ExecuteGet(Endpoint, Result);
+    ParsePlaceDetails(Result, OutResponse);
 }
 
-void IRadioGardenAPI::GetPlaceDetailsAsync(const FString& PlaceId, const FOnRadioGardenPlacesReceived& OnCompleted)
+FRadioGardenRequestHandle IRadioGardenAPI::GetPlaceDetailsAsync(const FString& PlaceId, const FOnRadioGardenPlacesReceived& OnCompleted)
 {
-    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [PlaceId, OnCompleted]()
+    FRadioGardenRequestHandle Handle;
+    const FRadioGardenCancellationRef Cancellation = BeginCancellableRequest(Handle);
+
+    if (!IsValidId(PlaceId))
     {
         FRadioGardenPlacesResponse Response;
-        GetPlaceDetails(PlaceId, Response);
+        Response.Status = ERadioGardenStatus::InvalidResponse;
+        Response.ErrorMessage = TEXT("Invalid Place ID");
+        DispatchToGameThread(OnCompleted, MoveTemp(Response), Cancellation);
+        return Handle;
+    }
+
+    const FString Endpoint = FString::Printf(TEXT("/ara/content/page/%s"), *PlaceId);
 
-        AsyncTask(ENamedThreads::GameThread, [Response, OnCompleted]()
+    ExecuteCoalesced<FRadioGardenPlacesResponse>(PlaceDetailsRequests, Endpoint, &ParsePlaceDetails,
+        [OnCompleted, Cancellation](const TSharedRef<const FRadioGardenPlacesResponse, ESPMode::ThreadSafe>& Response)
         {
-            OnCompleted.ExecuteIfBound(Response);
-        });
-    });
+            DispatchSharedToGameThread(OnCompleted, Response, Cancellation);
+        },
+        ERadioGardenRequestPriority::Interactive, Cancellation);
+    return Handle;
 }
 
 void IRadioGardenAPI::GetPlaceChannels(const FString& PlaceId, FRadioGardenChannelsResponse& OutResponse)
@@ -162,562 +446,1798 @@ void IRadioGardenAPI::GetPlaceChannels(const FString& PlaceId, FRadioGardenChann
         return;
     }
 
-    const FString Endpoint = FString::Printf(TEXT("/ara/content/page/%s/channels"), *PlaceId);
-    FString ResponseContent;
-    FString ErrorMessage;
+    FRadioGardenPrefetcher::Get().BeginForegroundRequest(PlaceId);
+
+    FRadioGardenHttpResult Result;
+    FRadioGardenHttpRequest::ExecuteGet(MakePlaceChannelsEndpoint(PlaceId), Result);
+    ParsePlaceChannels(Result, OutResponse);
 
-    if (!FRadioGardenHttpRequest::ExecuteGet(Endpoint, ResponseContent, ErrorMessage))
+    FRadioGardenPrefetcher::Get().EndForegroundRequest();
+}
+
+FRadioGardenRequestHandle IRadioGardenAPI::GetPlaceChannelsAsync(const FString& PlaceId, const FOnRadioGardenChannelsReceived& OnCompleted)
+{
+    FRadioGardenRequestHandle Handle;
+    const FRadioGardenCancellationRef Cancellation = BeginCancellableRequest(Handle);
+
+    if (!IsValidId(PlaceId))
     {
-        OutResponse.Status = ERadioGardenStatus::NetworkError;
-        OutResponse.ErrorMessage = ErrorMessage;
-        return;
+        FRadioGardenChannelsResponse Response;
+        Response.PlaceId = PlaceId;
+        Response.Status = ERadioGardenStatus::InvalidResponse;
+        Response.ErrorMessage = TEXT("Invalid Place ID");
+        DispatchToGameThread(OnCompleted, MoveTemp(Response), Cancellation);
+        return Handle;
     }
 
-    TSharedPtr<FJsonObject> JsonObject;
-    if (!FRadioGardenHttpRequest::ParseJson(ResponseContent, JsonObject))
+    FetchPlaceChannels(PlaceId, ERadioGardenRequestPriority::Interactive, Cancellation,
+        [OnCompleted, Cancellation](const TSharedRef<const FRadioGardenChannelsResponse, ESPMode::ThreadSafe>& Response)
+        {
+            DispatchSharedToGameThread(OnCompleted, Response, Cancellation);
+        });
+    return Handle;
+}
+
+// ========== Channels (Станции) ==========
+
+namespace
+{
+    void ParseChannel(const FRadioGardenHttpResult& Result, FRadioGardenChannelResponse& OutResponse)
     {
-        OutResponse.Status = ERadioGardenStatus::ParseError;
-        OutResponse.ErrorMessage = TEXT("Failed to parse JSON");
-        return;
+        if (!CheckHttpResult(Result, OutResponse))
+        {
+            return;
+        }
+
+        if (!FRadioGardenResponseParser::ParseChannel(Result.GetContentView(), OutResponse.Channel, OutResponse.ErrorMessage))
+        {
+            OutResponse.Status = ERadioGardenStatus::ParseError;
+            return;
+        }
+
+        OutResponse.Status = ERadioGardenStatus::Success;
+        OutResponse.bSuccessful = true;
     }
 
-    // Получаем массив каналов
-    TSharedPtr<FJsonObject> DataObj;
-    if (!FRadioGardenHttpRequest::GetObjectSafe(JsonObject, TEXT("data"), DataObj))
+    TCoalescedEndpoint<FRadioGardenChannelResponse> ChannelRequests;
+}
+
+void IRadioGardenAPI::GetChannel(const FString& ChannelId, FRadioGardenChannelResponse& OutResponse)
+{
+    OutResponse = FRadioGardenChannelResponse();
+
+    if (!IsValidId(ChannelId))
     {
-        OutResponse.Status = ERadioGardenStatus::ParseError;
-        OutResponse.ErrorMessage = TEXT("Invalid response format");
+        OutResponse.Status = ERadioGardenStatus::InvalidResponse;
+        OutResponse.ErrorMessage = TEXT("Invalid Channel ID");
         return;
     }
 
-    const TArray<TSharedPtr<FJsonValue>>* ContentArray;
-    if (!FRadioGardenHttpRequest::GetArraySafe(DataObj, TEXT("content"), ContentArray) || ContentArray->Num() == 0)
+    const FString Endpoint = FString::Printf(TEXT("/ara/content/channel/%s"), *ChannelId);
+
+    FRadioGardenHttpResult Result;
+    FRadioGardenHttpRequest::ExecuteGet(Endpoint, Result);
+    ParseChannel(Result, OutResponse);
+}
+
+FRadioGardenRequestHandle IRadioGardenAPI::GetChannelAsync(const FString& ChannelId, const FOnRadioGardenChannelReceived& OnCompleted)
+{
+    FRadioGardenRequestHandle Handle;
+    const FRadioGardenCancellationRef Cancellation = BeginCancellableRequest(Handle);
+
+    if (!IsValidId(ChannelId))
     {
-        OutResponse.Status = ERadioGardenStatus::ParseError;
-        OutResponse.ErrorMessage = TEXT("No channels found");
-        return;
+        FRadioGardenChannelResponse Response;
+        Response.Status = ERadioGardenStatus::InvalidResponse;
+        Response.ErrorMessage = TEXT("Invalid Channel ID");
+        DispatchToGameThread(OnCompleted, MoveTemp(Response), Cancellation);
+        return Handle;
     }
 
-    // Получаем массив из первого элемента content
-    const TSharedPtr<FJsonObject>& ContentItemObj = (*ContentArray)[0]->AsObject();
-    if (!ContentItemObj.IsValid())
+    const FString Endpoint = FString::Printf(TEXT("/ara/content/channel/%s"), *ChannelId);
+
+    ExecuteCoalesced<FRadioGardenChannelResponse>(ChannelRequests, Endpoint, &ParseChannel,
+        [OnCompleted, Cancellation](const TSharedRef<const FRadioGardenChannelResponse, ESPMode::ThreadSafe>& Response)
+        {
+            DispatchSharedToGameThread(OnCompleted, Response, Cancellation);
+        },
+        ERadioGardenRequestPriority::Interactive, Cancellation);
+    return Handle;
+}
+
+bool IRadioGardenAPI::GetChannelStreamUrl(const FString& ChannelId, FString& OutStreamUrl, FString& OutErrorMessage)
+{
+    OutStreamUrl.Empty();
+
+    if (!IsValidId(ChannelId))
     {
-        OutResponse.Status = ERadioGardenStatus::ParseError;
-        OutResponse.ErrorMessage = TEXT("Invalid content format");
-        return;
+        OutErrorMessage = TEXT("Invalid Channel ID");
+        return false;
     }
 
-    const TArray<TSharedPtr<FJsonValue>>* ItemsArray;
-    if (!FRadioGardenHttpRequest::GetArraySafe(ContentItemObj, TEXT("items"), ItemsArray))
+    const FString Endpoint = FString::Printf(TEXT("/ara/content/listen/%s/channel.mp3"), *ChannelId);
+
+    if (!FRadioGardenHttpRequest::ExecuteGetRedirect(Endpoint, OutStreamUrl, OutErrorMessage))
     {
-        OutResponse.Status = ERadioGardenStatus::ParseError;
-        OutResponse.ErrorMessage = TEXT("Invalid items format");
-        return;
+        return false;
     }
 
-    // Парсим каналы
-    for (const TSharedPtr<FJsonValue>& ItemValue : *ItemsArray)
+    return !OutStreamUrl.IsEmpty();
+}
+
+FRadioGardenRequestHandle IRadioGardenAPI::GetChannelStreamUrlAsync(const FString& ChannelId, const FOnRadioGardenStreamUrlReceived& OnCompleted)
+{
+    FRadioGardenRequestHandle Handle;
+    const FRadioGardenCancellationRef Cancellation = BeginCancellableRequest(Handle);
+
+    if (!IsValidId(ChannelId))
     {
-        const TSharedPtr<FJsonObject>& ChannelObj = ItemValue->AsObject();
-        if (!ChannelObj.IsValid())
+        AsyncTask(ENamedThreads::GameThread, [OnCompleted, Cancellation]()
         {
-            continue;
-        }
+            if (!Cancellation->IsCancelled())
+            {
+                OnCompleted.ExecuteIfBound(false, FString());
+            }
+        });
+        return Handle;
+    }
 
-        FRadioGardenChannel Channel;
+    const FString Endpoint = FString::Printf(TEXT("/ara/content/listen/%s/channel.mp3"), *ChannelId);
 
-        // Структура: { page: { url: "/listen/station-name/ChannelId", title: "...", ... } }
-        TSharedPtr<FJsonObject> PageObj;
-        if (!FRadioGardenHttpRequest::GetObjectSafe(ChannelObj, TEXT("page"), PageObj))
+    FRadioGardenHttpRequest::ExecuteGetRedirectAsync(Endpoint, [OnCompleted, Cancellation](bool bSuccess, const FString& StreamUrl, const FString& ErrorMessage)
+    {
+        if (Cancellation->IsCancelled())
         {
-            continue;
+            return;
         }
 
-        Channel.Title = FRadioGardenHttpRequest::GetStringSafe(PageObj, TEXT("title"));
-        FString PageUrl = FRadioGardenHttpRequest::GetStringSafe(PageObj, TEXT("url"));
-        Channel.Url = PageUrl;
+        const bool bHasUrl = bSuccess && !StreamUrl.IsEmpty();
 
-        // Парсим ID из URL (формат: /listen/station-name/ChannelId)
-        if (!PageUrl.IsEmpty())
+        AsyncTask(ENamedThreads::GameThread, [bHasUrl, StreamUrl, OnCompleted, Cancellation]()
         {
-            TArray<FString> Parts;
-            PageUrl.ParseIntoArray(Parts, TEXT("/"), true);
-            if (Parts.Num() >= 2)
+            if (!Cancellation->IsCancelled())
             {
-                Channel.Id = Parts[Parts.Num() - 1];
+                OnCompleted.ExecuteIfBound(bHasUrl, StreamUrl);
             }
+        });
+    }, ERadioGardenRequestPriority::Interactive, Cancellation);
+    return Handle;
+}
+
+// ========== Search (Поиск) ==========
+
+namespace
+{
+    void ParseSearch(const FRadioGardenHttpResult& Result, FRadioGardenSearchResponse& OutResponse)
+    {
+        if (!CheckHttpResult(Result, OutResponse))
+        {
+            return;
+        }
+
+        if (!FRadioGardenResponseParser::ParseSearch(Result.GetContentView(), OutResponse.TimeTaken, OutResponse.Results, OutResponse.ErrorMessage))
+        {
+            OutResponse.Status = ERadioGardenStatus::ParseError;
+            return;
+        }
+
+        OutResponse.Status = ERadioGardenStatus::Success;
+        OutResponse.bSuccessful = true;
+    }
+
+    FString MakeSearchEndpoint(const FString& Query)
+    {
+        const FString EncodedQuery = Query.Replace(TEXT(" "), TEXT("+")).Replace(TEXT("%20"), TEXT("+"));
+        return FString::Printf(TEXT("/search?q=%s"), *EncodedQuery);
+    }
+
+    TCoalescedEndpoint<FRadioGardenSearchResponse> SearchRequests;
+}
+
+void IRadioGardenAPI::Search(const FString& Query, FRadioGardenSearchResponse& OutResponse)
+{
+    OutResponse = FRadioGardenSearchResponse();
+    OutResponse.Query = Query;
+
+    if (Query.IsEmpty())
+    {
+        OutResponse.Status = ERadioGardenStatus::InvalidResponse;
+        OutResponse.ErrorMessage = TEXT("Empty search query");
+        return;
+    }
+
+    FRadioGardenHttpResult Result;
+    FRadioGardenHttpRequest::ExecuteGet(MakeSearchEndpoint(Query), Result);
+    ParseSearch(Result, OutResponse);
+}
+
+FRadioGardenRequestHandle IRadioGardenAPI::SearchAsync(const FString& Query, const FOnRadioGardenSearchCompleted& OnCompleted)
+{
+    FRadioGardenRequestHandle Handle;
+    const FRadioGardenCancellationRef Cancellation = BeginCancellableRequest(Handle);
+
+    if (Query.IsEmpty())
+    {
+        FRadioGardenSearchResponse Response;
+        Response.Query = Query;
+        Response.Status = ERadioGardenStatus::InvalidResponse;
+        Response.ErrorMessage = TEXT("Empty search query");
+        DispatchToGameThread(OnCompleted, MoveTemp(Response), Cancellation);
+        return Handle;
+    }
+
+    // Разные запросы могут дать один эндпоинт ("a b" и "a+b"), поэтому Query проставляется каждому вызывающему
+    ExecuteCoalesced<FRadioGardenSearchResponse>(SearchRequests, MakeSearchEndpoint(Query), &ParseSearch,
+        [Query, OnCompleted, Cancellation](const TSharedRef<const FRadioGardenSearchResponse, ESPMode::ThreadSafe>& SharedResponse)
+        {
+            if (Cancellation->IsCancelled())
+            {
+                return;
+            }
+
+            FRadioGardenSearchResponse Response = *SharedResponse;
+            Response.Query = Query;
+            DispatchToGameThread(OnCompleted, MoveTemp(Response), Cancellation);
+        },
+        ERadioGardenRequestPriority::Interactive, Cancellation);
+    return Handle;
+}
+
+// ========== Geo (Геолокация) ==========
+
+namespace
+{
+    const TCHAR* GeoEndpoint = TEXT("/geo");
+
+    void ParseGeolocation(const FRadioGardenHttpResult& Result, FRadioGardenGeolocationResponse& OutResponse)
+    {
+        if (!CheckHttpResult(Result, OutResponse))
+        {
+            return;
+        }
+
+        if (!FRadioGardenResponseParser::ParseGeolocation(Result.GetContentView(), OutResponse.Geolocation, OutResponse.ErrorMessage))
+        {
+            OutResponse.Status = ERadioGardenStatus::ParseError;
+            return;
+        }
+
+        OutResponse.Status = ERadioGardenStatus::Success;
+        OutResponse.bSuccessful = true;
+    }
+
+    TCoalescedEndpoint<FRadioGardenGeolocationResponse> GeolocationRequests;
+
+    using FGeolocationResultRef = TSharedRef<const FRadioGardenGeolocationResponse, ESPMode::ThreadSafe>;
+
+    void FetchGeolocation(ERadioGardenRequestPriority Priority, const FRadioGardenCancellationPtr& Cancellation,
+        TRadioGardenSingleFlight<FRadioGardenGeolocationResponse>::FWaiter&& OnParsed)
+    {
+        ExecuteCoalesced<FRadioGardenGeolocationResponse>(GeolocationRequests, GeoEndpoint, &ParseGeolocation, MoveTemp(OnParsed), Priority, Cancellation);
+    }
+
+    // Геолокация клиента на время сессии: последний успешный ответ
+    struct FSessionGeolocation
+    {
+        FCriticalSection CriticalSection;
+        TSharedPtr<const FRadioGardenGeolocationResponse, ESPMode::ThreadSafe> Response;
+        double UpdatedTime = 0.0;
+        bool bRefreshInFlight = false;
+    };
+
+    FSessionGeolocation SessionGeolocation;
+
+    void StoreSessionGeolocation(const FGeolocationResultRef& Response)
+    {
+        if (!Response->bSuccessful)
+        {
+            return;
+        }
+
+        FScopeLock Lock(&SessionGeolocation.CriticalSection);
+        SessionGeolocation.Response = Response;
+        SessionGeolocation.UpdatedTime = FPlatformTime::Seconds();
+    }
+
+    // Геолокация сессии: сеть нужна только первому вызову, устаревшая геолокация отдаётся сразу и обновляется в фоне
+    void FetchSessionGeolocation(const FRadioGardenCancellationPtr& Cancellation, TRadioGardenSingleFlight<FRadioGardenGeolocationResponse>::FWaiter&& OnParsed)
+    {
+        TSharedPtr<const FRadioGardenGeolocationResponse, ESPMode::ThreadSafe> Cached;
+        bool bRefresh = false;
+        {
+            FScopeLock Lock(&SessionGeolocation.CriticalSection);
+            Cached = SessionGeolocation.Response;
+
+            const float RefreshSeconds = CVarRadioGardenGeolocationRefreshSeconds.GetValueOnAnyThread();
+            if (Cached.IsValid() && RefreshSeconds > 0.0f && !SessionGeolocation.bRefreshInFlight
+                && FPlatformTime::Seconds() - SessionGeolocation.UpdatedTime >= RefreshSeconds)
+            {
+                SessionGeolocation.bRefreshInFlight = true;
+                bRefresh = true;
+            }
+        }
+
+        if (bRefresh)
+        {
+            FetchGeolocation(ERadioGardenRequestPriority::Background, nullptr, [](const FGeolocationResultRef& Response)
+            {
+                StoreSessionGeolocation(Response);
+
+                FScopeLock Lock(&SessionGeolocation.CriticalSection);
+                SessionGeolocation.bRefreshInFlight = false;
+            });
+        }
+
+        if (Cached.IsValid())
+        {
+            OnParsed(Cached.ToSharedRef());
+            return;
+        }
+
+        FetchGeolocation(ERadioGardenRequestPriority::Normal, Cancellation, [OnParsed = MoveTemp(OnParsed)](const FGeolocationResultRef& Response)
+        {
+            StoreSessionGeolocation(Response);
+            OnParsed(Response);
+        });
+    }
+}
+
+void IRadioGardenAPI::GetGeolocation(FRadioGardenGeolocationResponse& OutResponse)
+{
+    OutResponse = FRadioGardenGeolocationResponse();
+
+    FRadioGardenHttpResult Result;
+    FRadioGardenHttpRequest::ExecuteGet(GeoEndpoint, Result);
+    ParseGeolocation(Result, OutResponse);
+
+    if (OutResponse.bSuccessful)
+    {
+        StoreSessionGeolocation(MakeShared<const FRadioGardenGeolocationResponse, ESPMode::ThreadSafe>(OutResponse));
+    }
+}
+
+FRadioGardenRequestHandle IRadioGardenAPI::GetGeolocationAsync(const FOnRadioGardenGeolocationReceived& OnCompleted)
+{
+    FRadioGardenRequestHandle Handle;
+    const FRadioGardenCancellationRef Cancellation = BeginCancellableRequest(Handle);
+
+    FetchGeolocation(ERadioGardenRequestPriority::Interactive, Cancellation, [OnCompleted, Cancellation](const FGeolocationResultRef& Response)
+    {
+        StoreSessionGeolocation(Response);
+        DispatchSharedToGameThread(OnCompleted, Response, Cancellation);
+    });
+    return Handle;
+}
+
+void IRadioGardenAPI::ForgetSessionGeolocation()
+{
+    FScopeLock Lock(&SessionGeolocation.CriticalSection);
+    SessionGeolocation.Response.Reset();
+    SessionGeolocation.UpdatedTime = 0.0;
+}
+
+// ========== Nearby Channels ==========
+
+namespace
+{
+    // Место, станции которого запрошены конвейером поиска ближайших станций
+    struct FNearbyPlaceSlot
+    {
+        int32 PlaceIndex = INDEX_NONE;
+        double Distance = 0.0;
+
+        // Ожидаемое число станций (размер места из каталога)
+        int32 PredictedChannels = 0;
+
+        bool bDone = false;
+        TSharedPtr<const FRadioGardenChannelsResponse, ESPMode::ThreadSafe> Response;
+
+        int32 GetChannelsCount() const
+        {
+            return Response.IsValid() && Response->bSuccessful ? Response->Channels.Num() : 0;
+        }
+    };
+
+    using FChannelsResultRef = TRadioGardenSingleFlight<FRadioGardenChannelsResponse>::FResultRef;
+    using FChannelsWaiter = TRadioGardenSingleFlight<FRadioGardenChannelsResponse>::FWaiter;
+
+    // Ответы мест, общие для пакета запросов ближайших станций: станции каждого места
+    // запрашиваются один раз, полученный ответ отдаётся остальным запросам пакета без повторного разбора
+    struct FNearbySharedPlaces
+    {
+        struct FEntry
+        {
+            TSharedPtr<const FRadioGardenChannelsResponse, ESPMode::ThreadSafe> Response;
+            TArray<FChannelsWaiter> Waiters;
+        };
+
+        FCriticalSection CriticalSection;
+        TMap<int32, FEntry> Entries;
+
+        // Токен пакета: запросы мест отменяются вместе с пакетом, а не с отдельным его запросом
+        FRadioGardenCancellationPtr Cancellation;
+    };
+
+    using FNearbySharedPlacesRef = TSharedRef<FNearbySharedPlaces, ESPMode::ThreadSafe>;
+
+    void FetchSharedPlaceChannels(const FNearbySharedPlacesRef& Shared, const FRadioGardenPlace& Place, int32 PlaceIndex, FChannelsWaiter&& OnParsed)
+    {
+        TSharedPtr<const FRadioGardenChannelsResponse, ESPMode::ThreadSafe> Resolved;
+        {
+            FScopeLock Lock(&Shared->CriticalSection);
+
+            if (FNearbySharedPlaces::FEntry* Entry = Shared->Entries.Find(PlaceIndex))
+            {
+                if (!Entry->Response.IsValid())
+                {
+                    Entry->Waiters.Add(MoveTemp(OnParsed));
+                    FRadioGardenStats::CoalescedRequests.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                Resolved = Entry->Response;
+            }
+            else
+            {
+                Shared->Entries.Add(PlaceIndex).Waiters.Add(MoveTemp(OnParsed));
+            }
+        }
+
+        if (Resolved.IsValid())
+        {
+            OnParsed(Resolved.ToSharedRef());
+            return;
+        }
+
+        FetchPlaceChannels(Place.Id, ERadioGardenRequestPriority::Normal, Shared->Cancellation, [Shared, PlaceIndex](const FChannelsResultRef& Response)
+        {
+            TArray<FChannelsWaiter> Waiters;
+            {
+                FScopeLock Lock(&Shared->CriticalSection);
+                FNearbySharedPlaces::FEntry& Entry = Shared->Entries.FindChecked(PlaceIndex);
+                Entry.Response = Response;
+                Waiters = MoveTemp(Entry.Waiters);
+            }
+
+            for (FChannelsWaiter& Waiter : Waiters)
+            {
+                Waiter(Response);
+            }
+        });
+    }
+
+    // Состояние конвейера поиска ближайших станций.
+    // Каждый шаг запускается из продолжения предыдущего запроса, поток на время сетевого ожидания не занимается.
+    // Станции мест запрашиваются параллельно (не больше MaxConcurrentRequests), слоты идут по возрастанию расстояния
+    struct FNearbyChannelsState
+    {
+        double Latitude = 0.0;
+        double Longitude = 0.0;
+        int32 ChannelsCount = 0;
+        int32 MaxConcurrentRequests = 1;
+        FOnRadioGardenNearbyChannelsBatch OnBatch;
+
+        // Продолжение с итоговым ответом (вызывается в фоновом потоке)
+        TFunction<void(FRadioGardenNearbyChannelsResponse&&)> OnCompleted;
+
+        // Токен вызывающего: после его отмены порции и итоговый ответ не доставляются
+        FRadioGardenCancellationPtr Cancellation;
+
+        // Токен запросов конвейера: отменяется вместе с вызовом, а также по завершении поиска или дедлайну,
+        // чтобы ненужные уже запросы мест не занимали сеть
+        FRadioGardenCancellationPtr FetchCancellation;
+
+        // Общие ответы мест пакета запросов (nullptr для одиночного запроса)
+        TSharedPtr<FNearbySharedPlaces, ESPMode::ThreadSafe> SharedPlaces;
+
+        FRadioGardenPlacesCatalog::FPlacesPtr Places;
+        FRadioGardenPlacesIndex::FNearestIterator NearestPlaces;
+
+        // Места области, уже упорядоченные по расстоянию; NextAreaPlace == INDEX_NONE - обход по удалённости
+        TArray<FRadioGardenPlacesIndex::FNearestPlace> AreaPlaces;
+        int32 NextAreaPlace = INDEX_NONE;
+
+        FCriticalSection CriticalSection;
+        TArray<FNearbyPlaceSlot> Slots;
+        int32 InFlight = 0;
+        int32 PredictedInFlight = 0;
+        int32 CompletedChannels = 0;
+
+        // Слоты [0, DonePrefix) завершены, в них PrefixChannels станций
+        int32 DonePrefix = 0;
+        int32 PrefixChannels = 0;
+
+        // Сколько каналов уже выдано порциями
+        int32 DeliveredChannels = 0;
+
+        bool bPlacesExhausted = false;
+        bool bFinished = false;
+
+        // Ключ кэша результатов (пустой - результат не кэшируется) и версия каталога, из которого взяты места
+        // (0 - места не из текущего каталога, результат не кэшируется)
+        FString ResultCacheKey;
+        uint64 ResultCacheVersion = 0;
+
+        // Таймер дедлайна (недействителен, если дедлайн не задан или уже снят)
+        FTSTicker::FDelegateHandle DeadlineHandle;
+    };
+
+    using FNearbyChannelsStateRef = TSharedRef<FNearbyChannelsState, ESPMode::ThreadSafe>;
+
+    // Снять таймер дедлайна, если он ещё стоит
+    void ClearNearbyDeadline(FNearbyChannelsState& State)
+    {
+        FTSTicker::FDelegateHandle DeadlineHandle;
+        {
+            FScopeLock Lock(&State.CriticalSection);
+            DeadlineHandle = State.DeadlineHandle;
+            State.DeadlineHandle.Reset();
+        }
+
+        if (DeadlineHandle.IsValid())
+        {
+            FTSTicker::GetCoreTicker().RemoveTicker(DeadlineHandle);
+        }
+    }
+
+    // Поиск завершён: снять дедлайн и отменить ещё не выполненные запросы конвейера
+    void EndNearbyRequests(FNearbyChannelsState& State)
+    {
+        ClearNearbyDeadline(State);
+        State.FetchCancellation->Cancel();
+    }
+
+    void FailNearby(const FNearbyChannelsStateRef& State, ERadioGardenStatus Status, const FString& ErrorMessage)
+    {
+        EndNearbyRequests(*State);
+
+        FRadioGardenNearbyChannelsResponse Response;
+        Response.Status = Status;
+        Response.ErrorMessage = ErrorMessage;
+        Response.bSuccessful = false;
+        State->OnCompleted(MoveTemp(Response));
+    }
+
+    // Добавить станции слотов [BeginSlot, EndSlot) с расстоянием до их мест (и, если нужно, единичные векторы мест станций)
+    void AppendNearbyChannels(const FNearbyChannelsState& State, int32 BeginSlot, int32 EndSlot, TArray<FRadioGardenChannelWithDistance>& OutChannels,
+        TArray<FVector>* OutChannelPlaces = nullptr)
+    {
+        const FString BaseUrl = IRadioGardenAPI::GetBaseUrl();
+        for (int32 SlotIndex = BeginSlot; SlotIndex < EndSlot; ++SlotIndex)
+        {
+            const FNearbyPlaceSlot& Slot = State.Slots[SlotIndex];
+            if (Slot.GetChannelsCount() == 0)
+            {
+                continue;
+            }
+
+            if (OutChannelPlaces)
+            {
+                const FRadioGardenCoords& Geo = State.Places->Places[Slot.PlaceIndex].Geo;
+                const FVector PlacePoint = FRadioGardenPlacesIndex::ToUnitVector(Geo.Latitude, Geo.Longitude);
+                for (int32 ChannelIndex = 0; ChannelIndex < Slot.GetChannelsCount(); ++ChannelIndex)
+                {
+                    OutChannelPlaces->Add(PlacePoint);
+                }
+            }
+
+            for (const FRadioGardenChannel& Channel : Slot.Response->Channels)
+            {
+                FRadioGardenChannelWithDistance& ChannelWithDist = OutChannels.AddDefaulted_GetRef();
+                ChannelWithDist.Title = Channel.Title;
+                ChannelWithDist.Distance = Slot.Distance;
+
+                // Формируем URL потока: https://radio.garden/api/ara/content/listen/ChannelId/channel.mp3
+                if (!Channel.Id.IsEmpty())
+                {
+                    ChannelWithDist.Url = FString::Printf(TEXT("%s/ara/content/listen/%s/channel.mp3"), *BaseUrl, *Channel.Id);
+                }
+            }
+        }
+    }
+
+    // Выдать порцию станций мест, только что вошедших в завершённый префикс [BeginSlot, DonePrefix).
+    // Вызывается под блокировкой, чтобы порции попадали в игровой поток в порядке расстояния
+    void EmitNearbyBatch(FNearbyChannelsState& State, int32 BeginSlot)
+    {
+        if (!State.OnBatch.IsBound() || State.DeliveredChannels >= State.ChannelsCount)
+        {
+            return;
+        }
+
+        FRadioGardenNearbyChannelsBatch Batch;
+        AppendNearbyChannels(State, BeginSlot, State.DonePrefix, Batch.Channels);
+        if (Batch.Channels.Num() == 0)
+        {
+            return;
+        }
+
+        if (State.DeliveredChannels + Batch.Channels.Num() > State.ChannelsCount)
+        {
+            Batch.Channels.SetNum(State.ChannelsCount - State.DeliveredChannels);
+        }
+        State.DeliveredChannels += Batch.Channels.Num();
+
+        // Все места ближе последнего слота порции уже разрешены, дальше идут только более далёкие
+        Batch.Watermark = State.Slots[State.DonePrefix - 1].Distance;
+        DispatchToGameThread(State.OnBatch, MoveTemp(Batch), State.Cancellation);
+    }
+
+    // Кэш результатов поиска ближайших станций: станции с единичными векторами их мест,
+    // чтобы результат можно было переупорядочить для любой точки той же ячейки геохэша
+    struct FNearbyCachedResult
+    {
+        TArray<FRadioGardenChannelWithDistance> Channels;
+        TArray<FVector> ChannelPlaces;
+        double ExpiresAt = 0.0;
+    };
+
+    TRadioGardenParsedCache<FNearbyCachedResult> NearbyResults;
+
+    FString EncodeGeohash(double Latitude, double Longitude, int32 Precision)
+    {
+        static const TCHAR Alphabet[] = TEXT("0123456789bcdefghjkmnpqrstuvwxyz");
+
+        // Биты чередуются начиная с долготы, каждые 5 бит дают символ
+        double Ranges[2][2] = { { -180.0, 180.0 }, { -90.0, 90.0 } };
+        const double Coords[2] = { FMath::UnwindDegrees(Longitude), FMath::Clamp(Latitude, -90.0, 90.0) };
+
+        FString Hash;
+        Hash.Reserve(Precision);
+        for (int32 Bit = 0, Value = 0; Hash.Len() < Precision; ++Bit)
+        {
+            double* Range = Ranges[Bit % 2];
+            const double Middle = (Range[0] + Range[1]) * 0.5;
+            Value <<= 1;
+            if (Coords[Bit % 2] >= Middle)
+            {
+                Value |= 1;
+                Range[0] = Middle;
+            }
+            else
+            {
+                Range[1] = Middle;
+            }
+
+            if (Bit % 5 == 4)
+            {
+                Hash.AppendChar(Alphabet[Value]);
+                Value = 0;
+            }
+        }
+        return Hash;
+    }
+
+    // Ключ кэша результатов: ячейка геохэша точки и количество каналов; пустой, если кэш выключен
+    FString MakeNearbyResultKey(double Latitude, double Longitude, int32 ChannelsCount)
+    {
+        const int32 Precision = FMath::Min(CVarRadioGardenNearbyResultCachePrecision.GetValueOnAnyThread(), 12);
+        if (Precision <= 0 || ChannelsCount <= 0)
+        {
+            return FString();
+        }
+        return FString::Printf(TEXT("%s/%d"), *EncodeGeohash(Latitude, Longitude, Precision), ChannelsCount);
+    }
+
+    // Найти результат для ячейки и переупорядочить его по точному расстоянию до точки
+    bool FindNearbyResult(const FString& Key, double Latitude, double Longitude, FRadioGardenNearbyChannelsResponse& OutResponse)
+    {
+        if (Key.IsEmpty())
+        {
+            return false;
+        }
+
+        const TSharedPtr<const FNearbyCachedResult, ESPMode::ThreadSafe> Cached = NearbyResults.Find(Key, FRadioGardenPlacesCatalog::Get().GetVersion());
+        if (!Cached.IsValid() || Cached->ExpiresAt <= FPlatformTime::Seconds())
+        {
+            FRadioGardenStats::NearbyCacheMisses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        FRadioGardenStats::NearbyCacheHits.fetch_add(1, std::memory_order_relaxed);
+
+        const FVector Point = FRadioGardenPlacesIndex::ToUnitVector(Latitude, Longitude);
+        OutResponse.Channels = Cached->Channels;
+        for (int32 ChannelIndex = 0; ChannelIndex < OutResponse.Channels.Num(); ++ChannelIndex)
+        {
+            OutResponse.Channels[ChannelIndex].Distance = FRadioGardenPlacesIndex::ChordSquaredToDistance(FVector::DistSquared(Point, Cached->ChannelPlaces[ChannelIndex]));
+        }
+
+        // Станции одного места сохраняют исходный порядок
+        OutResponse.Channels.StableSort([](const FRadioGardenChannelWithDistance& A, const FRadioGardenChannelWithDistance& B)
+        {
+            return A.Distance < B.Distance;
+        });
+
+        OutResponse.Status = ERadioGardenStatus::Success;
+        OutResponse.bSuccessful = true;
+        return true;
+    }
+
+    // Сохранить полный результат, если каталог не сменился за время запроса
+    void AddNearbyResult(const FNearbyChannelsState& State, const TArray<FRadioGardenChannelWithDistance>& Channels, TArray<FVector>&& ChannelPlaces)
+    {
+        if (State.ResultCacheKey.IsEmpty() || State.ResultCacheVersion == 0 || FRadioGardenPlacesCatalog::Get().GetVersion() != State.ResultCacheVersion)
+        {
+            return;
+        }
+
+        const TSharedRef<FNearbyCachedResult, ESPMode::ThreadSafe> Cached = MakeShared<FNearbyCachedResult, ESPMode::ThreadSafe>();
+        Cached->Channels = Channels;
+        Cached->ChannelPlaces = MoveTemp(ChannelPlaces);
+        Cached->ExpiresAt = FPlatformTime::Seconds() + FRadioGardenResponseCache::GetTimeToLive(ERadioGardenEndpointClass::Channels);
+        NearbyResults.Add(State.ResultCacheKey, State.ResultCacheVersion, Cached);
+    }
+
+    // Шаг 4: Собираем станции первых SlotCount мест и ограничиваем количество.
+    // После дедлайна берутся все успевшие места, а незавершённые попадают в ошибки мест
+    void FinishNearby(const FNearbyChannelsStateRef& State, int32 SlotCount, bool bDeadlineExpired)
+    {
+        EndNearbyRequests(*State);
+
+        FRadioGardenNearbyChannelsResponse Response;
+        Response.bPartial = bDeadlineExpired;
+
+        TArray<FVector> ChannelPlaces;
+        const bool bCacheResult = !bDeadlineExpired && !State->ResultCacheKey.IsEmpty();
+        AppendNearbyChannels(*State, 0, SlotCount, Response.Channels, bCacheResult ? &ChannelPlaces : nullptr);
+
+        // Ошибка одного места не обрывает поиск и возвращается вместе с результатом
+        for (int32 SlotIndex = 0; SlotIndex < SlotCount; ++SlotIndex)
+        {
+            const FNearbyPlaceSlot& Slot = State->Slots[SlotIndex];
+            if (Slot.bDone && Slot.Response->bSuccessful)
+            {
+                continue;
+            }
+
+            const FRadioGardenPlace& Place = State->Places->Places[Slot.PlaceIndex];
+            FRadioGardenNearbyPlaceError& PlaceError = Response.PlaceErrors.AddDefaulted_GetRef();
+            PlaceError.PlaceId = Place.Id;
+            PlaceError.PlaceTitle = Place.Title;
+
+            if (Slot.bDone)
+            {
+                PlaceError.Status = Slot.Response->Status;
+                PlaceError.ErrorMessage = Slot.Response->ErrorMessage;
+            }
+            else
+            {
+                PlaceError.Status = ERadioGardenStatus::Timeout;
+                PlaceError.ErrorMessage = TEXT("Deadline exceeded");
+            }
+        }
+
+        if (Response.Channels.Num() == 0)
+        {
+            Response.Status = bDeadlineExpired ? ERadioGardenStatus::Timeout : ERadioGardenStatus::InvalidResponse;
+            Response.ErrorMessage = bDeadlineExpired ? TEXT("Deadline exceeded") : TEXT("No channels found");
+            Response.bSuccessful = false;
+            State->OnCompleted(MoveTemp(Response));
+            return;
+        }
+
+        // Слоты упорядочены по расстоянию, поэтому станции уже отсортированы. Берем только нужное количество
+        if (Response.Channels.Num() > State->ChannelsCount)
+        {
+            Response.Channels.SetNum(State->ChannelsCount);
+        }
+
+        // В кэш попадают только полные результаты без ошибок мест
+        if (bCacheResult && Response.PlaceErrors.Num() == 0)
+        {
+            ChannelPlaces.SetNum(Response.Channels.Num());
+            AddNearbyResult(*State, Response.Channels, MoveTemp(ChannelPlaces));
+        }
+
+        Response.Status = ERadioGardenStatus::Success;
+        Response.bSuccessful = true;
+        State->OnCompleted(MoveTemp(Response));
+    }
+
+    // Дедлайн истёк: отдаём лучший частичный результат, незавершённые запросы мест отменяются
+    void OnNearbyDeadline(const FNearbyChannelsStateRef& State)
+    {
+        int32 SlotCount = 0;
+        {
+            FScopeLock Lock(&State->CriticalSection);
+
+            if (State->bFinished)
+            {
+                return;
+            }
+
+            State->bFinished = true;
+            State->DeadlineHandle.Reset();
+            SlotCount = State->Slots.Num();
+        }
+
+        FinishNearby(State, SlotCount, true);
+    }
+
+    void StartNearbyDeadline(const FNearbyChannelsStateRef& State, float DeadlineSeconds)
+    {
+        if (DeadlineSeconds <= 0.0f)
+        {
+            return;
+        }
+
+        const TWeakPtr<FNearbyChannelsState, ESPMode::ThreadSafe> WeakState = State;
+        const FTSTicker::FDelegateHandle DeadlineHandle = FTSTicker::GetCoreTicker().AddTicker(
+            FTickerDelegate::CreateLambda([WeakState](float)
+            {
+                if (const TSharedPtr<FNearbyChannelsState, ESPMode::ThreadSafe> PinnedState = WeakState.Pin())
+                {
+                    OnNearbyDeadline(PinnedState.ToSharedRef());
+                }
+                return false;
+            }),
+            DeadlineSeconds);
+
+        FScopeLock Lock(&State->CriticalSection);
+        State->DeadlineHandle = DeadlineHandle;
+    }
+
+    // Следующее место конвейера: из списка мест области или из обхода по удалённости
+    bool NextNearbyPlace(FNearbyChannelsState& State, FRadioGardenPlacesIndex::FNearestPlace& OutPlace)
+    {
+        if (State.NextAreaPlace == INDEX_NONE)
+        {
+            return State.NearestPlaces.Next(OutPlace);
+        }
+
+        if (State.NextAreaPlace >= State.AreaPlaces.Num())
+        {
+            return false;
+        }
+
+        OutPlace = State.AreaPlaces[State.NextAreaPlace++];
+        return true;
+    }
+
+    void OnNearbyPlaceChannels(const FNearbyChannelsStateRef& State, int32 SlotIndex, const FChannelsResultRef& Response);
+
+    // Шаг 3: Запрашиваем станции следующих по удалённости мест, пока ожидаемых станций не хватает.
+    // Результат совпадает с последовательным обходом: ответ собирается из непрерывного префикса мест,
+    // станций в котором уже достаточно, поздние ответы дальних мест отбрасываются
+    void ContinueNearby(const FNearbyChannelsStateRef& State)
+    {
+        TArray<TPair<int32, int32>, TInlineAllocator<16>> Dispatch;
+        int32 ResultSlots = INDEX_NONE;
+        {
+            FScopeLock Lock(&State->CriticalSection);
+
+            if (State->bFinished)
+            {
+                return;
+            }
+
+            const int32 PreviousPrefix = State->DonePrefix;
+            while (State->DonePrefix < State->Slots.Num() && State->Slots[State->DonePrefix].bDone)
+            {
+                State->PrefixChannels += State->Slots[State->DonePrefix++].GetChannelsCount();
+            }
+
+            if (State->DonePrefix > PreviousPrefix)
+            {
+                EmitNearbyBatch(*State, PreviousPrefix);
+            }
+
+            if (State->PrefixChannels >= State->ChannelsCount)
+            {
+                ResultSlots = State->DonePrefix;
+            }
+            else
+            {
+                while (State->InFlight < State->MaxConcurrentRequests && !State->bPlacesExhausted
+                    && State->CompletedChannels + State->PredictedInFlight < State->ChannelsCount)
+                {
+                    FRadioGardenPlacesIndex::FNearestPlace Nearest;
+                    if (!NextNearbyPlace(*State, Nearest))
+                    {
+                        State->bPlacesExhausted = true;
+                        break;
+                    }
+
+                    FNearbyPlaceSlot& Slot = State->Slots.AddDefaulted_GetRef();
+                    Slot.PlaceIndex = Nearest.PlaceIndex;
+                    Slot.Distance = Nearest.Distance;
+                    Slot.PredictedChannels = FMath::Max(1, State->Places->Places[Nearest.PlaceIndex].Size);
+
+                    ++State->InFlight;
+                    State->PredictedInFlight += Slot.PredictedChannels;
+                    Dispatch.Emplace(State->Slots.Num() - 1, Nearest.PlaceIndex);
+                }
+
+                if (Dispatch.Num() == 0 && State->InFlight == 0)
+                {
+                    // Места закончились, отдаём всё, что нашлось
+                    ResultSlots = State->Slots.Num();
+                }
+            }
+
+            State->bFinished = ResultSlots != INDEX_NONE;
+        }
+
+        if (ResultSlots != INDEX_NONE)
+        {
+            FinishNearby(State, ResultSlots, false);
+            return;
+        }
+
+        for (const TPair<int32, int32>& Item : Dispatch)
+        {
+            const int32 SlotIndex = Item.Key;
+            const FRadioGardenPlace& Place = State->Places->Places[Item.Value];
+            FChannelsWaiter OnParsed = [State, SlotIndex](const FChannelsResultRef& Response)
+            {
+                OnNearbyPlaceChannels(State, SlotIndex, Response);
+            };
+
+            if (State->SharedPlaces.IsValid())
+            {
+                FetchSharedPlaceChannels(State->SharedPlaces.ToSharedRef(), Place, Item.Value, MoveTemp(OnParsed));
+            }
+            else
+            {
+                FetchPlaceChannels(Place.Id, ERadioGardenRequestPriority::Normal, State->FetchCancellation, MoveTemp(OnParsed));
+            }
+        }
+    }
+
+    void OnNearbyPlaceChannels(const FNearbyChannelsStateRef& State, int32 SlotIndex, const FChannelsResultRef& Response)
+    {
+        {
+            FScopeLock Lock(&State->CriticalSection);
+
+            if (State->bFinished)
+            {
+                return;
+            }
+
+            FNearbyPlaceSlot& Slot = State->Slots[SlotIndex];
+            Slot.bDone = true;
+            Slot.Response = Response;
+
+            --State->InFlight;
+            State->PredictedInFlight -= Slot.PredictedChannels;
+            State->CompletedChannels += Slot.GetChannelsCount();
+        }
+
+        ContinueNearby(State);
+    }
+
+    // Остановить конвейер после отмены: ответы мест и дедлайн больше не обрабатываются
+    void StopNearby(FNearbyChannelsState& State)
+    {
+        {
+            FScopeLock Lock(&State.CriticalSection);
+            State.bFinished = true;
+        }
+
+        ClearNearbyDeadline(State);
+    }
+
+    /**
+     * @param Cancellation Токен вызывающего
+     * @param FetchParent Токен, с которым отменяются запросы конвейера (вызывающего или пакета)
+     */
+    FNearbyChannelsStateRef CreateNearbyState(double Latitude, double Longitude, int32 ChannelsCount,
+        const FRadioGardenCancellationRef& Cancellation, const FRadioGardenCancellationRef& FetchParent,
+        TFunction<void(FRadioGardenNearbyChannelsResponse&&)>&& OnCompleted)
+    {
+        FNearbyChannelsStateRef State = MakeShared<FNearbyChannelsState, ESPMode::ThreadSafe>();
+        State->Latitude = Latitude;
+        State->Longitude = Longitude;
+        State->ChannelsCount = ChannelsCount;
+        State->MaxConcurrentRequests = FMath::Max(1, CVarRadioGardenNearbyMaxConcurrentRequests.GetValueOnAnyThread());
+        State->OnCompleted = MoveTemp(OnCompleted);
+        State->Cancellation = Cancellation;
+        State->FetchCancellation = FRadioGardenCancellationToken::MakeChild(FetchParent);
+
+        State->FetchCancellation->OnCancelled([WeakState = TWeakPtr<FNearbyChannelsState, ESPMode::ThreadSafe>(State)]()
+        {
+            if (const TSharedPtr<FNearbyChannelsState, ESPMode::ThreadSafe> PinnedState = WeakState.Pin())
+            {
+                StopNearby(*PinnedState);
+            }
+        });
+        return State;
+    }
+
+    // Проверить параметры и запустить дедлайн. false - запрос уже завершён ошибкой
+    bool BeginNearby(const FNearbyChannelsStateRef& State, float DeadlineSeconds)
+    {
+        if (State->ChannelsCount <= 0)
+        {
+            FailNearby(State, ERadioGardenStatus::InvalidResponse, TEXT("Channels count must be positive"));
+            return false;
+        }
+
+        StartNearbyDeadline(State, DeadlineSeconds);
+        return true;
+    }
+
+    TOptional<FRadioGardenPlacesCatalog::FIndexRef> GetNearbyIndex(const FRadioGardenPlacesCatalog::FPlacesRef& SharedPlaces)
+    {
+        TOptional<FRadioGardenPlacesCatalog::FIndexRef> Index;
+        if (SharedPlaces->bSuccessful)
+        {
+            Index = FRadioGardenPlacesCatalog::Get().GetIndex(SharedPlaces);
+        }
+        return Index;
+    }
+
+    // Шаг 2: Обходим места по удалённости через пространственный индекс каталога
+    void ContinueNearbyWithPlaces(const FNearbyChannelsStateRef& State, const FRadioGardenPlacesCatalog::FPlacesRef& SharedPlaces,
+        const TOptional<FRadioGardenPlacesCatalog::FIndexRef>& Index)
+    {
+        {
+            FScopeLock Lock(&State->CriticalSection);
+
+            // Дедлайн мог истечь раньше, чем пришли места
+            if (State->bFinished)
+            {
+                return;
+            }
+
+            if (Index.IsSet())
+            {
+                // Версия берётся вместе с самим списком: на холодном старте каталог загружается уже после вызова
+                State->Places = SharedPlaces;
+                State->ResultCacheVersion = FRadioGardenPlacesCatalog::Get().GetVersion(SharedPlaces);
+                State->NearestPlaces = FRadioGardenPlacesIndex::FNearestIterator(Index.GetValue(), State->Latitude, State->Longitude);
+            }
+            else
+            {
+                State->bFinished = true;
+            }
+        }
+
+        if (!Index.IsSet())
+        {
+            FailNearby(State, SharedPlaces->Status, SharedPlaces->ErrorMessage);
+            return;
+        }
+
+        ContinueNearby(State);
+    }
+}
+
+FRadioGardenRequestHandle IRadioGardenAPI::GetNearbyChannelsAsync(double Latitude, double Longitude, int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds)
+{
+    return GetNearbyChannelsStreamAsync(Latitude, Longitude, ChannelsCount, FOnRadioGardenNearbyChannelsBatch(), OnCompleted, DeadlineSeconds);
+}
+
+FRadioGardenRequestHandle IRadioGardenAPI::GetNearbyChannelsStreamAsync(double Latitude, double Longitude, int32 ChannelsCount,
+    const FOnRadioGardenNearbyChannelsBatch& OnBatch, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds)
+{
+    FRadioGardenRequestHandle Handle;
+    const FRadioGardenCancellationRef Cancellation = BeginCancellableRequest(Handle);
+
+    // Без порций результат берётся из кэша ячейки, если он там есть
+    const FString ResultCacheKey = OnBatch.IsBound() ? FString() : MakeNearbyResultKey(Latitude, Longitude, ChannelsCount);
+    FRadioGardenNearbyChannelsResponse CachedResponse;
+    if (FindNearbyResult(ResultCacheKey, Latitude, Longitude, CachedResponse))
+    {
+        DispatchToGameThread(OnCompleted, MoveTemp(CachedResponse), Cancellation);
+        return Handle;
+    }
+
+    const FNearbyChannelsStateRef State = CreateNearbyState(Latitude, Longitude, ChannelsCount, Cancellation, Cancellation,
+        [OnCompleted, Cancellation](FRadioGardenNearbyChannelsResponse&& Response)
+        {
+            DispatchToGameThread(OnCompleted, MoveTemp(Response), Cancellation);
+        });
+    State->OnBatch = OnBatch;
+    State->ResultCacheKey = ResultCacheKey;
+
+    if (!BeginNearby(State, DeadlineSeconds))
+    {
+        return Handle;
+    }
+
+    // Шаг 1: Получаем все места
+    FetchPlaces(State->FetchCancellation, [State](const FRadioGardenPlacesCatalog::FPlacesRef& SharedPlaces)
+    {
+        ContinueNearbyWithPlaces(State, SharedPlaces, GetNearbyIndex(SharedPlaces));
+    });
+    return Handle;
+}
+
+FRadioGardenRequestHandle IRadioGardenAPI::GetNearbyChannelsMultiAsync(const TArray<FRadioGardenNearbyQuery>& Queries, const FOnRadioGardenNearbyChannelsMultiReceived& OnCompleted, float DeadlineSeconds)
+{
+    FRadioGardenRequestHandle Handle;
+    const FRadioGardenCancellationRef Cancellation = BeginCancellableRequest(Handle);
+
+    // Ответы запросов собираются по индексам, общий ответ уходит после последнего
+    struct FMultiState
+    {
+        FCriticalSection CriticalSection;
+        FRadioGardenNearbyChannelsMultiResponse Response;
+        int32 Remaining = 0;
+        FOnRadioGardenNearbyChannelsMultiReceived OnCompleted;
+        FRadioGardenCancellationPtr Cancellation;
+
+        // Токен пакета: отмена вызова или завершение последнего запроса отменяет все запросы пакета
+        FRadioGardenCancellationPtr BatchCancellation;
+    };
+
+    const TSharedRef<FMultiState, ESPMode::ThreadSafe> Multi = MakeShared<FMultiState, ESPMode::ThreadSafe>();
+    Multi->Response.Responses.SetNum(Queries.Num());
+    Multi->Remaining = Queries.Num();
+    Multi->OnCompleted = OnCompleted;
+    Multi->Cancellation = Cancellation;
+    Multi->BatchCancellation = FRadioGardenCancellationToken::MakeChild(Cancellation);
+
+    auto FinishMulti = [](FMultiState& MultiState)
+    {
+        MultiState.BatchCancellation->Cancel();
+
+        FRadioGardenNearbyChannelsMultiResponse& Response = MultiState.Response;
+        Response.bSuccessful = Response.Responses.Num() == 0;
+        for (const FRadioGardenNearbyChannelsResponse& QueryResponse : Response.Responses)
+        {
+            Response.bSuccessful |= QueryResponse.bSuccessful;
+        }
+        Response.Status = Response.bSuccessful ? ERadioGardenStatus::Success : Response.Responses[0].Status;
+        Response.ErrorMessage = Response.bSuccessful ? FString() : Response.Responses[0].ErrorMessage;
+        DispatchToGameThread(MultiState.OnCompleted, MoveTemp(Response), MultiState.Cancellation);
+    };
+
+    if (Queries.Num() == 0)
+    {
+        FinishMulti(*Multi);
+        return Handle;
+    }
+
+    // Все запросы пакета делят снимок каталога, его индекс и ответы мест
+    const FNearbySharedPlacesRef Shared = MakeShared<FNearbySharedPlaces, ESPMode::ThreadSafe>();
+    Shared->Cancellation = Multi->BatchCancellation;
+    const FRadioGardenCancellationRef BatchCancellation = Multi->BatchCancellation.ToSharedRef();
+
+    TArray<FNearbyChannelsStateRef> States;
+    States.Reserve(Queries.Num());
+    for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+    {
+        const FRadioGardenNearbyQuery& Query = Queries[QueryIndex];
+        const FNearbyChannelsStateRef State = CreateNearbyState(Query.Latitude, Query.Longitude, Query.ChannelsCount, Cancellation, BatchCancellation,
+            [Multi, QueryIndex, FinishMulti](FRadioGardenNearbyChannelsResponse&& Response)
+            {
+                bool bLast = false;
+                {
+                    FScopeLock Lock(&Multi->CriticalSection);
+                    Multi->Response.Responses[QueryIndex] = MoveTemp(Response);
+                    bLast = --Multi->Remaining == 0;
+                }
+
+                if (bLast)
+                {
+                    FinishMulti(*Multi);
+                }
+            });
+        State->SharedPlaces = Shared;
+
+        if (BeginNearby(State, DeadlineSeconds))
+        {
+            States.Add(State);
+        }
+    }
+
+    if (States.Num() == 0)
+    {
+        return Handle;
+    }
+
+    FetchPlaces(BatchCancellation, [States = MoveTemp(States)](const FRadioGardenPlacesCatalog::FPlacesRef& SharedPlaces)
+    {
+        const TOptional<FRadioGardenPlacesCatalog::FIndexRef> Index = GetNearbyIndex(SharedPlaces);
+        for (const FNearbyChannelsStateRef& State : States)
+        {
+            ContinueNearbyWithPlaces(State, SharedPlaces, Index);
+        }
+    });
+    return Handle;
+}
+
+namespace
+{
+    // Геолокация и места для поиска по геолокации: приходят независимо, обход мест начинается со вторым из них
+    struct FNearbyGeolocationJoin
+    {
+        FCriticalSection CriticalSection;
+        TSharedPtr<const FRadioGardenGeolocationResponse, ESPMode::ThreadSafe> Geolocation;
+        FRadioGardenPlacesCatalog::FPlacesPtr Places;
+    };
+
+    using FNearbyGeolocationJoinRef = TSharedRef<FNearbyGeolocationJoin, ESPMode::ThreadSafe>;
+
+    void ContinueNearbyWithGeolocation(const FNearbyChannelsStateRef& State, const FRadioGardenGeolocationResponse& GeoResponse,
+        const FRadioGardenPlacesCatalog::FPlacesRef& SharedPlaces)
+    {
+        if (!GeoResponse.bSuccessful)
+        {
+            bool bAlreadyFinished = false;
+            {
+                FScopeLock Lock(&State->CriticalSection);
+                bAlreadyFinished = State->bFinished;
+                State->bFinished = true;
+            }
+
+            if (!bAlreadyFinished)
+            {
+                FailNearby(State, GeoResponse.Status, GeoResponse.ErrorMessage);
+            }
+            return;
+        }
+
+        const double Latitude = GeoResponse.Geolocation.Latitude;
+        const double Longitude = GeoResponse.Geolocation.Longitude;
+        const FString ResultCacheKey = MakeNearbyResultKey(Latitude, Longitude, State->ChannelsCount);
+
+        FRadioGardenNearbyChannelsResponse CachedResponse;
+        if (FindNearbyResult(ResultCacheKey, Latitude, Longitude, CachedResponse))
+        {
+            bool bAlreadyFinished = false;
+            {
+                FScopeLock Lock(&State->CriticalSection);
+                bAlreadyFinished = State->bFinished;
+                State->bFinished = true;
+            }
+
+            if (!bAlreadyFinished)
+            {
+                EndNearbyRequests(*State);
+                State->OnCompleted(MoveTemp(CachedResponse));
+            }
+            return;
+        }
+
+        {
+            FScopeLock Lock(&State->CriticalSection);
+            State->Latitude = Latitude;
+            State->Longitude = Longitude;
+            State->ResultCacheKey = ResultCacheKey;
         }
 
-        OutResponse.Channels.Add(Channel);
+        ContinueNearbyWithPlaces(State, SharedPlaces, GetNearbyIndex(SharedPlaces));
     }
-
-    OutResponse.Status = ERadioGardenStatus::Success;
-    OutResponse.bSuccessful = true;
 }
 
-void IRadioGardenAPI::GetPlaceChannelsAsync(const FString& PlaceId, const FOnRadioGardenChannelsReceived& OnCompleted)
+FRadioGardenRequestHandle IRadioGardenAPI::GetNearbyChannelsByGeolocationAsync(int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds)
 {
-    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [PlaceId, OnCompleted]()
-    {
-        FRadioGardenChannelsResponse Response;
-        GetPlaceChannels(PlaceId, Response);
+    FRadioGardenRequestHandle Handle;
+    const FRadioGardenCancellationRef Cancellation = BeginCancellableRequest(Handle);
 
-        AsyncTask(ENamedThreads::GameThread, [Response, OnCompleted]()
+    // Координаты станут известны с геолокацией; дедлайн отсчитывается от вызова
+    const FNearbyChannelsStateRef State = CreateNearbyState(0.0, 0.0, ChannelsCount, Cancellation, Cancellation,
+        [OnCompleted, Cancellation](FRadioGardenNearbyChannelsResponse&& Response)
         {
-            OnCompleted.ExecuteIfBound(Response);
+            DispatchToGameThread(OnCompleted, MoveTemp(Response), Cancellation);
         });
-    });
-}
-
-// ========== Channels (Станции) ==========
-
-void IRadioGardenAPI::GetChannel(const FString& ChannelId, FRadioGardenChannelResponse& OutResponse)
-{
-    OutResponse = FRadioGardenChannelResponse();
-
-    if (!IsValidId(ChannelId))
-    {
-        OutResponse.Status = ERadioGardenStatus::InvalidResponse;
-        OutResponse.ErrorMessage = TEXT("Invalid Channel ID");
-        return;
-    }
-
-    const FString Endpoint = FString::Printf(TEXT("/ara/content/channel/%s"), *ChannelId);
-    FString ResponseContent;
-    FString ErrorMessage;
-
-    if (!FRadioGardenHttpRequest::ExecuteGet(Endpoint, ResponseContent, ErrorMessage))
-    {
-        OutResponse.Status = ERadioGardenStatus::NetworkError;
-        OutResponse.ErrorMessage = ErrorMessage;
-        return;
-    }
-
-    TSharedPtr<FJsonObject> JsonObject;
-    if (!FRadioGardenHttpRequest::ParseJson(ResponseContent, JsonObject))
-    {
-        OutResponse.Status = ERadioGardenStatus::ParseError;
-        OutResponse.ErrorMessage = TEXT("Failed to parse JSON");
-        return;
-    }
 
-    TSharedPtr<FJsonObject> DataObj;
-    if (!FRadioGardenHttpRequest::GetObjectSafe(JsonObject, TEXT("data"), DataObj))
+    if (!BeginNearby(State, DeadlineSeconds))
     {
-        OutResponse.Status = ERadioGardenStatus::ParseError;
-        OutResponse.ErrorMessage = TEXT("Invalid response format");
-        return;
+        return Handle;
     }
 
-    FRadioGardenChannel& Channel = OutResponse.Channel;
-    Channel.Id = FRadioGardenHttpRequest::GetStringSafe(DataObj, TEXT("id"));
-    Channel.Title = FRadioGardenHttpRequest::GetStringSafe(DataObj, TEXT("title"));
-    Channel.Url = FRadioGardenHttpRequest::GetStringSafe(DataObj, TEXT("url"));
-    Channel.Website = FRadioGardenHttpRequest::GetStringSafe(DataObj, TEXT("website"));
-    Channel.bSecure = FRadioGardenHttpRequest::GetBoolSafe(DataObj, TEXT("secure"));
-
-    // Парсим место
-    TSharedPtr<FJsonObject> PlaceObj;
-    if (FRadioGardenHttpRequest::GetObjectSafe(DataObj, TEXT("place"), PlaceObj))
-    {
-        Channel.PlaceId = FRadioGardenHttpRequest::GetStringSafe(PlaceObj, TEXT("id"));
-        Channel.PlaceTitle = FRadioGardenHttpRequest::GetStringSafe(PlaceObj, TEXT("title"));
-    }
+    // Геолокация (обычно уже известная за сессию) и места запрашиваются параллельно, без промежуточного вызова GetNearbyChannelsAsync
+    const FNearbyGeolocationJoinRef Join = MakeShared<FNearbyGeolocationJoin, ESPMode::ThreadSafe>();
 
-    // Парсим страну
-    TSharedPtr<FJsonObject> CountryObj;
-    if (FRadioGardenHttpRequest::GetObjectSafe(DataObj, TEXT("country"), CountryObj))
+    FetchSessionGeolocation(State->FetchCancellation, [State, Join](const FGeolocationResultRef& GeoResponse)
     {
-        Channel.CountryId = FRadioGardenHttpRequest::GetStringSafe(CountryObj, TEXT("id"));
-        Channel.CountryTitle = FRadioGardenHttpRequest::GetStringSafe(CountryObj, TEXT("title"));
-    }
+        FRadioGardenPlacesCatalog::FPlacesPtr Places;
+        {
+            FScopeLock Lock(&Join->CriticalSection);
+            Join->Geolocation = GeoResponse;
+            Places = Join->Places;
+        }
 
-    OutResponse.Status = ERadioGardenStatus::Success;
-    OutResponse.bSuccessful = true;
-}
+        if (Places.IsValid())
+        {
+            ContinueNearbyWithGeolocation(State, *GeoResponse, Places.ToSharedRef());
+        }
+    });
 
-void IRadioGardenAPI::GetChannelAsync(const FString& ChannelId, const FOnRadioGardenChannelReceived& OnCompleted)
-{
-    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [ChannelId, OnCompleted]()
+    FetchPlaces(State->FetchCancellation, [State, Join](const FRadioGardenPlacesCatalog::FPlacesRef& SharedPlaces)
     {
-        FRadioGardenChannelResponse Response;
-        GetChannel(ChannelId, Response);
+        TSharedPtr<const FRadioGardenGeolocationResponse, ESPMode::ThreadSafe> GeoResponse;
+        {
+            FScopeLock Lock(&Join->CriticalSection);
+            Join->Places = SharedPlaces;
+            GeoResponse = Join->Geolocation;
+        }
 
-        AsyncTask(ENamedThreads::GameThread, [Response, OnCompleted]()
+        if (GeoResponse.IsValid())
         {
-            OnCompleted.ExecuteIfBound(Response);
-        });
+            ContinueNearbyWithGeolocation(State, *GeoResponse, SharedPlaces);
+        }
     });
+    return Handle;
 }
 
-bool IRadioGardenAPI::GetChannelStreamUrl(const FString& ChannelId, FString& OutStreamUrl, FString& OutErrorMessage)
+// ========== Areas (Области) ==========
+
+FRadioGardenRequestHandle IRadioGardenAPI::GetPlacesInAreaAsync(const FRadioGardenGeoArea& Area, const FOnRadioGardenPlacesReceived& OnCompleted)
 {
-    OutStreamUrl.Empty();
+    FRadioGardenRequestHandle Handle;
+    const FRadioGardenCancellationRef Cancellation = BeginCancellableRequest(Handle);
 
-    if (!IsValidId(ChannelId))
+    FString AreaError;
+    if (!FRadioGardenGeoAreaQuery::Validate(Area, AreaError))
     {
-        OutErrorMessage = TEXT("Invalid Channel ID");
-        return false;
+        FRadioGardenPlacesResponse Response;
+        Response.Status = ERadioGardenStatus::InvalidResponse;
+        Response.ErrorMessage = AreaError;
+        Response.bSuccessful = false;
+        DispatchToGameThread(OnCompleted, MoveTemp(Response), Cancellation);
+        return Handle;
     }
 
-    const FString Endpoint = FString::Printf(TEXT("/ara/content/listen/%s/channel.mp3"), *ChannelId);
-
-    if (!FRadioGardenHttpRequest::ExecuteGetRedirect(Endpoint, OutStreamUrl, OutErrorMessage))
+    FetchPlaces(Cancellation, [Area, OnCompleted, Cancellation](const FRadioGardenPlacesCatalog::FPlacesRef& SharedPlaces)
     {
-        return false;
-    }
+        // Отменённый вызов не выбирает места из индекса
+        if (Cancellation->IsCancelled())
+        {
+            return;
+        }
 
-    return !OutStreamUrl.IsEmpty();
-}
+        FRadioGardenPlacesResponse Response;
+        const TOptional<FRadioGardenPlacesCatalog::FIndexRef> Index = GetNearbyIndex(SharedPlaces);
+        if (!Index.IsSet())
+        {
+            Response.Status = SharedPlaces->Status;
+            Response.ErrorMessage = SharedPlaces->ErrorMessage;
+            Response.HttpResponseCode = SharedPlaces->HttpResponseCode;
+            Response.bSuccessful = false;
+            DispatchToGameThread(OnCompleted, MoveTemp(Response), Cancellation);
+            return;
+        }
 
-void IRadioGardenAPI::GetChannelStreamUrlAsync(const FString& ChannelId, const FOnRadioGardenStreamUrlReceived& OnCompleted)
-{
-    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [ChannelId, OnCompleted]()
-    {
-        FString StreamUrl;
-        FString ErrorMessage;
-        const bool bSuccess = GetChannelStreamUrl(ChannelId, StreamUrl, ErrorMessage);
+        TArray<FRadioGardenPlacesIndex::FNearestPlace> AreaPlaces;
+        FRadioGardenGeoAreaQuery::FindPlaces(Index.GetValue(), Area, AreaPlaces);
 
-        AsyncTask(ENamedThreads::GameThread, [bSuccess, StreamUrl, OnCompleted]()
+        Response.Places.Reserve(AreaPlaces.Num());
+        for (const FRadioGardenPlacesIndex::FNearestPlace& AreaPlace : AreaPlaces)
         {
-            OnCompleted.ExecuteIfBound(bSuccess, StreamUrl);
-        });
+            Response.Places.Add(SharedPlaces->Places[AreaPlace.PlaceIndex]);
+        }
+
+        // Пустая область - не ошибка
+        Response.HttpResponseCode = SharedPlaces->HttpResponseCode;
+        Response.Status = ERadioGardenStatus::Success;
+        Response.bSuccessful = true;
+        DispatchToGameThread(OnCompleted, MoveTemp(Response), Cancellation);
     });
+    return Handle;
 }
 
-// ========== Search (Поиск) ==========
-
-void IRadioGardenAPI::Search(const FString& Query, FRadioGardenSearchResponse& OutResponse)
+FRadioGardenRequestHandle IRadioGardenAPI::GetChannelsInAreaAsync(const FRadioGardenGeoArea& Area, int32 MaxChannels, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds)
 {
-    OutResponse = FRadioGardenSearchResponse();
-    OutResponse.Query = Query;
+    FRadioGardenRequestHandle Handle;
+    const FRadioGardenCancellationRef Cancellation = BeginCancellableRequest(Handle);
+
+    // Расстояния станций считаются от опорной точки области
+    const FRadioGardenCoords Reference = FRadioGardenGeoAreaQuery::GetReferencePoint(Area);
+    const FNearbyChannelsStateRef State = CreateNearbyState(Reference.Latitude, Reference.Longitude, MaxChannels > 0 ? MaxChannels : MAX_int32,
+        Cancellation, Cancellation,
+        [OnCompleted, Cancellation](FRadioGardenNearbyChannelsResponse&& Response)
+        {
+            DispatchToGameThread(OnCompleted, MoveTemp(Response), Cancellation);
+        });
 
-    if (Query.IsEmpty())
+    FString AreaError;
+    if (!FRadioGardenGeoAreaQuery::Validate(Area, AreaError))
     {
-        OutResponse.Status = ERadioGardenStatus::InvalidResponse;
-        OutResponse.ErrorMessage = TEXT("Empty search query");
-        return;
+        FailNearby(State, ERadioGardenStatus::InvalidResponse, AreaError);
+        return Handle;
     }
 
-    const FString EncodedQuery = Query.Replace(TEXT(" "), TEXT("+")).Replace(TEXT("%20"), TEXT("+"));
-    const FString Endpoint = FString::Printf(TEXT("/search?q=%s"), *EncodedQuery);
-    FString ResponseContent;
-    FString ErrorMessage;
-
-    if (!FRadioGardenHttpRequest::ExecuteGet(Endpoint, ResponseContent, ErrorMessage))
+    if (!BeginNearby(State, DeadlineSeconds))
     {
-        OutResponse.Status = ERadioGardenStatus::NetworkError;
-        OutResponse.ErrorMessage = ErrorMessage;
-        return;
+        return Handle;
     }
 
-    TSharedPtr<FJsonObject> JsonObject;
-    if (!FRadioGardenHttpRequest::ParseJson(ResponseContent, JsonObject))
+    // Места области выбираются индексом сразу целиком, дальше работает обычный конвейер станций
+    FetchPlaces(State->FetchCancellation, [State, Area](const FRadioGardenPlacesCatalog::FPlacesRef& SharedPlaces)
     {
-        OutResponse.Status = ERadioGardenStatus::ParseError;
-        OutResponse.ErrorMessage = TEXT("Failed to parse JSON");
-        return;
-    }
+        if (State->FetchCancellation->IsCancelled())
+        {
+            return;
+        }
 
-    OutResponse.TimeTaken = static_cast<int32>(FRadioGardenHttpRequest::GetNumberSafe(JsonObject, TEXT("took")));
+        const TOptional<FRadioGardenPlacesCatalog::FIndexRef> Index = GetNearbyIndex(SharedPlaces);
+        if (Index.IsSet())
+        {
+            TArray<FRadioGardenPlacesIndex::FNearestPlace> AreaPlaces;
+            FRadioGardenGeoAreaQuery::FindPlaces(Index.GetValue(), Area, AreaPlaces);
 
-    // Получаем результаты
-    TSharedPtr<FJsonObject> HitsObj;
-    if (!FRadioGardenHttpRequest::GetObjectSafe(JsonObject, TEXT("hits"), HitsObj))
-    {
-        OutResponse.Status = ERadioGardenStatus::ParseError;
-        OutResponse.ErrorMessage = TEXT("Invalid response format");
-        return;
-    }
+            FScopeLock Lock(&State->CriticalSection);
+            State->AreaPlaces = MoveTemp(AreaPlaces);
+            State->NextAreaPlace = 0;
+        }
+
+        ContinueNearbyWithPlaces(State, SharedPlaces, Index);
+    });
+    return Handle;
+}
+
+// ========== Routes (Маршруты) ==========
+
+FRadioGardenRequestHandle IRadioGardenAPI::GetPlacesAlongRouteAsync(const FRadioGardenRoute& Route, const FOnRadioGardenPlacesReceived& OnCompleted)
+{
+    FRadioGardenRequestHandle Handle;
+    const FRadioGardenCancellationRef Cancellation = BeginCancellableRequest(Handle);
 
-    const TArray<TSharedPtr<FJsonValue>>* HitsArray;
-    if (!FRadioGardenHttpRequest::GetArraySafe(HitsObj, TEXT("hits"), HitsArray))
+    FString RouteError;
+    if (!FRadioGardenRouteQuery::Validate(Route, RouteError))
     {
-        OutResponse.Status = ERadioGardenStatus::Success;
-        OutResponse.bSuccessful = true;
-        return;
+        FRadioGardenPlacesResponse Response;
+        Response.Status = ERadioGardenStatus::InvalidResponse;
+        Response.ErrorMessage = RouteError;
+        Response.bSuccessful = false;
+        DispatchToGameThread(OnCompleted, MoveTemp(Response), Cancellation);
+        return Handle;
     }
 
-    // Парсим результаты
-    for (const TSharedPtr<FJsonValue>& HitValue : *HitsArray)
+    FetchPlaces(Cancellation, [Route, OnCompleted, Cancellation](const FRadioGardenPlacesCatalog::FPlacesRef& SharedPlaces)
     {
-        const TSharedPtr<FJsonObject>& HitObj = HitValue->AsObject();
-        if (!HitObj.IsValid())
+        // Отменённый вызов не выбирает места из индекса
+        if (Cancellation->IsCancelled())
         {
-            continue;
+            return;
         }
 
-        TSharedPtr<FJsonObject> SourceObj;
-        if (!FRadioGardenHttpRequest::GetObjectSafe(HitObj, TEXT("_source"), SourceObj))
+        FRadioGardenPlacesResponse Response;
+        const TOptional<FRadioGardenPlacesCatalog::FIndexRef> Index = GetNearbyIndex(SharedPlaces);
+        if (!Index.IsSet())
         {
-            continue;
+            Response.Status = SharedPlaces->Status;
+            Response.ErrorMessage = SharedPlaces->ErrorMessage;
+            Response.HttpResponseCode = SharedPlaces->HttpResponseCode;
+            Response.bSuccessful = false;
+            DispatchToGameThread(OnCompleted, MoveTemp(Response), Cancellation);
+            return;
         }
 
-        FRadioGardenSearchResult Result;
-        Result.Id = FRadioGardenHttpRequest::GetStringSafe(HitObj, TEXT("_id"));
-        Result.Score = static_cast<float>(FRadioGardenHttpRequest::GetNumberSafe(HitObj, TEXT("_score")));
-        Result.Type = FRadioGardenHttpRequest::GetStringSafe(SourceObj, TEXT("type"));
-        Result.Title = FRadioGardenHttpRequest::GetStringSafe(SourceObj, TEXT("title"));
-        Result.Subtitle = FRadioGardenHttpRequest::GetStringSafe(SourceObj, TEXT("subtitle"));
-        Result.CountryCode = FRadioGardenHttpRequest::GetStringSafe(SourceObj, TEXT("code"));
-        Result.Url = FRadioGardenHttpRequest::GetStringSafe(SourceObj, TEXT("url"));
+        TArray<FRadioGardenPlacesIndex::FNearestPlace> RoutePlaces;
+        FRadioGardenRouteQuery::FindPlaces(Index.GetValue(), Route, RoutePlaces);
 
-        OutResponse.Results.Add(Result);
-    }
+        Response.Places.Reserve(RoutePlaces.Num());
+        for (const FRadioGardenPlacesIndex::FNearestPlace& RoutePlace : RoutePlaces)
+        {
+            Response.Places.Add(SharedPlaces->Places[RoutePlace.PlaceIndex]);
+        }
 
-    OutResponse.Status = ERadioGardenStatus::Success;
-    OutResponse.bSuccessful = true;
+        // Пустой коридор - не ошибка
+        Response.HttpResponseCode = SharedPlaces->HttpResponseCode;
+        Response.Status = ERadioGardenStatus::Success;
+        Response.bSuccessful = true;
+        DispatchToGameThread(OnCompleted, MoveTemp(Response), Cancellation);
+    });
+    return Handle;
 }
 
-void IRadioGardenAPI::SearchAsync(const FString& Query, const FOnRadioGardenSearchCompleted& OnCompleted)
+FRadioGardenRequestHandle IRadioGardenAPI::GetChannelsAlongRouteAsync(const FRadioGardenRoute& Route, int32 MaxChannels, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds)
 {
-    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Query, OnCompleted]()
-    {
-        FRadioGardenSearchResponse Response;
-        Search(Query, Response);
-
-        AsyncTask(ENamedThreads::GameThread, [Response, OnCompleted]()
+    FRadioGardenRequestHandle Handle;
+    const FRadioGardenCancellationRef Cancellation = BeginCancellableRequest(Handle);
+
+    // Расстояние станции - путь вдоль маршрута до проекции её места
+    const FRadioGardenCoords Start = Route.Waypoints.Num() > 0 ? Route.Waypoints[0] : FRadioGardenCoords();
+    const FNearbyChannelsStateRef State = CreateNearbyState(Start.Latitude, Start.Longitude, MaxChannels > 0 ? MaxChannels : MAX_int32,
+        Cancellation, Cancellation,
+        [OnCompleted, Cancellation](FRadioGardenNearbyChannelsResponse&& Response)
         {
-            OnCompleted.ExecuteIfBound(Response);
+            DispatchToGameThread(OnCompleted, MoveTemp(Response), Cancellation);
         });
-    });
-}
-
-// ========== Geo (Геолокация) ==========
-
-void IRadioGardenAPI::GetGeolocation(FRadioGardenGeolocationResponse& OutResponse)
-{
-    OutResponse = FRadioGardenGeolocationResponse();
-
-    FString ResponseContent;
-    FString ErrorMessage;
 
-    if (!FRadioGardenHttpRequest::ExecuteGet(TEXT("/geo"), ResponseContent, ErrorMessage))
+    FString RouteError;
+    if (!FRadioGardenRouteQuery::Validate(Route, RouteError))
     {
-        OutResponse.Status = ERadioGardenStatus::NetworkError;
-        OutResponse.ErrorMessage = ErrorMessage;
-        return;
+        FailNearby(State, ERadioGardenStatus::InvalidResponse, RouteError);
+        return Handle;
     }
 
-    TSharedPtr<FJsonObject> JsonObject;
-    if (!FRadioGardenHttpRequest::ParseJson(ResponseContent, JsonObject))
+    if (!BeginNearby(State, DeadlineSeconds))
     {
-        OutResponse.Status = ERadioGardenStatus::ParseError;
-        OutResponse.ErrorMessage = TEXT("Failed to parse JSON");
-        return;
+        return Handle;
     }
 
-    FRadioGardenGeolocation& Geo = OutResponse.Geolocation;
-    Geo.Ip = FRadioGardenHttpRequest::GetStringSafe(JsonObject, TEXT("ip"));
-    Geo.CountryCode = FRadioGardenHttpRequest::GetStringSafe(JsonObject, TEXT("country_code"));
-    Geo.CountryName = FRadioGardenHttpRequest::GetStringSafe(JsonObject, TEXT("country_name"));
-    Geo.RegionCode = FRadioGardenHttpRequest::GetStringSafe(JsonObject, TEXT("region_code"));
-    Geo.RegionName = FRadioGardenHttpRequest::GetStringSafe(JsonObject, TEXT("region_name"));
-    Geo.City = FRadioGardenHttpRequest::GetStringSafe(JsonObject, TEXT("city"));
-    Geo.ZipCode = FRadioGardenHttpRequest::GetStringSafe(JsonObject, TEXT("zip_code"));
-    Geo.TimeZone = FRadioGardenHttpRequest::GetStringSafe(JsonObject, TEXT("time_zone"));
-    Geo.Latitude = FRadioGardenHttpRequest::GetNumberSafe(JsonObject, TEXT("latitude"));
-    Geo.Longitude = FRadioGardenHttpRequest::GetNumberSafe(JsonObject, TEXT("longitude"));
-    Geo.MetroCode = static_cast<int32>(FRadioGardenHttpRequest::GetNumberSafe(JsonObject, TEXT("metro_code")));
-
-    OutResponse.Status = ERadioGardenStatus::Success;
-    OutResponse.bSuccessful = true;
-}
-
-void IRadioGardenAPI::GetGeolocationAsync(const FOnRadioGardenGeolocationReceived& OnCompleted)
-{
-    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [OnCompleted]()
+    // Места коридора уже упорядочены вдоль маршрута, станции запрашиваются обычным конвейером с ограниченным параллелизмом
+    FetchPlaces(State->FetchCancellation, [State, Route](const FRadioGardenPlacesCatalog::FPlacesRef& SharedPlaces)
     {
-        FRadioGardenGeolocationResponse Response;
-        GetGeolocation(Response);
+        if (State->FetchCancellation->IsCancelled())
+        {
+            return;
+        }
 
-        AsyncTask(ENamedThreads::GameThread, [Response, OnCompleted]()
+        const TOptional<FRadioGardenPlacesCatalog::FIndexRef> Index = GetNearbyIndex(SharedPlaces);
+        if (Index.IsSet())
         {
-            OnCompleted.ExecuteIfBound(Response);
-        });
+            TArray<FRadioGardenPlacesIndex::FNearestPlace> RoutePlaces;
+            FRadioGardenRouteQuery::FindPlaces(Index.GetValue(), Route, RoutePlaces);
+
+            FScopeLock Lock(&State->CriticalSection);
+            State->AreaPlaces = MoveTemp(RoutePlaces);
+            State->NextAreaPlace = 0;
+        }
+
+        ContinueNearbyWithPlaces(State, SharedPlaces, Index);
     });
+    return Handle;
 }
 
-// ========== Nearby Channels ==========
+// ========== Globe View (Глобус) ==========
 
 namespace
 {
-    // Вспомогательная структура для хранения места с расстоянием
-    struct FPlaceWithDistance
+    // Маркер отдельного места - индекс места, кластера - флаг, уровень и ячейка сетки
+    constexpr int64 GlobeClusterMarkerFlag = int64(1) << 62;
+
+    // Состояние вида глобуса. Обновления обрабатываются по одному в фоновом потоке: пока идёт расчёт,
+    // новый вид только заменяет ожидающий, поэтому промежуточные положения камеры пропускаются,
+    // а дельта всегда считается от последнего выданного набора
+    struct FGlobeViewState
     {
-        FRadioGardenPlace Place;
-        double Distance;
+        FOnRadioGardenGlobeViewUpdated OnUpdated;
 
-        FPlaceWithDistance() : Distance(0.0) {}
-        FPlaceWithDistance(const FRadioGardenPlace& InPlace, double InDistance)
-            : Place(InPlace), Distance(InDistance) {}
+        FCriticalSection CriticalSection;
+        TOptional<FRadioGardenGlobeView> PendingView;
+        bool bProcessing = false;
+        bool bReleased = false;
 
-        bool operator<(const FPlaceWithDistance& Other) const
-        {
-            return Distance < Other.Distance;
-        }
+        // Выданный набор маркеров; меняется только обработчиком, который всегда один
+        FRadioGardenPlacesCatalog::FPlacesPtr Places;
+        TSet<int64> VisibleMarkers;
     };
 
-    // Вычисление расстояния по формуле Хаверсина (в километрах)
-    double CalculateDistance(double Lat1, double Lon1, double Lat2, double Lon2)
-    {
-        const double R = 6371.0; // Радиус Земли в км
-        const double DLat = FMath::DegreesToRadians(Lat2 - Lat1);
-        const double DLon = FMath::DegreesToRadians(Lon2 - Lon1);
+    using FGlobeViewStateRef = TSharedRef<FGlobeViewState, ESPMode::ThreadSafe>;
 
-        const double A = FMath::Sin(DLat / 2) * FMath::Sin(DLat / 2) +
-                         FMath::Cos(FMath::DegreesToRadians(Lat1)) * FMath::Cos(FMath::DegreesToRadians(Lat2)) *
-                         FMath::Sin(DLon / 2) * FMath::Sin(DLon / 2);
+    FCriticalSection GlobeViewsCriticalSection;
+    TMap<int32, FGlobeViewStateRef> GlobeViews;
+    int32 NextGlobeViewId = 1;
 
-        const double C = 2 * FMath::Atan2(FMath::Sqrt(A), FMath::Sqrt(1 - A));
-        return R * C;
+    FRadioGardenGlobeMarker MakePlaceMarker(const FRadioGardenPlacesResponse& Places, int32 PlaceIndex)
+    {
+        const FRadioGardenPlace& Place = Places.Places[PlaceIndex];
+
+        FRadioGardenGlobeMarker Marker;
+        Marker.Id = PlaceIndex;
+        Marker.Geo = Place.Geo;
+        Marker.PlaceCount = 1;
+        Marker.Size = Place.Size;
+        Marker.PlaceId = Place.Id;
+        Marker.Title = Place.Title;
+        Marker.Country = Place.Country;
+        return Marker;
     }
-}
 
-void IRadioGardenAPI::GetNearbyChannelsAsync(double Latitude, double Longitude, int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted)
-{
-    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Latitude, Longitude, ChannelsCount, OnCompleted]()
+    // Видимые маркеры: кластеры уровня вида или, на масштабе крупнее самого подробного уровня, отдельные места
+    void CollectGlobeMarkers(const FRadioGardenPlacesCatalog::FPlacesRef& Places, const FRadioGardenGlobeView& View, TArray<FRadioGardenGlobeMarker>& OutMarkers)
     {
-        FRadioGardenNearbyChannelsResponse Response;
-        Response.Status = ERadioGardenStatus::UnknownError;
-        Response.bSuccessful = false;
+        const FRadioGardenPlacesClusters::FVisibleRegion Region(View.Center.Latitude, View.Center.Longitude, View.VisibleRadiusKm, View.FrustumPlanes);
 
-        if (ChannelsCount <= 0)
+        if (View.ZoomLevel > FRadioGardenPlacesClusters::MaxZoomLevel)
         {
-            Response.Status = ERadioGardenStatus::InvalidResponse;
-            Response.ErrorMessage = TEXT("Channels count must be positive");
-            AsyncTask(ENamedThreads::GameThread, [Response, OnCompleted]()
+            TArray<FRadioGardenPlacesIndex::FNearestPlace> VisiblePlaces;
+            FRadioGardenPlacesIndex::FindWithinRadius(FRadioGardenPlacesCatalog::Get().GetIndex(Places),
+                View.Center.Latitude, View.Center.Longitude, View.VisibleRadiusKm, VisiblePlaces);
+
+            for (const FRadioGardenPlacesIndex::FNearestPlace& VisiblePlace : VisiblePlaces)
             {
-                OnCompleted.ExecuteIfBound(Response);
-            });
+                const FRadioGardenCoords& Geo = Places->Places[VisiblePlace.PlaceIndex].Geo;
+                if (Region.Contains(FRadioGardenPlacesIndex::ToUnitVector(Geo.Latitude, Geo.Longitude)))
+                {
+                    OutMarkers.Add(MakePlaceMarker(*Places, VisiblePlace.PlaceIndex));
+                }
+            }
             return;
         }
 
-        // Шаг 1: Получаем все места
-        FRadioGardenPlacesResponse PlacesResponse;
-        GetPlaces(PlacesResponse);
+        const int32 Level = FMath::Max(0, View.ZoomLevel);
+        const FRadioGardenPlacesCatalog::FClustersRef Clusters = FRadioGardenPlacesCatalog::Get().GetClusters(Places);
+
+        TArray<const FRadioGardenPlacesClusters::FCluster*> VisibleClusters;
+        Clusters->FindVisible(Level, Region, VisibleClusters);
 
-        if (!PlacesResponse.bSuccessful)
+        OutMarkers.Reserve(VisibleClusters.Num());
+        for (const FRadioGardenPlacesClusters::FCluster* Cluster : VisibleClusters)
         {
-            Response.Status = PlacesResponse.Status;
-            Response.ErrorMessage = PlacesResponse.ErrorMessage;
-            AsyncTask(ENamedThreads::GameThread, [Response, OnCompleted]()
+            // Кластер из одного места - само место, его маркер не меняется при смене уровня
+            FRadioGardenGlobeMarker& Marker = OutMarkers.Add_GetRef(MakePlaceMarker(*Places, Cluster->RepresentativePlace));
+            if (Cluster->PlaceCount == 1)
             {
-                OnCompleted.ExecuteIfBound(Response);
-            });
-            return;
+                continue;
+            }
+
+            Marker.Id = GlobeClusterMarkerFlag | (int64(Level) << 48) | static_cast<int64>(Cluster->CellKey);
+            Marker.bCluster = true;
+            Marker.PlaceCount = Cluster->PlaceCount;
+            Marker.Size = Cluster->TotalSize;
+            Marker.Geo = FRadioGardenCoords(
+                FMath::RadiansToDegrees(FMath::Atan2(Cluster->Center.Y, Cluster->Center.X)),
+                FMath::RadiansToDegrees(FMath::Asin(FMath::Clamp(Cluster->Center.Z, -1.0, 1.0))));
         }
+    }
 
-        // Шаг 2: Вычисляем расстояние до каждого места и сортируем
-        TArray<FPlaceWithDistance> PlacesWithDistance;
-        for (const FRadioGardenPlace& Place : PlacesResponse.Places)
+    void ContinueGlobeView(const FGlobeViewStateRef& State);
+
+    // Рассчитать ожидающий вид и выдать дельту относительно предыдущего набора
+    void ProcessGlobeView(const FGlobeViewStateRef& State, const FRadioGardenPlacesCatalog::FPlacesRef& SharedPlaces)
+    {
+        FRadioGardenGlobeView View;
         {
-            const double Distance = CalculateDistance(Latitude, Longitude, Place.Geo.Latitude, Place.Geo.Longitude);
-            PlacesWithDistance.Add(FPlaceWithDistance(Place, Distance));
-        }
+            FScopeLock Lock(&State->CriticalSection);
+
+            if (State->bReleased || !State->PendingView.IsSet())
+            {
+                State->bProcessing = false;
+                return;
+            }
 
-        PlacesWithDistance.Sort();
+            View = MoveTemp(State->PendingView.GetValue());
+            State->PendingView.Reset();
+        }
 
-        // Шаг 3: Собираем каналы, начиная с ближайших мест
-        TArray<FRadioGardenChannelWithDistance> AllChannels;
-        int32 ChannelsNeeded = ChannelsCount;
+        FRadioGardenGlobeViewResponse Response;
+        Response.ZoomLevel = View.ZoomLevel;
 
-        for (const FPlaceWithDistance& PlaceWithDist : PlacesWithDistance)
+        if (SharedPlaces->bSuccessful)
         {
-            if (ChannelsNeeded <= 0)
+            TArray<FRadioGardenGlobeMarker> Markers;
+            CollectGlobeMarkers(SharedPlaces, View, Markers);
+
+            // Сменилась версия каталога: индексы мест и состав кластеров другие, набор выдаётся заново
+            Response.bReset = State->Places.IsValid() && State->Places.Get() != &SharedPlaces.Get();
+            if (Response.bReset)
             {
-                break;
+                State->VisibleMarkers.Reset();
             }
 
-            FRadioGardenChannelsResponse ChannelsResponse;
-            GetPlaceChannels(PlaceWithDist.Place.Id, ChannelsResponse);
-
-            if (ChannelsResponse.bSuccessful)
+            TSet<int64> VisibleMarkers;
+            VisibleMarkers.Reserve(Markers.Num());
+            for (FRadioGardenGlobeMarker& Marker : Markers)
             {
-                const FString BaseUrl = GetBaseUrl();
-                for (const FRadioGardenChannel& Channel : ChannelsResponse.Channels)
+                VisibleMarkers.Add(Marker.Id);
+                if (!State->VisibleMarkers.Contains(Marker.Id))
                 {
-                    FRadioGardenChannelWithDistance ChannelWithDist;
-                    ChannelWithDist.Title = Channel.Title;
-                    ChannelWithDist.Distance = PlaceWithDist.Distance;
-
-                    // Формируем URL потока: https://radio.garden/api/ara/content/listen/ChannelId/channel.mp3
-                    if (!Channel.Id.IsEmpty())
-                    {
-                        ChannelWithDist.Url = FString::Printf(TEXT("%s/ara/content/listen/%s/channel.mp3"), *BaseUrl, *Channel.Id);
-                    }
-
-                    AllChannels.Add(ChannelWithDist);
+                    Response.Added.Add(MoveTemp(Marker));
                 }
+            }
 
-                ChannelsNeeded -= ChannelsResponse.Channels.Num();
+            for (const int64 MarkerId : State->VisibleMarkers)
+            {
+                if (!VisibleMarkers.Contains(MarkerId))
+                {
+                    Response.Removed.Add(MarkerId);
+                }
             }
-        }
 
-        if (AllChannels.Num() == 0)
+            State->VisibleMarkers = MoveTemp(VisibleMarkers);
+            State->Places = SharedPlaces;
+
+            Response.VisibleCount = State->VisibleMarkers.Num();
+            Response.Status = ERadioGardenStatus::Success;
+            Response.bSuccessful = true;
+        }
+        else
         {
-            Response.Status = ERadioGardenStatus::InvalidResponse;
-            Response.ErrorMessage = TEXT("No channels found");
-            AsyncTask(ENamedThreads::GameThread, [Response, OnCompleted]()
-            {
-                OnCompleted.ExecuteIfBound(Response);
-            });
-            return;
+            // Прежний набор остаётся выданным, следующая дельта считается от него
+            Response.Status = SharedPlaces->Status;
+            Response.ErrorMessage = SharedPlaces->ErrorMessage;
+            Response.HttpResponseCode = SharedPlaces->HttpResponseCode;
+            Response.VisibleCount = State->VisibleMarkers.Num();
+            Response.bSuccessful = false;
         }
 
-        // Шаг 4: Сортируем каналы по расстоянию и ограничиваем количество
-        AllChannels.Sort([](const FRadioGardenChannelWithDistance& A, const FRadioGardenChannelWithDistance& B)
+        bool bContinue = false;
         {
-            return A.Distance < B.Distance;
-        });
+            // Выдача под блокировкой, чтобы после ReleaseGlobeView делегат больше не вызывался
+            FScopeLock Lock(&State->CriticalSection);
 
-        // Берем только нужное количество
-        if (AllChannels.Num() > ChannelsCount)
-        {
-            AllChannels.SetNum(ChannelsCount);
+            if (!State->bReleased)
+            {
+                DispatchToGameThread(State->OnUpdated, MoveTemp(Response));
+            }
+
+            bContinue = !State->bReleased && State->PendingView.IsSet();
+            State->bProcessing = bContinue;
         }
 
-        Response.Channels = AllChannels;
-        Response.Status = ERadioGardenStatus::Success;
-        Response.bSuccessful = true;
+        if (bContinue)
+        {
+            ContinueGlobeView(State);
+        }
+    }
 
-        AsyncTask(ENamedThreads::GameThread, [Response, OnCompleted]()
+    void ContinueGlobeView(const FGlobeViewStateRef& State)
+    {
+        FetchPlaces(nullptr, [State](const FRadioGardenPlacesCatalog::FPlacesRef& SharedPlaces)
         {
-            OnCompleted.ExecuteIfBound(Response);
+            ProcessGlobeView(State, SharedPlaces);
         });
-    });
+    }
+
+    TSharedPtr<FGlobeViewState, ESPMode::ThreadSafe> FindGlobeView(const FRadioGardenGlobeViewHandle& Handle)
+    {
+        FScopeLock Lock(&GlobeViewsCriticalSection);
+        const FGlobeViewStateRef* State = GlobeViews.Find(Handle.Id);
+        return State ? TSharedPtr<FGlobeViewState, ESPMode::ThreadSafe>(*State) : nullptr;
+    }
 }
 
-void IRadioGardenAPI::GetNearbyChannelsByGeolocationAsync(int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted)
+FRadioGardenGlobeViewHandle IRadioGardenAPI::CreateGlobeView(const FOnRadioGardenGlobeViewUpdated& OnUpdated)
 {
-    // Сначала получаем геолокацию, затем вызываем GetNearbyChannelsAsync
-    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [ChannelsCount, OnCompleted]()
+    const FGlobeViewStateRef State = MakeShared<FGlobeViewState, ESPMode::ThreadSafe>();
+    State->OnUpdated = OnUpdated;
+
+    FRadioGardenGlobeViewHandle Handle;
+    FScopeLock Lock(&GlobeViewsCriticalSection);
+    Handle.Id = NextGlobeViewId++;
+    GlobeViews.Add(Handle.Id, State);
+    return Handle;
+}
+
+void IRadioGardenAPI::UpdateGlobeView(const FRadioGardenGlobeViewHandle& Handle, const FRadioGardenGlobeView& View)
+{
+    const TSharedPtr<FGlobeViewState, ESPMode::ThreadSafe> State = FindGlobeView(Handle);
+    if (!State.IsValid())
+    {
+        UE_LOG(LogRadioGardenAPI, Warning, TEXT("UpdateGlobeView: unknown globe view %d"), Handle.Id);
+        return;
+    }
+
+    bool bStart = false;
     {
-        FRadioGardenGeolocationResponse GeoResponse;
-        GetGeolocation(GeoResponse);
+        FScopeLock Lock(&State->CriticalSection);
+        State->PendingView = View;
+        bStart = !State->bProcessing;
+        State->bProcessing = true;
+    }
 
-        if (!GeoResponse.bSuccessful)
+    if (bStart)
+    {
+        ContinueGlobeView(State.ToSharedRef());
+    }
+}
+
+void IRadioGardenAPI::ReleaseGlobeView(const FRadioGardenGlobeViewHandle& Handle)
+{
+    TSharedPtr<FGlobeViewState, ESPMode::ThreadSafe> State;
+    {
+        FScopeLock Lock(&GlobeViewsCriticalSection);
+        if (const FGlobeViewStateRef* Found = GlobeViews.Find(Handle.Id))
         {
-            FRadioGardenNearbyChannelsResponse Response;
-            Response.Status = GeoResponse.Status;
-            Response.ErrorMessage = GeoResponse.ErrorMessage;
-            Response.bSuccessful = false;
+            State = *Found;
+            GlobeViews.Remove(Handle.Id);
+        }
+    }
+
+    if (State.IsValid())
+    {
+        FScopeLock Lock(&State->CriticalSection);
+        State->bReleased = true;
+        State->PendingView.Reset();
+    }
+}
 
-            AsyncTask(ENamedThreads::GameThread, [Response, OnCompleted]()
+// ========== Prefetch (Упреждение) ==========
+
+void IRadioGardenAPI::UpdatePrefetchTrajectory(double Latitude, double Longitude, const FVector2D& VelocityKmPerSecond)
+{
+    FRadioGardenPrefetcher::Get().UpdateTrajectory(Latitude, Longitude, VelocityKmPerSecond,
+        [](const FString& PlaceId, TFunction<void(const FRadioGardenChannelsResponse&)>&& OnFetched)
+        {
+            ExecutePlaceChannels(PlaceId, ERadioGardenRequestPriority::Background, nullptr, [OnFetched = MoveTemp(OnFetched)](const TSharedRef<const FRadioGardenChannelsResponse, ESPMode::ThreadSafe>& Response)
             {
-                OnCompleted.ExecuteIfBound(Response);
+                OnFetched(*Response);
             });
-            return;
-        }
-
-        // Используем координаты из геолокации
-        const double Latitude = GeoResponse.Geolocation.Latitude;
-        const double Longitude = GeoResponse.Geolocation.Longitude;
+        });
+}
 
-        // Вызываем GetNearbyChannelsAsync с полученными координатами
-        // Внимание: этот вызов создаст еще один AsyncTask, что нормально
-        GetNearbyChannelsAsync(Latitude, Longitude, ChannelsCount, OnCompleted);
-    });
+void IRadioGardenAPI::StopPrefetch()
+{
+    FRadioGardenPrefetcher::Get().Stop();
 }
 
 // ========== Utility ==========
@@ -729,5 +2249,21 @@ bool IRadioGardenAPI::IsValidId(const FString& Id)
 
 FString IRadioGardenAPI::GetBaseUrl()
 {
-    return FRadioGardenHttpRequest::BaseUrl;
+    return FRadioGardenHttpRequest::GetBaseUrl();
+}
+
+FRadioGardenRequestStats IRadioGardenAPI::GetRequestStats()
+{
+    return FRadioGardenStats::GetSnapshot();
+}
+
+void IRadioGardenAPI::ResetRequestStats()
+{
+    FRadioGardenStats::Reset();
+}
+
+void IRadioGardenAPI::ClearResponseCache()
+{
+    FRadioGardenResponseCache::Get().Empty();
+    NearbyResults.Empty();
 }
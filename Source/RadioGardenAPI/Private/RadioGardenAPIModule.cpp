@@ -2,6 +2,10 @@
 
 #include "RadioGardenAPIModule.h"
 #include "RadioGardenTypes.h"
+#include "RadioGardenPlacesCatalog.h"
+#include "RadioGardenPrefetcher.h"
+#include "RadioGardenScheduler.h"
+#include "Async/Async.h"
 
 DEFINE_LOG_CATEGORY(LogRadioGardenAPI);
 
@@ -11,11 +15,20 @@ void FRadioGardenAPIModule::StartupModule()
 {
     // Инициализация модуля
     UE_LOG(LogRadioGardenAPI, Log, TEXT("Radio Garden API Module started"));
+
+    // Заранее поднимаем снимок каталога мест с диска, чтобы первый запрос мест не ждал сеть
+    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, []()
+    {
+        FRadioGardenPlacesCatalog::Get().GetPlaces();
+    });
 }
 
 void FRadioGardenAPIModule::ShutdownModule()
 {
-    // Очистка модуля
+    // Очистка модуля: тикеры и фоновые задачи синглтонов не должны пережить код модуля
+    FRadioGardenPrefetcher::Get().Shutdown();
+    FRadioGardenRequestScheduler::Get().Shutdown();
+
     UE_LOG(LogRadioGardenAPI, Log, TEXT("Radio Garden API Module shutdown"));
 }
 
@@ -5,45 +5,50 @@
 
 // ========== Places (Места) ==========
 
-void URadioGardenBlueprintFunctionLibrary::GetPlaces(const FOnRadioGardenPlacesReceived& OnCompleted)
+FRadioGardenRequestHandle URadioGardenBlueprintFunctionLibrary::GetPlaces(const FOnRadioGardenPlacesReceived& OnCompleted)
 {
-    IRadioGardenAPI::GetPlacesAsync(OnCompleted);
+    return IRadioGardenAPI::GetPlacesAsync(OnCompleted);
 }
 
-void URadioGardenBlueprintFunctionLibrary::GetPlaceDetails(const FString& PlaceId, const FOnRadioGardenPlacesReceived& OnCompleted)
+FRadioGardenRequestHandle URadioGardenBlueprintFunctionLibrary::GetPlaceDetails(const FString& PlaceId, const FOnRadioGardenPlacesReceived& OnCompleted)
 {
-    IRadioGardenAPI::GetPlaceDetailsAsync(PlaceId, OnCompleted);
+    return IRadioGardenAPI::GetPlaceDetailsAsync(PlaceId, OnCompleted);
 }
 
-void URadioGardenBlueprintFunctionLibrary::GetPlaceChannels(const FString& PlaceId, const FOnRadioGardenChannelsReceived& OnCompleted)
+FRadioGardenRequestHandle URadioGardenBlueprintFunctionLibrary::GetPlaceChannels(const FString& PlaceId, const FOnRadioGardenChannelsReceived& OnCompleted)
 {
-    IRadioGardenAPI::GetPlaceChannelsAsync(PlaceId, OnCompleted);
+    return IRadioGardenAPI::GetPlaceChannelsAsync(PlaceId, OnCompleted);
 }
 
 // ========== Channels (Станции) ==========
 
-void URadioGardenBlueprintFunctionLibrary::GetChannel(const FString& ChannelId, const FOnRadioGardenChannelReceived& OnCompleted)
+FRadioGardenRequestHandle URadioGardenBlueprintFunctionLibrary::GetChannel(const FString& ChannelId, const FOnRadioGardenChannelReceived& OnCompleted)
 {
-    IRadioGardenAPI::GetChannelAsync(ChannelId, OnCompleted);
+    return IRadioGardenAPI::GetChannelAsync(ChannelId, OnCompleted);
 }
 
-void URadioGardenBlueprintFunctionLibrary::GetChannelStreamUrl(const FString& ChannelId, const FOnRadioGardenStreamUrlReceived& OnCompleted)
+FRadioGardenRequestHandle URadioGardenBlueprintFunctionLibrary::GetChannelStreamUrl(const FString& ChannelId, const FOnRadioGardenStreamUrlReceived& OnCompleted)
 {
-    IRadioGardenAPI::GetChannelStreamUrlAsync(ChannelId, OnCompleted);
+    return IRadioGardenAPI::GetChannelStreamUrlAsync(ChannelId, OnCompleted);
 }
 
 // ========== Search (Поиск) ==========
 
-void URadioGardenBlueprintFunctionLibrary::Search(const FString& Query, const FOnRadioGardenSearchCompleted& OnCompleted)
+FRadioGardenRequestHandle URadioGardenBlueprintFunctionLibrary::Search(const FString& Query, const FOnRadioGardenSearchCompleted& OnCompleted)
 {
-    IRadioGardenAPI::SearchAsync(Query, OnCompleted);
+    return IRadioGardenAPI::SearchAsync(Query, OnCompleted);
 }
 
 // ========== Geo (Геолокация) ==========
 
-void URadioGardenBlueprintFunctionLibrary::GetGeolocation(const FOnRadioGardenGeolocationReceived& OnCompleted)
+FRadioGardenRequestHandle URadioGardenBlueprintFunctionLibrary::GetGeolocation(const FOnRadioGardenGeolocationReceived& OnCompleted)
 {
-    IRadioGardenAPI::GetGeolocationAsync(OnCompleted);
+    return IRadioGardenAPI::GetGeolocationAsync(OnCompleted);
+}
+
+void URadioGardenBlueprintFunctionLibrary::ForgetSessionGeolocation()
+{
+    IRadioGardenAPI::ForgetSessionGeolocation();
 }
 
 // ========== Utility ==========
@@ -68,12 +73,77 @@ FString URadioGardenBlueprintFunctionLibrary::CoordsToString(const FRadioGardenC
     return FString::Printf(TEXT("%.6f,%.6f"), Coords.Latitude, Coords.Longitude);
 }
 
-void URadioGardenBlueprintFunctionLibrary::GetNearbyChannels(double Latitude, double Longitude, int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted)
+FRadioGardenRequestStats URadioGardenBlueprintFunctionLibrary::GetRequestStats()
+{
+    return IRadioGardenAPI::GetRequestStats();
+}
+
+FRadioGardenRequestHandle URadioGardenBlueprintFunctionLibrary::GetNearbyChannels(double Latitude, double Longitude, int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds)
+{
+    return IRadioGardenAPI::GetNearbyChannelsAsync(Latitude, Longitude, ChannelsCount, OnCompleted, DeadlineSeconds);
+}
+
+FRadioGardenRequestHandle URadioGardenBlueprintFunctionLibrary::GetNearbyChannelsStream(double Latitude, double Longitude, int32 ChannelsCount, const FOnRadioGardenNearbyChannelsBatch& OnBatch, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds)
+{
+    return IRadioGardenAPI::GetNearbyChannelsStreamAsync(Latitude, Longitude, ChannelsCount, OnBatch, OnCompleted, DeadlineSeconds);
+}
+
+FRadioGardenRequestHandle URadioGardenBlueprintFunctionLibrary::GetNearbyChannelsMulti(const TArray<FRadioGardenNearbyQuery>& Queries, const FOnRadioGardenNearbyChannelsMultiReceived& OnCompleted, float DeadlineSeconds)
+{
+    return IRadioGardenAPI::GetNearbyChannelsMultiAsync(Queries, OnCompleted, DeadlineSeconds);
+}
+
+FRadioGardenRequestHandle URadioGardenBlueprintFunctionLibrary::GetNearbyChannelsByGeolocation(int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds)
+{
+    return IRadioGardenAPI::GetNearbyChannelsByGeolocationAsync(ChannelsCount, OnCompleted, DeadlineSeconds);
+}
+
+FRadioGardenRequestHandle URadioGardenBlueprintFunctionLibrary::GetPlacesInArea(const FRadioGardenGeoArea& Area, const FOnRadioGardenPlacesReceived& OnCompleted)
+{
+    return IRadioGardenAPI::GetPlacesInAreaAsync(Area, OnCompleted);
+}
+
+FRadioGardenRequestHandle URadioGardenBlueprintFunctionLibrary::GetChannelsInArea(const FRadioGardenGeoArea& Area, int32 MaxChannels, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds)
+{
+    return IRadioGardenAPI::GetChannelsInAreaAsync(Area, MaxChannels, OnCompleted, DeadlineSeconds);
+}
+
+FRadioGardenRequestHandle URadioGardenBlueprintFunctionLibrary::GetPlacesAlongRoute(const FRadioGardenRoute& Route, const FOnRadioGardenPlacesReceived& OnCompleted)
+{
+    return IRadioGardenAPI::GetPlacesAlongRouteAsync(Route, OnCompleted);
+}
+
+FRadioGardenRequestHandle URadioGardenBlueprintFunctionLibrary::GetChannelsAlongRoute(const FRadioGardenRoute& Route, int32 MaxChannels, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds)
+{
+    return IRadioGardenAPI::GetChannelsAlongRouteAsync(Route, MaxChannels, OnCompleted, DeadlineSeconds);
+}
+
+void URadioGardenBlueprintFunctionLibrary::CancelRequest(const FRadioGardenRequestHandle& Handle)
+{
+    IRadioGardenAPI::CancelRequest(Handle);
+}
+
+FRadioGardenGlobeViewHandle URadioGardenBlueprintFunctionLibrary::CreateGlobeView(const FOnRadioGardenGlobeViewUpdated& OnUpdated)
+{
+    return IRadioGardenAPI::CreateGlobeView(OnUpdated);
+}
+
+void URadioGardenBlueprintFunctionLibrary::UpdateGlobeView(const FRadioGardenGlobeViewHandle& Handle, const FRadioGardenGlobeView& View)
+{
+    IRadioGardenAPI::UpdateGlobeView(Handle, View);
+}
+
+void URadioGardenBlueprintFunctionLibrary::ReleaseGlobeView(const FRadioGardenGlobeViewHandle& Handle)
+{
+    IRadioGardenAPI::ReleaseGlobeView(Handle);
+}
+
+void URadioGardenBlueprintFunctionLibrary::UpdatePrefetchTrajectory(double Latitude, double Longitude, const FVector2D& VelocityKmPerSecond)
 {
-    IRadioGardenAPI::GetNearbyChannelsAsync(Latitude, Longitude, ChannelsCount, OnCompleted);
+    IRadioGardenAPI::UpdatePrefetchTrajectory(Latitude, Longitude, VelocityKmPerSecond);
 }
 
-void URadioGardenBlueprintFunctionLibrary::GetNearbyChannelsByGeolocation(int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted)
+void URadioGardenBlueprintFunctionLibrary::StopPrefetch()
 {
-    IRadioGardenAPI::GetNearbyChannelsByGeolocationAsync(ChannelsCount, OnCompleted);
+    IRadioGardenAPI::StopPrefetch();
 }
@@ -0,0 +1,74 @@
+// by Neil Moore
+
+#include "RadioGardenCancellation.h"
+#include "Misc/ScopeLock.h"
+
+FRadioGardenCancellationRef FRadioGardenCancellationToken::MakeChild(const FRadioGardenCancellationRef& Parent)
+{
+    const FRadioGardenCancellationRef Child = MakeShared<FRadioGardenCancellationToken, ESPMode::ThreadSafe>();
+
+    // Родитель не продлевает жизнь дочернему токену
+    Parent->OnCancelled([WeakChild = TWeakPtr<FRadioGardenCancellationToken, ESPMode::ThreadSafe>(Child)]()
+    {
+        if (const FRadioGardenCancellationPtr PinnedChild = WeakChild.Pin())
+        {
+            PinnedChild->Cancel();
+        }
+    });
+
+    return Child;
+}
+
+bool FRadioGardenCancellationToken::Cancel()
+{
+    TArray<TPair<int32, FCallback>> LocalCallbacks;
+    {
+        FScopeLock Lock(&CriticalSection);
+
+        if (bCancelled.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        bCancelled.store(true, std::memory_order_release);
+        LocalCallbacks = MoveTemp(Callbacks);
+    }
+
+    // Подписчики вызываются без блокировки: они могут отменять другие токены и отписываться
+    for (TPair<int32, FCallback>& Callback : LocalCallbacks)
+    {
+        Callback.Value();
+    }
+    return true;
+}
+
+int32 FRadioGardenCancellationToken::OnCancelled(FCallback&& Callback)
+{
+    {
+        FScopeLock Lock(&CriticalSection);
+
+        if (!bCancelled.load(std::memory_order_relaxed))
+        {
+            const int32 CallbackId = NextCallbackId++;
+            Callbacks.Emplace(CallbackId, MoveTemp(Callback));
+            return CallbackId;
+        }
+    }
+
+    Callback();
+    return 0;
+}
+
+void FRadioGardenCancellationToken::RemoveOnCancelled(int32 CallbackId)
+{
+    if (CallbackId == 0)
+    {
+        return;
+    }
+
+    FScopeLock Lock(&CriticalSection);
+    Callbacks.RemoveAll([CallbackId](const TPair<int32, FCallback>& Callback)
+    {
+        return Callback.Key == CallbackId;
+    });
+}
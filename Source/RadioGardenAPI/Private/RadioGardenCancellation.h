@@ -0,0 +1,63 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+class FRadioGardenCancellationToken;
+
+using FRadioGardenCancellationRef = TSharedRef<FRadioGardenCancellationToken, ESPMode::ThreadSafe>;
+using FRadioGardenCancellationPtr = TSharedPtr<FRadioGardenCancellationToken, ESPMode::ThreadSafe>;
+
+/**
+ * Токен отмены асинхронного вызова
+ * Отмена однократна: подписчики вызываются один раз в потоке, вызвавшем Cancel.
+ * Слои запроса проверяют токен и подписываются на него: планировщик снимает ожидающий запрос,
+ * HTTP запрос прерывается, разбор ответа и делегат пропускаются
+ */
+class FRadioGardenCancellationToken
+{
+public:
+    using FCallback = TUniqueFunction<void()>;
+
+    /**
+     * Создать токен, который отменяется вместе с родительским (но может быть отменён и сам по себе)
+     */
+    static FRadioGardenCancellationRef MakeChild(const FRadioGardenCancellationRef& Parent);
+
+    /**
+     * Отменён ли вызов
+     */
+    bool IsCancelled() const
+    {
+        return bCancelled.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Отменить вызов и оповестить подписчиков
+     * @return false если вызов уже был отменён
+     */
+    bool Cancel();
+
+    /**
+     * Подписаться на отмену; если вызов уже отменён, Callback вызывается сразу
+     * Подписчик не должен удерживать сам токен, иначе токен не освободится до отмены
+     * @return Идентификатор подписки (0 если Callback уже вызван)
+     */
+    int32 OnCancelled(FCallback&& Callback);
+
+    /**
+     * Отписаться от отмены; уже начавшийся вызов подписчика не прерывается
+     */
+    void RemoveOnCancelled(int32 CallbackId);
+
+private:
+    std::atomic<bool> bCancelled{false};
+
+    /** Подписчики с их идентификаторами */
+    TArray<TPair<int32, FCallback>> Callbacks;
+    int32 NextCallbackId = 1;
+
+    FCriticalSection CriticalSection;
+};
@@ -0,0 +1,375 @@
+// by Neil Moore
+
+#include "RadioGardenGeoArea.h"
+
+namespace
+{
+    // Отрезок долгот [West, East], не пересекающий 180-й меридиан
+    struct FGeoLongitudeRange
+    {
+        double West;
+        double East;
+    };
+
+    // Разбить диапазон долгот на отрезки: прямоугольник через 180-й меридиан даёт два
+    int32 GetLongitudeRanges(double West, double East, FGeoLongitudeRange OutRanges[2])
+    {
+        West = FMath::UnwindDegrees(West);
+        East = FMath::UnwindDegrees(East);
+
+        if (West <= East)
+        {
+            OutRanges[0] = { West, East };
+            return 1;
+        }
+
+        OutRanges[0] = { West, 180.0 };
+        OutRanges[1] = { -180.0, East };
+        return 2;
+    }
+
+    bool IsLongitudeInRanges(double Longitude, const FGeoLongitudeRange* Ranges, int32 RangeCount)
+    {
+        Longitude = FMath::UnwindDegrees(Longitude);
+        for (int32 RangeIndex = 0; RangeIndex < RangeCount; ++RangeIndex)
+        {
+            if (Longitude >= Ranges[RangeIndex].West && Longitude <= Ranges[RangeIndex].East)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Параллелепипед, содержащий единичные векторы всех точек прямоугольника [South, North] x Range.
+    // z = sin(lat), x и y - произведения cos(lat) на cos(lon) и sin(lon), диапазоны которых
+    // берутся по концам отрезков и экстремумам внутри них
+    FBox MakeGeoBoundsBox(double South, double North, const FGeoLongitudeRange& Range)
+    {
+        const double SouthRad = FMath::DegreesToRadians(South);
+        const double NorthRad = FMath::DegreesToRadians(North);
+        const double WestRad = FMath::DegreesToRadians(Range.West);
+        const double EastRad = FMath::DegreesToRadians(Range.East);
+
+        const double CosMin = FMath::Min(FMath::Cos(SouthRad), FMath::Cos(NorthRad));
+        const double CosMax = South <= 0.0 && North >= 0.0 ? 1.0 : FMath::Max(FMath::Cos(SouthRad), FMath::Cos(NorthRad));
+
+        double CosLonMin = FMath::Min(FMath::Cos(WestRad), FMath::Cos(EastRad));
+        double CosLonMax = FMath::Max(FMath::Cos(WestRad), FMath::Cos(EastRad));
+        double SinLonMin = FMath::Min(FMath::Sin(WestRad), FMath::Sin(EastRad));
+        double SinLonMax = FMath::Max(FMath::Sin(WestRad), FMath::Sin(EastRad));
+
+        if (Range.West <= 0.0 && Range.East >= 0.0)
+        {
+            CosLonMax = 1.0;
+        }
+        if (Range.West <= -180.0 || Range.East >= 180.0)
+        {
+            CosLonMin = -1.0;
+        }
+        if (Range.West <= 90.0 && Range.East >= 90.0)
+        {
+            SinLonMax = 1.0;
+        }
+        if (Range.West <= -90.0 && Range.East >= -90.0)
+        {
+            SinLonMin = -1.0;
+        }
+
+        // cos(lat) неотрицателен, поэтому крайние значения произведения дают концы его диапазона
+        const FVector Min(
+            FMath::Min(CosMin * CosLonMin, CosMax * CosLonMin),
+            FMath::Min(CosMin * SinLonMin, CosMax * SinLonMin),
+            FMath::Sin(SouthRad));
+        const FVector Max(
+            FMath::Max(CosMin * CosLonMax, CosMax * CosLonMax),
+            FMath::Max(CosMin * SinLonMax, CosMax * SinLonMax),
+            FMath::Sin(NorthRad));
+
+        return FBox(Min, Max).ExpandBy(FRadioGardenPlacesIndex::BoxPadding);
+    }
+
+    // Многоугольник с непрерывными долготами: соседние вершины отличаются не больше чем на 180 градусов,
+    // поэтому многоугольник через 180-й меридиан остаётся обычным многоугольником на плоскости
+    struct FGeoUnwrappedPolygon
+    {
+        TArray<FVector2D> Vertices;
+        double MinLongitude = 0.0;
+        double MaxLongitude = 0.0;
+        double MinLatitude = 0.0;
+        double MaxLatitude = 0.0;
+    };
+
+    // false - многоугольник охватывает полюс (при обходе долгота набирает полный оборот)
+    bool UnwrapPolygon(const TArray<FRadioGardenCoords>& Polygon, FGeoUnwrappedPolygon& OutPolygon)
+    {
+        OutPolygon.Vertices.Reset(Polygon.Num());
+
+        double Longitude = FMath::UnwindDegrees(Polygon[0].Longitude);
+        OutPolygon.MinLongitude = OutPolygon.MaxLongitude = Longitude;
+        OutPolygon.MinLatitude = OutPolygon.MaxLatitude = Polygon[0].Latitude;
+        OutPolygon.Vertices.Emplace(Longitude, Polygon[0].Latitude);
+
+        for (int32 VertexIndex = 1; VertexIndex < Polygon.Num(); ++VertexIndex)
+        {
+            Longitude += FMath::UnwindDegrees(Polygon[VertexIndex].Longitude - Polygon[VertexIndex - 1].Longitude);
+            const double Latitude = Polygon[VertexIndex].Latitude;
+
+            OutPolygon.Vertices.Emplace(Longitude, Latitude);
+            OutPolygon.MinLongitude = FMath::Min(OutPolygon.MinLongitude, Longitude);
+            OutPolygon.MaxLongitude = FMath::Max(OutPolygon.MaxLongitude, Longitude);
+            OutPolygon.MinLatitude = FMath::Min(OutPolygon.MinLatitude, Latitude);
+            OutPolygon.MaxLatitude = FMath::Max(OutPolygon.MaxLatitude, Latitude);
+        }
+
+        // Замыкающее ребро должно вернуть обход к первой вершине
+        const double Closed = Longitude + FMath::UnwindDegrees(Polygon[0].Longitude - Polygon.Last().Longitude);
+        return FMath::Abs(Closed - OutPolygon.Vertices[0].X) < 180.0;
+    }
+
+    // Чётно-нечётная проверка луча; долгота точки сдвигается на оборот в диапазон многоугольника
+    bool UnwrappedPolygonContains(const FGeoUnwrappedPolygon& Polygon, double Latitude, double Longitude)
+    {
+        // Развёрнутые долготы могут выходить за [-180, 180] в обе стороны (обход с запада через 180-й меридиан
+        // даёт, например, [-190, -170]), поэтому точка приводится к обороту [MinLongitude, MinLongitude + 360)
+        const double X = Polygon.MinLongitude + FMath::Fmod(FMath::UnwindDegrees(Longitude) - Polygon.MinLongitude + 720.0, 360.0);
+        if (X > Polygon.MaxLongitude || Latitude < Polygon.MinLatitude || Latitude > Polygon.MaxLatitude)
+        {
+            return false;
+        }
+
+        bool bInside = false;
+        const TArray<FVector2D>& Vertices = Polygon.Vertices;
+        for (int32 Current = 0, Previous = Vertices.Num() - 1; Current < Vertices.Num(); Previous = Current++)
+        {
+            const FVector2D& A = Vertices[Current];
+            const FVector2D& B = Vertices[Previous];
+            if ((A.Y > Latitude) != (B.Y > Latitude)
+                && X < A.X + (Latitude - A.Y) * (B.X - A.X) / (B.Y - A.Y))
+            {
+                bInside = !bInside;
+            }
+        }
+        return bInside;
+    }
+
+    bool IsValidLatitude(double Latitude)
+    {
+        return Latitude >= -90.0 && Latitude <= 90.0;
+    }
+
+    // Отобрать индексом места из прямоугольника и оставить прошедшие точную проверку
+    template <typename PredicateType>
+    void FindPlacesInBounds(const FRadioGardenPlacesIndex& Index, double South, double North,
+        const FGeoLongitudeRange* Ranges, int32 RangeCount, PredicateType&& Predicate, TArray<int32>& OutPlaceIndices)
+    {
+        TArray<int32> Candidates;
+        for (int32 RangeIndex = 0; RangeIndex < RangeCount; ++RangeIndex)
+        {
+            Index.FindInBox(MakeGeoBoundsBox(South, North, Ranges[RangeIndex]), Candidates);
+        }
+
+        // Точки на 180-м меридиане попадают в оба отрезка
+        Candidates.Sort();
+
+        const TArray<FRadioGardenPlace>& Places = Index.GetPlaces().Places;
+        for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); ++CandidateIndex)
+        {
+            const int32 PlaceIndex = Candidates[CandidateIndex];
+            if (CandidateIndex > 0 && Candidates[CandidateIndex - 1] == PlaceIndex)
+            {
+                continue;
+            }
+
+            const FRadioGardenCoords& Geo = Places[PlaceIndex].Geo;
+            if (Predicate(Geo.Latitude, Geo.Longitude))
+            {
+                OutPlaceIndices.Add(PlaceIndex);
+            }
+        }
+    }
+}
+
+bool FRadioGardenGeoAreaQuery::Validate(const FRadioGardenGeoArea& Area, FString& OutError)
+{
+    switch (Area.Shape)
+    {
+    case ERadioGardenGeoAreaShape::Radius:
+        if (!IsValidLatitude(Area.Center.Latitude) || Area.RadiusKm <= 0.0)
+        {
+            OutError = TEXT("Area radius must be positive and center latitude within [-90, 90]");
+            return false;
+        }
+        return true;
+
+    case ERadioGardenGeoAreaShape::Bounds:
+        if (!IsValidLatitude(Area.SouthWest.Latitude) || !IsValidLatitude(Area.NorthEast.Latitude)
+            || Area.SouthWest.Latitude > Area.NorthEast.Latitude)
+        {
+            OutError = TEXT("Area bounds must have South <= North within [-90, 90]");
+            return false;
+        }
+        return true;
+
+    case ERadioGardenGeoAreaShape::Polygon:
+    {
+        if (Area.Polygon.Num() < 3)
+        {
+            OutError = TEXT("Area polygon must have at least 3 vertices");
+            return false;
+        }
+
+        for (const FRadioGardenCoords& Vertex : Area.Polygon)
+        {
+            if (!IsValidLatitude(Vertex.Latitude))
+            {
+                OutError = TEXT("Area polygon latitudes must be within [-90, 90]");
+                return false;
+            }
+        }
+
+        FGeoUnwrappedPolygon Unwrapped;
+        if (!UnwrapPolygon(Area.Polygon, Unwrapped))
+        {
+            OutError = TEXT("Area polygons around a pole are not supported");
+            return false;
+        }
+        return true;
+    }
+    }
+
+    OutError = TEXT("Unknown area shape");
+    return false;
+}
+
+FRadioGardenCoords FRadioGardenGeoAreaQuery::GetReferencePoint(const FRadioGardenGeoArea& Area)
+{
+    switch (Area.Shape)
+    {
+    case ERadioGardenGeoAreaShape::Bounds:
+    {
+        const double West = FMath::UnwindDegrees(Area.SouthWest.Longitude);
+        const double East = FMath::UnwindDegrees(Area.NorthEast.Longitude);
+        const double Width = West <= East ? East - West : East - West + 360.0;
+        return FRadioGardenCoords(
+            FMath::UnwindDegrees(West + Width * 0.5),
+            (Area.SouthWest.Latitude + Area.NorthEast.Latitude) * 0.5);
+    }
+
+    case ERadioGardenGeoAreaShape::Polygon:
+    {
+        if (Area.Polygon.Num() == 0)
+        {
+            return FRadioGardenCoords();
+        }
+
+        FGeoUnwrappedPolygon Unwrapped;
+        UnwrapPolygon(Area.Polygon, Unwrapped);
+
+        FVector2D Sum = FVector2D::ZeroVector;
+        for (const FVector2D& Vertex : Unwrapped.Vertices)
+        {
+            Sum += Vertex;
+        }
+        const FVector2D Mean = Sum / Unwrapped.Vertices.Num();
+        return FRadioGardenCoords(FMath::UnwindDegrees(Mean.X), Mean.Y);
+    }
+
+    default:
+        return Area.Center;
+    }
+}
+
+bool FRadioGardenGeoAreaQuery::Contains(const FRadioGardenGeoArea& Area, double Latitude, double Longitude)
+{
+    switch (Area.Shape)
+    {
+    case ERadioGardenGeoAreaShape::Radius:
+        return FRadioGardenPlacesCoords::HaversineDistance(Area.Center.Latitude, Area.Center.Longitude, Latitude, Longitude) <= Area.RadiusKm;
+
+    case ERadioGardenGeoAreaShape::Bounds:
+    {
+        FGeoLongitudeRange Ranges[2];
+        const int32 RangeCount = GetLongitudeRanges(Area.SouthWest.Longitude, Area.NorthEast.Longitude, Ranges);
+        return Latitude >= Area.SouthWest.Latitude && Latitude <= Area.NorthEast.Latitude
+            && IsLongitudeInRanges(Longitude, Ranges, RangeCount);
+    }
+
+    case ERadioGardenGeoAreaShape::Polygon:
+    {
+        FGeoUnwrappedPolygon Unwrapped;
+        return Area.Polygon.Num() >= 3 && UnwrapPolygon(Area.Polygon, Unwrapped)
+            && UnwrappedPolygonContains(Unwrapped, Latitude, Longitude);
+    }
+    }
+
+    return false;
+}
+
+void FRadioGardenGeoAreaQuery::FindPlaces(const FIndexRef& Index, const FRadioGardenGeoArea& Area, TArray<FNearestPlace>& OutPlaces)
+{
+    OutPlaces.Reset();
+
+    if (Area.Shape == ERadioGardenGeoAreaShape::Radius)
+    {
+        FRadioGardenPlacesIndex::FindWithinRadius(Index, Area.Center.Latitude, Area.Center.Longitude, Area.RadiusKm, OutPlaces);
+        return;
+    }
+
+    TArray<int32> PlaceIndices;
+    FGeoLongitudeRange Ranges[2];
+
+    if (Area.Shape == ERadioGardenGeoAreaShape::Bounds)
+    {
+        const double South = Area.SouthWest.Latitude;
+        const double North = Area.NorthEast.Latitude;
+        const int32 RangeCount = GetLongitudeRanges(Area.SouthWest.Longitude, Area.NorthEast.Longitude, Ranges);
+
+        FindPlacesInBounds(*Index, South, North, Ranges, RangeCount, [&](double Latitude, double Longitude)
+        {
+            return Latitude >= South && Latitude <= North && IsLongitudeInRanges(Longitude, Ranges, RangeCount);
+        }, PlaceIndices);
+    }
+    else
+    {
+        FGeoUnwrappedPolygon Unwrapped;
+        if (Area.Polygon.Num() < 3 || !UnwrapPolygon(Area.Polygon, Unwrapped))
+        {
+            return;
+        }
+
+        // Кандидаты - описанный прямоугольник многоугольника
+        int32 RangeCount = 1;
+        if (Unwrapped.MaxLongitude - Unwrapped.MinLongitude >= 360.0)
+        {
+            Ranges[0] = { -180.0, 180.0 };
+        }
+        else
+        {
+            RangeCount = GetLongitudeRanges(Unwrapped.MinLongitude, Unwrapped.MaxLongitude, Ranges);
+        }
+
+        FindPlacesInBounds(*Index, Unwrapped.MinLatitude, Unwrapped.MaxLatitude, Ranges, RangeCount, [&Unwrapped](double Latitude, double Longitude)
+        {
+            return UnwrappedPolygonContains(Unwrapped, Latitude, Longitude);
+        }, PlaceIndices);
+    }
+
+    // Расстояния от опорной точки через хорды, как у обхода по удалённости
+    const FRadioGardenCoords Reference = GetReferencePoint(Area);
+    const FVector Query = FRadioGardenPlacesIndex::ToUnitVector(Reference.Latitude, Reference.Longitude);
+    const TArray<FRadioGardenPlace>& Places = Index->GetPlaces().Places;
+
+    OutPlaces.Reserve(PlaceIndices.Num());
+    for (const int32 PlaceIndex : PlaceIndices)
+    {
+        const FRadioGardenCoords& Geo = Places[PlaceIndex].Geo;
+        const FVector Point = FRadioGardenPlacesIndex::ToUnitVector(Geo.Latitude, Geo.Longitude);
+        OutPlaces.Add(FNearestPlace{ PlaceIndex, FRadioGardenPlacesIndex::ChordSquaredToDistance(FVector::DistSquared(Point, Query)) });
+    }
+
+    OutPlaces.Sort([](const FNearestPlace& A, const FNearestPlace& B)
+    {
+        return A.Distance < B.Distance || (A.Distance == B.Distance && A.PlaceIndex < B.PlaceIndex);
+    });
+}
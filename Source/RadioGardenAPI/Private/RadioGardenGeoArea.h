@@ -0,0 +1,46 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RadioGardenTypes.h"
+#include "RadioGardenPlacesIndex.h"
+
+/**
+ * Запросы мест по области (круг, прямоугольник, многоугольник) через пространственный индекс
+ * Прямоугольник и многоугольник сводятся к параллелепипеду в пространстве единичных векторов,
+ * индекс отбирает кандидатов внутри него, затем каждый кандидат проверяется точно
+ */
+class FRadioGardenGeoAreaQuery
+{
+public:
+    using FIndexRef = FRadioGardenPlacesIndex::FIndexRef;
+    using FNearestPlace = FRadioGardenPlacesIndex::FNearestPlace;
+
+    /**
+     * Проверить параметры области
+     * Многоугольник, охватывающий полюс, не поддерживается
+     * @param OutError Описание ошибки
+     * @return true если область корректна
+     */
+    static bool Validate(const FRadioGardenGeoArea& Area, FString& OutError);
+
+    /**
+     * Опорная точка области, от которой считаются расстояния: центр круга, середина прямоугольника
+     * или среднее вершин многоугольника
+     */
+    static FRadioGardenCoords GetReferencePoint(const FRadioGardenGeoArea& Area);
+
+    /**
+     * Проверить, лежит ли точка в области
+     */
+    static bool Contains(const FRadioGardenGeoArea& Area, double Latitude, double Longitude);
+
+    /**
+     * Найти места в области
+     * @param Index Индекс
+     * @param Area Корректная область (см. Validate)
+     * @param OutPlaces Места по возрастанию расстояния от опорной точки
+     */
+    static void FindPlaces(const FIndexRef& Index, const FRadioGardenGeoArea& Area, TArray<FNearestPlace>& OutPlaces);
+};
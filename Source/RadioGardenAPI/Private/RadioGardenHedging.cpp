@@ -0,0 +1,114 @@
+// by Neil Moore
+
+#include "RadioGardenHedging.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+static TAutoConsoleVariable<bool> CVarRadioGardenHedgeEnabled(
+    TEXT("RadioGarden.Hedge.Enabled"),
+    true,
+    TEXT("Дублировать запросы станции и станций места, которые отвечают дольше обычного"));
+
+static TAutoConsoleVariable<float> CVarRadioGardenHedgePercentile(
+    TEXT("RadioGarden.Hedge.Percentile"),
+    95.0f,
+    TEXT("Процентиль недавних задержек, после которого отправляется дубль запроса"));
+
+static TAutoConsoleVariable<float> CVarRadioGardenHedgeBudgetPercent(
+    TEXT("RadioGarden.Hedge.BudgetPercent"),
+    5.0f,
+    TEXT("Наибольшая доля дублей от подходящих запросов (проценты)"));
+
+static TAutoConsoleVariable<int32> CVarRadioGardenHedgeMinSamples(
+    TEXT("RadioGarden.Hedge.MinSamples"),
+    20,
+    TEXT("Сколько задержек класса эндпоинтов нужно накопить, прежде чем дублировать его запросы"));
+
+namespace
+{
+    // Размер окна задержек одного класса эндпоинтов
+    constexpr int32 HedgeWindowSize = 128;
+
+    // Запас жетонов: столько дублей подряд допустимо после долгого затишья
+    constexpr double HedgeMaxTokens = 10.0;
+
+    // Нижняя граница задержки дубля (секунды): быстрее этого дубль только удвоит нагрузку
+    constexpr double HedgeMinDelay = 0.02;
+}
+
+FRadioGardenHedgePolicy& FRadioGardenHedgePolicy::Get()
+{
+    static FRadioGardenHedgePolicy Instance;
+    return Instance;
+}
+
+bool FRadioGardenHedgePolicy::IsHedgeable(ERadioGardenEndpointClass EndpointClass)
+{
+    // Список мест слишком велик, а поиск и геолокация не стоят лишней нагрузки
+    return EndpointClass == ERadioGardenEndpointClass::Channel || EndpointClass == ERadioGardenEndpointClass::Channels;
+}
+
+bool FRadioGardenHedgePolicy::BeginRequest(ERadioGardenEndpointClass EndpointClass, double& OutDelaySeconds)
+{
+    if (!IsHedgeable(EndpointClass) || !CVarRadioGardenHedgeEnabled.GetValueOnAnyThread())
+    {
+        return false;
+    }
+
+    const double BudgetPercent = FMath::Clamp(CVarRadioGardenHedgeBudgetPercent.GetValueOnAnyThread(), 0.0f, 100.0f);
+    const int32 MinSamples = FMath::Max(1, CVarRadioGardenHedgeMinSamples.GetValueOnAnyThread());
+
+    TArray<double> Sorted;
+    {
+        FScopeLock Lock(&CriticalSection);
+        Tokens = FMath::Min(HedgeMaxTokens, Tokens + BudgetPercent / 100.0);
+
+        const FLatencyWindow& Window = Windows[static_cast<int32>(EndpointClass)];
+        if (Window.Samples.Num() < MinSamples)
+        {
+            return false;
+        }
+        Sorted = Window.Samples;
+    }
+
+    Sorted.Sort();
+
+    const double Percentile = FMath::Clamp(CVarRadioGardenHedgePercentile.GetValueOnAnyThread(), 0.0f, 100.0f);
+    const int32 SampleIndex = FMath::Clamp(FMath::CeilToInt32(Percentile / 100.0 * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+    OutDelaySeconds = FMath::Max(HedgeMinDelay, Sorted[SampleIndex]);
+    return true;
+}
+
+bool FRadioGardenHedgePolicy::TryAcquireHedge()
+{
+    FScopeLock Lock(&CriticalSection);
+
+    if (Tokens < 1.0)
+    {
+        return false;
+    }
+
+    Tokens -= 1.0;
+    return true;
+}
+
+void FRadioGardenHedgePolicy::RecordLatency(ERadioGardenEndpointClass EndpointClass, double Seconds)
+{
+    if (!IsHedgeable(EndpointClass))
+    {
+        return;
+    }
+
+    FScopeLock Lock(&CriticalSection);
+
+    FLatencyWindow& Window = Windows[static_cast<int32>(EndpointClass)];
+    if (Window.Samples.Num() < HedgeWindowSize)
+    {
+        Window.Samples.Add(Seconds);
+    }
+    else
+    {
+        Window.Samples[Window.NextSample] = Seconds;
+        Window.NextSample = (Window.NextSample + 1) % HedgeWindowSize;
+    }
+}
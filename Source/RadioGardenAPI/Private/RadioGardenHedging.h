@@ -0,0 +1,61 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RadioGardenHttpRequest.h"
+
+/**
+ * Политика дублирования (hedging) коротких запросов
+ * Для станции и станций места хранится окно недавних задержек; если запрос не завершился
+ * за RadioGarden.Hedge.Percentile этого окна, отправляется дубль, первый ответ побеждает.
+ * Дубли ограничены бюджетом: каждый подходящий запрос даёт RadioGarden.Hedge.BudgetPercent
+ * процентов жетона, дубль тратит целый жетон
+ */
+class FRadioGardenHedgePolicy
+{
+public:
+    /**
+     * Получить экземпляр
+     */
+    static FRadioGardenHedgePolicy& Get();
+
+    /**
+     * Дублируются ли запросы этого класса эндпоинтов
+     */
+    static bool IsHedgeable(ERadioGardenEndpointClass EndpointClass);
+
+    /**
+     * Учесть новый подходящий запрос и получить задержку перед дублем
+     * @param EndpointClass Класс эндпоинта
+     * @param OutDelaySeconds Задержка (секунды)
+     * @return false если дублирование выключено или задержек ещё мало
+     */
+    bool BeginRequest(ERadioGardenEndpointClass EndpointClass, double& OutDelaySeconds);
+
+    /**
+     * Взять жетон бюджета на дубль
+     * @return false если бюджет исчерпан
+     */
+    bool TryAcquireHedge();
+
+    /**
+     * Учесть задержку запроса, получившего окончательный ответ (от отправки исходного запроса до ответа)
+     */
+    void RecordLatency(ERadioGardenEndpointClass EndpointClass, double Seconds);
+
+private:
+    /** Скользящее окно задержек класса эндпоинтов */
+    struct FLatencyWindow
+    {
+        TArray<double> Samples;
+        int32 NextSample = 0;
+    };
+
+    FLatencyWindow Windows[static_cast<int32>(ERadioGardenEndpointClass::Other) + 1];
+
+    /** Доступные жетоны на дубли */
+    double Tokens = 0.0;
+
+    FCriticalSection CriticalSection;
+};
@@ -1,6 +1,11 @@
 // by Neil Moore
 
 #include "RadioGardenHttpRequest.h"
+#include "RadioGardenResponseCache.h"
+#include "RadioGardenRetry.h"
+#include "RadioGardenHedging.h"
+#include "RadioGardenScheduler.h"
+#include "RadioGardenStats.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpRequest.h"
 #include "Interfaces/IHttpResponse.h"
@@ -8,70 +13,546 @@
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
 #include "Misc/ScopeLock.h"
+#include "Async/Async.h"
+#include "HAL/Event.h"
+#include "HAL/IConsoleManager.h"
+#include "Containers/Ticker.h"
+#include "PlatformHttp.h"
+#include <atomic>
 
 const FString FRadioGardenHttpRequest::BaseUrl = TEXT("https://radio.garden/api");
 
-bool FRadioGardenHttpRequest::ExecuteGet(const FString& Endpoint, FString& OutResponse, FString& OutErrorMessage)
-{
-    const FString Url = BaseUrl + Endpoint;
+static TAutoConsoleVariable<FString> CVarRadioGardenBaseUrl(
+    TEXT("RadioGarden.BaseUrl"),
+    TEXT(""),
+    TEXT("Переопределить базовый URL API (например, http://127.0.0.1:8080/api для локального тестового сервера); пусто - https://radio.garden/api"));
 
-    TSharedPtr<IHttpRequest> Request = CreateRequest(Url);
-    if (!Request.IsValid())
+namespace
+{
+    FRadioGardenHttpResult MakeCancelledResult()
     {
-        OutErrorMessage = TEXT("Failed to create HTTP request");
-        UE_LOG(LogRadioGardenAPI, Error, TEXT("%s"), *OutErrorMessage);
-        return false;
+        FRadioGardenHttpResult Result;
+        Result.bCancelled = true;
+        Result.ErrorMessage = TEXT("Request cancelled");
+        return Result;
     }
 
-    UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API GET: %s"), *Url);
+    // Продолжение запроса, которое гарантированно вызывается не более одного раза:
+    // колбэк завершения и ошибка ProcessRequest могут сработать из разных потоков
+    struct FRequestContinuation
+    {
+        FRadioGardenHttpCallback Callback;
+        std::atomic<bool> bInvoked{false};
+
+        explicit FRequestContinuation(FRadioGardenHttpCallback&& InCallback)
+            : Callback(MoveTemp(InCallback)) {}
+
+        void Invoke(FRadioGardenHttpResult&& Result)
+        {
+            if (!bInvoked.exchange(true))
+            {
+                FRadioGardenHttpCallback LocalCallback = MoveTemp(Callback);
+                LocalCallback(MoveTemp(Result));
+            }
+        }
+    };
+
+    // Попытка отменяемого запроса. Пока она ждёт в очереди планировщика или паузу перед повтором, отмена снимает её оттуда;
+    // подписка на отмену снимается по завершении, чтобы общий токен вызова не копил колбэки своих запросов
+    struct FCancellableAttempt
+    {
+        FRequestContinuation Continuation;
+        FString Host;
+
+        FRadioGardenCancellationPtr Cancellation;
+        int32 CancellationCallbackId = 0;
+
+        // Номер в очереди планировщика (0 - попытка не в очереди)
+        uint64 QueueTicket = 0;
+
+        // Пауза перед повтором и её тикер
+        bool bWaitingRetry = false;
+        FTSTicker::FDelegateHandle RetryTicker;
+
+        FCriticalSection CriticalSection;
+
+        FCancellableAttempt(FRadioGardenHttpCallback&& InCallback, const FString& InHost)
+            : Continuation(MoveTemp(InCallback)), Host(InHost) {}
+
+        void Complete(FRadioGardenHttpResult&& Result)
+        {
+            if (Cancellation.IsValid())
+            {
+                Cancellation->RemoveOnCancelled(CancellationCallbackId);
+            }
+            Continuation.Invoke(MoveTemp(Result));
+        }
+
+        // Вызов отменён: ожидающая попытка снимается и сразу завершается, запущенную прерывает FHedgedRequest
+        void CancelWaiting()
+        {
+            uint64 Ticket = 0;
+            bool bRetry = false;
+            FTSTicker::FDelegateHandle Ticker;
+            {
+                FScopeLock Lock(&CriticalSection);
+                Ticket = QueueTicket;
+                QueueTicket = 0;
+                bRetry = bWaitingRetry;
+                bWaitingRetry = false;
+                Ticker = MoveTemp(RetryTicker);
+                RetryTicker.Reset();
+            }
+
+            if (FRadioGardenRequestScheduler::Get().Remove(Ticket))
+            {
+                // Предохранитель мог отдать снятой попытке место пробного запроса: освобождаем его
+                FRadioGardenCircuitBreaker::Get().RecordResult(Host, MakeCancelledResult());
+                Complete(MakeCancelledResult());
+            }
+            else if (bRetry)
+            {
+                if (Ticker.IsValid())
+                {
+                    FTSTicker::RemoveTicker(Ticker);
+                }
+                Complete(MakeCancelledResult());
+            }
+        }
+
+        // Начать паузу перед повтором
+        void BeginRetryWait()
+        {
+            FScopeLock Lock(&CriticalSection);
+            bWaitingRetry = true;
+        }
+
+        // Запомнить тикер паузы, если её ещё не прервала отмена
+        void SetRetryTicker(const FTSTicker::FDelegateHandle& Ticker)
+        {
+            FScopeLock Lock(&CriticalSection);
+            if (bWaitingRetry)
+            {
+                RetryTicker = Ticker;
+            }
+        }
+
+        // Закончить паузу; false - попытку уже завершила отмена
+        bool EndRetryWait()
+        {
+            FScopeLock Lock(&CriticalSection);
+            const bool bWasWaiting = bWaitingRetry;
+            bWaitingRetry = false;
+            RetryTicker.Reset();
+            return bWasWaiting;
+        }
+    };
+
+    // Запрос и его возможный дубль: побеждает первый окончательный ответ, отмена вызова прерывает оба
+    struct FHedgedRequest
+    {
+        FRadioGardenHttpCallback Callback;
+        ERadioGardenEndpointClass EndpointClass = ERadioGardenEndpointClass::Other;
+        double StartTime = 0.0;
+
+        // [0] - исходный запрос, [1] - дубль
+        TSharedPtr<IHttpRequest> Requests[2];
+        int32 PendingRequests = 1;
+        bool bCompleted = false;
+        bool bCancelled = false;
+        FCriticalSection CriticalSection;
+
+        // Подписка на отмену вызова, снимается по завершении
+        FRadioGardenCancellationPtr Cancellation;
+        int32 CancellationCallbackId = 0;
+
+        // Вызов отменён: прерываем оба запроса, их колбэки придут с ошибкой и завершат запрос
+        void Cancel()
+        {
+            TSharedPtr<IHttpRequest> Pending[2];
+            {
+                FScopeLock Lock(&CriticalSection);
+                if (bCompleted)
+                {
+                    return;
+                }
+
+                bCancelled = true;
+                Pending[0] = Requests[0];
+                Pending[1] = Requests[1];
+            }
+
+            for (const TSharedPtr<IHttpRequest>& Request : Pending)
+            {
+                if (Request.IsValid())
+                {
+                    Request->CancelRequest();
+                }
+            }
+        }
+
+        void Complete(int32 RequestIndex, FRadioGardenHttpResult&& Result)
+        {
+            FRadioGardenHttpCallback LocalCallback;
+            TSharedPtr<IHttpRequest> Loser;
+            int32 CallbackId = 0;
+            {
+                FScopeLock Lock(&CriticalSection);
+                --PendingRequests;
+
+                // Временная ошибка одного запроса не решает исход, пока второй ещё в работе
+                if (bCompleted || (PendingRequests > 0 && FRadioGardenRetryPolicy::IsRetryable(Result)))
+                {
+                    return;
+                }
+
+                bCompleted = true;
+                LocalCallback = MoveTemp(Callback);
+                Loser = Requests[1 - RequestIndex];
+                CallbackId = CancellationCallbackId;
+            }
+
+            if (Cancellation.IsValid())
+            {
+                Cancellation->RemoveOnCancelled(CallbackId);
+            }
+
+            // Колбэк отменённого запроса придёт позже и будет проигнорирован
+            if (Loser.IsValid())
+            {
+                Loser->CancelRequest();
+            }
+
+            // Общим путём идут и отменяемые запросы без дублей: их задержки в процентили дублей не входят
+            if (FRadioGardenHedgePolicy::IsHedgeable(EndpointClass) && !FRadioGardenRetryPolicy::IsRetryable(Result))
+            {
+                FRadioGardenHedgePolicy::Get().RecordLatency(EndpointClass, FPlatformTime::Seconds() - StartTime);
+            }
+            if (RequestIndex == 1)
+            {
+                FRadioGardenStats::HedgeWins.fetch_add(1, std::memory_order_relaxed);
+            }
 
-    const bool bSuccess = ExecuteRequestSync(Request, OutResponse, OutErrorMessage);
+            LocalCallback(MoveTemp(Result));
+        }
+    };
 
+    // Приёмник тела ответа: HTTP модуль пишет байты прямо в буфер, который затем
+    // становится телом результата без копирования и без конвертации в FString
+    class FResponseBodyWriter : public FArchive
+    {
+    public:
+        FResponseBodyWriter()
+        {
+            SetIsSaving(true);
+        }
+
+        virtual void Serialize(void* Data, int64 Num) override
+        {
+            Bytes.Append(static_cast<const uint8*>(Data), Num);
+        }
+
+        virtual FString GetArchiveName() const override
+        {
+            return TEXT("FResponseBodyWriter");
+        }
+
+        TArray<uint8> Bytes;
+    };
+}
+
+FString FRadioGardenHttpRequest::GetBaseUrl()
+{
+    FString Url = CVarRadioGardenBaseUrl.GetValueOnAnyThread();
+    if (Url.IsEmpty())
+    {
+        return BaseUrl;
+    }
+
+    Url.RemoveFromEnd(TEXT("/"));
+    return Url;
+}
+
+bool FRadioGardenHttpRequest::ExecuteGet(const FString& Endpoint, FRadioGardenHttpResult& OutResult)
+{
+    const bool bSuccess = ExecuteWithRetry(Endpoint, true, OutResult);
     if (bSuccess)
     {
-        UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API Response: %s"), *OutResponse);
+        UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API Response: %s"), *OutResult.GetContentAsString());
     }
     else
     {
-        UE_LOG(LogRadioGardenAPI, Warning, TEXT("RadioGarden API Error: %s"), *OutErrorMessage);
+        UE_LOG(LogRadioGardenAPI, Warning, TEXT("RadioGarden API Error: %s"), *OutResult.ErrorMessage);
     }
 
     return bSuccess;
 }
 
+void FRadioGardenHttpRequest::ExecuteGetAsync(const FString& Endpoint, FRadioGardenHttpCallback&& OnComplete, ERadioGardenRequestPriority Priority,
+    const FRadioGardenCancellationPtr& Cancellation)
+{
+    // Колбэк приходит в HTTP поток: там только перекладываем результат в фоновую задачу,
+    // чтобы парсинг тяжёлых ответов не задерживал обработку остальных запросов
+    StartWithRetry(Endpoint, true, 1, Priority, Cancellation, [Endpoint, Priority, OnComplete = MoveTemp(OnComplete)](FRadioGardenHttpResult&& Result) mutable
+    {
+        if (Result.bCancelled)
+        {
+            // Разбирать нечего: продолжение только раздаёт отмену
+            UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API request cancelled: %s"), *Endpoint);
+            OnComplete(MoveTemp(Result));
+            return;
+        }
+
+        if (Result.bFromCache)
+        {
+            // Свежая запись кэша: сетевого ответа не было, логировать нечего
+        }
+        else if (Result.bSuccess)
+        {
+            UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API Response: %s"), *Result.GetContentAsString());
+        }
+        else
+        {
+            UE_LOG(LogRadioGardenAPI, Warning, TEXT("RadioGarden API Error: %s"), *Result.ErrorMessage);
+        }
+
+        // Разбор ответа на действие пользователя не ждёт фоновых задач
+        const ENamedThreads::Type ParseThread = Priority == ERadioGardenRequestPriority::Interactive
+            ? ENamedThreads::AnyBackgroundHiPriTask
+            : ENamedThreads::AnyBackgroundThreadNormalTask;
+
+        AsyncTask(ParseThread, [OnComplete = MoveTemp(OnComplete), Result = MoveTemp(Result)]() mutable
+        {
+            OnComplete(MoveTemp(Result));
+        });
+    });
+}
+
 bool FRadioGardenHttpRequest::ExecuteGetRedirect(const FString& Endpoint, FString& OutRedirectUrl, FString& OutErrorMessage)
 {
-    const FString Url = BaseUrl + Endpoint;
+    FRadioGardenHttpResult Result;
+    ExecuteWithRetry(Endpoint, false, Result);
+
+    return ExtractRedirectUrl(Result, OutRedirectUrl, OutErrorMessage);
+}
+
+void FRadioGardenHttpRequest::ExecuteGetRedirectAsync(const FString& Endpoint, FRadioGardenRedirectCallback&& OnComplete, ERadioGardenRequestPriority Priority,
+    const FRadioGardenCancellationPtr& Cancellation)
+{
+    // Разбор редиректа дешёвый, поэтому выполняется прямо в HTTP потоке
+    StartWithRetry(Endpoint, false, 1, Priority, Cancellation, [OnComplete = MoveTemp(OnComplete)](FRadioGardenHttpResult&& Result)
+    {
+        FString RedirectUrl;
+        FString ErrorMessage;
+        const bool bSuccess = ExtractRedirectUrl(Result, RedirectUrl, ErrorMessage);
+        OnComplete(bSuccess, RedirectUrl, ErrorMessage);
+    });
+}
+
+bool FRadioGardenHttpRequest::ExecuteWithRetry(const FString& Endpoint, bool bUseCache, FRadioGardenHttpResult& OutResult)
+{
+    const FString Url = GetBaseUrl() + Endpoint;
+    const FString Host = FPlatformHttp::GetUrlDomain(Url);
+    bool bConditional = true;
+
+    for (int32 Attempt = 1;; ++Attempt)
+    {
+        OutResult = FRadioGardenHttpResult();
+
+        TSharedPtr<IHttpRequest> Request = CreateRequest(Url);
+        if (!Request.IsValid())
+        {
+            OutResult.ErrorMessage = TEXT("Failed to create HTTP request");
+            UE_LOG(LogRadioGardenAPI, Error, TEXT("%s"), *OutResult.ErrorMessage);
+            return false;
+        }
+
+        // Кэш проверяется на каждой попытке: пока шла пауза, ответ мог прийти от параллельного запроса
+        if (bUseCache && PrepareCachedRequest(Endpoint, Request, OutResult, bConditional))
+        {
+            UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API GET (cached): %s"), *Url);
+            return true;
+        }
+
+        if (!FRadioGardenCircuitBreaker::Get().AllowRequest(Host, OutResult))
+        {
+            return false;
+        }
+
+        FRadioGardenRequestScheduler::Get().Acquire(ERadioGardenRequestPriority::Interactive);
+
+        UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API GET (attempt %d): %s"), Attempt, *Url);
+
+        const double StartTime = FPlatformTime::Seconds();
+        ExecuteRequestSync(Request, OutResult);
+        FRadioGardenRequestScheduler::Get().Release(ClassifyEndpoint(Endpoint), OutResult, FPlatformTime::Seconds() - StartTime);
+        FRadioGardenCircuitBreaker::Get().RecordResult(Host, OutResult);
+
+        // Запись вытеснена, пока шёл условный запрос: один раз повторяем его без условий, не тратя попытку
+        if (bUseCache && !ResolveCachedResult(Endpoint, OutResult) && bConditional)
+        {
+            UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API cached response evicted before 304, reissuing: %s"), *Url);
+            bConditional = false;
+            --Attempt;
+            continue;
+        }
+
+        // Игровой поток не засыпает на паузу перед повтором (до RadioGarden.Retry.MaxDelay): там делается одна попытка
+        double DelaySeconds = 0.0;
+        if (IsInGameThread() || !FRadioGardenRetryPolicy::GetRetryDelay(Attempt, OutResult, DelaySeconds))
+        {
+            return OutResult.bSuccess;
+        }
+
+        UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API retry in %.2f s: %s (%s)"), DelaySeconds, *Url, *OutResult.ErrorMessage);
+        FRadioGardenStats::Retries.fetch_add(1, std::memory_order_relaxed);
+        FPlatformProcess::Sleep(static_cast<float>(DelaySeconds));
+    }
+}
+
+void FRadioGardenHttpRequest::StartWithRetry(const FString& Endpoint, bool bUseCache, int32 Attempt, ERadioGardenRequestPriority Priority,
+    const FRadioGardenCancellationPtr& Cancellation, FRadioGardenHttpCallback&& OnComplete, bool bConditional)
+{
+    if (Cancellation.IsValid() && Cancellation->IsCancelled())
+    {
+        OnComplete(MakeCancelledResult());
+        return;
+    }
+
+    const FString Url = GetBaseUrl() + Endpoint;
+    const FString Host = FPlatformHttp::GetUrlDomain(Url);
 
     TSharedPtr<IHttpRequest> Request = CreateRequest(Url);
     if (!Request.IsValid())
     {
-        OutErrorMessage = TEXT("Failed to create HTTP request");
-        return false;
+        FRadioGardenHttpResult Result;
+        Result.ErrorMessage = TEXT("Failed to create HTTP request");
+        UE_LOG(LogRadioGardenAPI, Error, TEXT("%s"), *Result.ErrorMessage);
+        OnComplete(MoveTemp(Result));
+        return;
     }
 
-    UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API GET (redirect): %s"), *Url);
+    FRadioGardenHttpResult ImmediateResult;
+    if (bUseCache && PrepareCachedRequest(Endpoint, Request, ImmediateResult, bConditional))
+    {
+        UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API GET (cached): %s"), *Url);
+        OnComplete(MoveTemp(ImmediateResult));
+        return;
+    }
 
-    // Выполняем запрос
-    FString ResponseContent;
-    const bool bRequestComplete = ExecuteRequestSync(Request, ResponseContent, OutErrorMessage);
+    if (!FRadioGardenCircuitBreaker::Get().AllowRequest(Host, ImmediateResult))
+    {
+        OnComplete(MoveTemp(ImmediateResult));
+        return;
+    }
 
-    if (!bRequestComplete)
+    // Продолжение разделяется с отменой: запрос, снятый из очереди, завершается сразу
+    const TSharedRef<FCancellableAttempt, ESPMode::ThreadSafe> Pending = MakeShared<FCancellableAttempt, ESPMode::ThreadSafe>(MoveTemp(OnComplete), Host);
+    if (Cancellation.IsValid())
     {
-        return false;
+        Pending->Cancellation = Cancellation;
+        Pending->CancellationCallbackId = Cancellation->OnCancelled([WeakPending = TWeakPtr<FCancellableAttempt, ESPMode::ThreadSafe>(Pending)]()
+        {
+            if (const TSharedPtr<FCancellableAttempt, ESPMode::ThreadSafe> PinnedPending = WeakPending.Pin())
+            {
+                PinnedPending->CancelWaiting();
+            }
+        });
+    }
+
+    // Запрос ждёт своей очереди в общем планировщике, дубли идут вне его: их ограничивает бюджет
+    const uint64 Ticket = FRadioGardenRequestScheduler::Get().Enqueue(Priority, Endpoint, [Request, Endpoint, Url, Host, bUseCache, bConditional, Attempt, Priority, Cancellation, Pending]()
+    {
+        UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API GET (async, attempt %d): %s"), Attempt, *Url);
+
+        const ERadioGardenEndpointClass EndpointClass = ClassifyEndpoint(Endpoint);
+        const double StartTime = FPlatformTime::Seconds();
+        StartHedgedRequest(Request, EndpointClass, Cancellation, [Endpoint, Url, Host, bUseCache, bConditional, Attempt, Priority, EndpointClass, StartTime, Cancellation, Pending](FRadioGardenHttpResult&& Result)
+        {
+            // Ответ мог успеть прийти до отмены: тогда он сохраняется в кэш как обычно
+            const bool bCancelled = Cancellation.IsValid() && Cancellation->IsCancelled();
+            if (bCancelled && !Result.bSuccess)
+            {
+                Result.bCancelled = true;
+                Result.ErrorMessage = TEXT("Request cancelled");
+            }
+
+            FRadioGardenRequestScheduler::Get().Release(EndpointClass, Result, FPlatformTime::Seconds() - StartTime);
+            FRadioGardenCircuitBreaker::Get().RecordResult(Host, Result);
+
+            // Запись вытеснена, пока шёл условный запрос: один раз повторяем его без условий, не тратя попытку
+            if (bUseCache && !ResolveCachedResult(Endpoint, Result) && bConditional && !bCancelled)
+            {
+                UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API cached response evicted before 304, reissuing: %s"), *Url);
+                StartWithRetry(Endpoint, bUseCache, Attempt, Priority, Cancellation, [Pending](FRadioGardenHttpResult&& NextResult)
+                {
+                    Pending->Complete(MoveTemp(NextResult));
+                }, false);
+                return;
+            }
+
+            double DelaySeconds = 0.0;
+            if (bCancelled || !FRadioGardenRetryPolicy::GetRetryDelay(Attempt, Result, DelaySeconds))
+            {
+                Pending->Complete(MoveTemp(Result));
+                return;
+            }
+
+            UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API retry in %.2f s: %s (%s)"), DelaySeconds, *Url, *Result.ErrorMessage);
+            FRadioGardenStats::Retries.fetch_add(1, std::memory_order_relaxed);
+
+            // Пауза на тикере: ни один поток не ждёт следующей попытки, отмена на паузе снимает тикер и завершает вызов сразу
+            Pending->BeginRetryWait();
+            const FTSTicker::FDelegateHandle RetryTicker = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Endpoint, bUseCache, bConditional, Attempt, Priority, Cancellation, Pending](float)
+            {
+                if (!Pending->EndRetryWait())
+                {
+                    return false;
+                }
+
+                StartWithRetry(Endpoint, bUseCache, Attempt + 1, Priority, Cancellation, [Pending](FRadioGardenHttpResult&& NextResult)
+                {
+                    Pending->Complete(MoveTemp(NextResult));
+                }, bConditional);
+                return false;
+            }), static_cast<float>(DelaySeconds));
+            Pending->SetRetryTicker(RetryTicker);
+
+            // Отмена могла прийти, пока тикер ещё не был запомнен
+            if (Cancellation.IsValid() && Cancellation->IsCancelled())
+            {
+                Pending->CancelWaiting();
+            }
+        });
+    });
+
+    // Отмена ожидающего запроса снимает его из очереди; запущенный запрос прерывает StartHedgedRequest
+    if (Ticket != 0 && Cancellation.IsValid())
+    {
+        {
+            FScopeLock Lock(&Pending->CriticalSection);
+            Pending->QueueTicket = Ticket;
+        }
+
+        // Отмена могла прийти, пока номер в очереди ещё не был известен
+        if (Cancellation->IsCancelled())
+        {
+            Pending->CancelWaiting();
+        }
     }
+}
 
+bool FRadioGardenHttpRequest::ExtractRedirectUrl(const FRadioGardenHttpResult& Result, FString& OutRedirectUrl, FString& OutErrorMessage)
+{
     // Проверяем статус ответа
-    const int32 ResponseCode = Request->GetResponse()->GetResponseCode();
+    const int32 ResponseCode = Result.ResponseCode;
 
     if (ResponseCode == 302 || ResponseCode == 301)
     {
         // Получаем URL из заголовка Location
-        FString LocationHeader;
-        LocationHeader = Request->GetResponse()->GetHeader(TEXT("Location"));
-        if (!LocationHeader.IsEmpty())
+        if (!Result.Location.IsEmpty())
         {
-            OutRedirectUrl = LocationHeader;
+            OutRedirectUrl = Result.Location;
             UE_LOG(LogRadioGardenAPI, Log, TEXT("RadioGarden API Redirect: %s"), *OutRedirectUrl);
             return true;
         }
@@ -86,6 +567,7 @@ bool FRadioGardenHttpRequest::ExecuteGetRedirect(const FString& Endpoint, FStrin
     {
         // Если вернулся 200, проверяем тело на наличие URL
         // Иногда сервер возвращает HTML с редиректом
+        const FString ResponseContent = Result.GetContentAsString();
         if (ResponseContent.Contains(TEXT("href=\"http")))
         {
             int32 StartIndex = ResponseContent.Find(TEXT("href=\"http")) + 6;
@@ -102,6 +584,11 @@ bool FRadioGardenHttpRequest::ExecuteGetRedirect(const FString& Endpoint, FStrin
         UE_LOG(LogRadioGardenAPI, Warning, TEXT("%s"), *OutErrorMessage);
         return false;
     }
+    else if (ResponseCode == 0)
+    {
+        OutErrorMessage = Result.ErrorMessage;
+        return false;
+    }
     else
     {
         OutErrorMessage = FString::Printf(TEXT("Unexpected response code: %d"), ResponseCode);
@@ -129,6 +616,25 @@ bool FRadioGardenHttpRequest::ParseJson(const FString& JsonResponse, TSharedPtr<
     return true;
 }
 
+bool FRadioGardenHttpRequest::ParseJson(FUtf8StringView JsonResponse, TSharedPtr<FJsonObject>& OutJsonObject)
+{
+    if (JsonResponse.IsEmpty())
+    {
+        UE_LOG(LogRadioGardenAPI, Error, TEXT("Empty JSON response"));
+        return false;
+    }
+
+    TSharedRef<TJsonReader<UTF8CHAR>> Reader = TJsonReaderFactory<UTF8CHAR>::CreateFromView(JsonResponse);
+
+    if (!FJsonSerializer::Deserialize(Reader, OutJsonObject) || !OutJsonObject.IsValid())
+    {
+        UE_LOG(LogRadioGardenAPI, Error, TEXT("Failed to parse JSON: %s"), *FString(JsonResponse));
+        return false;
+    }
+
+    return true;
+}
+
 FString FRadioGardenHttpRequest::GetStringSafe(const TSharedPtr<FJsonObject>& JsonObject, const FString& FieldName)
 {
     if (!JsonObject.IsValid())
@@ -223,6 +729,32 @@ bool FRadioGardenHttpRequest::GetObjectSafe(const TSharedPtr<FJsonObject>& JsonO
     return false;
 }
 
+ERadioGardenEndpointClass FRadioGardenHttpRequest::ClassifyEndpoint(const FString& Endpoint)
+{
+    if (Endpoint.StartsWith(TEXT("/ara/content/places")))
+    {
+        return ERadioGardenEndpointClass::Places;
+    }
+    else if (Endpoint.StartsWith(TEXT("/ara/content/page/")))
+    {
+        return ERadioGardenEndpointClass::Channels;
+    }
+    else if (Endpoint.StartsWith(TEXT("/ara/content/channel/")))
+    {
+        return ERadioGardenEndpointClass::Channel;
+    }
+    else if (Endpoint.StartsWith(TEXT("/search")))
+    {
+        return ERadioGardenEndpointClass::Search;
+    }
+    else if (Endpoint.StartsWith(TEXT("/geo")))
+    {
+        return ERadioGardenEndpointClass::Geo;
+    }
+
+    return ERadioGardenEndpointClass::Other;
+}
+
 ERadioGardenStatus FRadioGardenHttpRequest::ConvertHttpStatus(int32 HttpResponseCode, const FString& ResponseContent)
 {
     if (HttpResponseCode >= 200 && HttpResponseCode < 300)
@@ -233,7 +765,7 @@ ERadioGardenStatus FRadioGardenHttpRequest::ConvertHttpStatus(int32 HttpResponse
     {
         return ERadioGardenStatus::Timeout;
     }
-    else if (HttpResponseCode >= 500)
+    else if (HttpResponseCode >= 500 || HttpResponseCode == 429)
     {
         return ERadioGardenStatus::ServerError;
     }
@@ -262,72 +794,268 @@ TSharedPtr<IHttpRequest> FRadioGardenHttpRequest::CreateRequest(const FString& U
     Request->SetHeader(TEXT("User-Agent"), TEXT("UnrealEngine-RadioGardenAPI/1.0"));
     Request->SetTimeout(DefaultTimeout);
 
+    // Колбэк завершения вызывается в HTTP потоке, а не в игровом:
+    // синхронные вызовы из игрового потока не блокируют сами себя
+    Request->SetDelegateThreadPolicy(EHttpRequestDelegateThreadPolicy::CompleteOnHttpThread);
+
     return Request;
 }
 
-bool FRadioGardenHttpRequest::ExecuteRequestSync(TSharedPtr<IHttpRequest> Request, FString& OutResponse, FString& OutErrorMessage)
+bool FRadioGardenHttpRequest::PrepareCachedRequest(const FString& Endpoint, const TSharedPtr<IHttpRequest>& Request, FRadioGardenHttpResult& OutCachedResult,
+    bool bConditional)
+{
+    FString ETag;
+    FString LastModified;
+
+    switch (FRadioGardenResponseCache::Get().Find(Endpoint, OutCachedResult, ETag, LastModified))
+    {
+    case FRadioGardenResponseCache::ELookup::Fresh:
+        return true;
+
+    case FRadioGardenResponseCache::ELookup::Stale:
+        // Условный запрос: при неизменном содержимом сервер ответит 304 без тела
+        if (bConditional && !ETag.IsEmpty())
+        {
+            Request->SetHeader(TEXT("If-None-Match"), ETag);
+        }
+        if (bConditional && !LastModified.IsEmpty())
+        {
+            Request->SetHeader(TEXT("If-Modified-Since"), LastModified);
+        }
+        return false;
+
+    default:
+        return false;
+    }
+}
+
+bool FRadioGardenHttpRequest::ResolveCachedResult(const FString& Endpoint, FRadioGardenHttpResult& Result)
+{
+    if (Result.ResponseCode == 304)
+    {
+        // Валидаторы копируются: Revalidate заполняет тот же результат
+        const FString ETag = Result.ETag;
+        const FString LastModified = Result.LastModified;
+        if (!FRadioGardenResponseCache::Get().Revalidate(Endpoint, Result, ETag, LastModified))
+        {
+            Result.bSuccess = false;
+            Result.ErrorMessage = TEXT("HTTP 304 but cached response was evicted");
+            return false;
+        }
+    }
+    else if (Result.bSuccess)
+    {
+        FRadioGardenResponseCache::Get().Store(Endpoint, Result, Result.ETag, Result.LastModified);
+    }
+
+    return true;
+}
+
+bool FRadioGardenHttpRequest::StartRequest(const TSharedPtr<IHttpRequest>& Request, FRadioGardenHttpCallback&& OnComplete)
 {
     if (!Request.IsValid())
     {
-        OutErrorMessage = TEXT("Invalid request");
+        FRadioGardenHttpResult Result;
+        Result.ErrorMessage = TEXT("Invalid request");
+        OnComplete(MoveTemp(Result));
         return false;
     }
 
-    // Синхронное выполнение запроса
-    FHttpModule& HttpModule = FHttpModule::Get();
+    // Колбэк может так и не вызваться, если ProcessRequest не запустил запрос
+    TSharedRef<FRequestContinuation, ESPMode::ThreadSafe> Continuation = MakeShared<FRequestContinuation, ESPMode::ThreadSafe>(MoveTemp(OnComplete));
 
-    // Создаём событие для ожидания завершения
-    FEvent* RequestCompleteEvent = FPlatformProcess::GetSynchEventFromPool();
-    bool bRequestComplete = false;
-    FString ResponseContent;
-    int32 ResponseCode = 0;
+    // Если реализация HTTP не поддерживает поток приёма, тело копируется из ответа
+    TSharedRef<FResponseBodyWriter> BodyWriter = MakeShared<FResponseBodyWriter>();
+    const bool bUseBodyWriter = Request->SetResponseBodyReceiveStream(BodyWriter);
 
     Request->OnProcessRequestComplete().BindLambda(
-        [&bRequestComplete, &ResponseContent, &ResponseCode, RequestCompleteEvent](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSuccess)
+        [Continuation, BodyWriter, bUseBodyWriter](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bConnectedSuccessfully)
         {
-            bRequestComplete = true;
+            FRadioGardenHttpResult Result;
+
+            if (bConnectedSuccessfully && HttpResponse.IsValid())
+            {
+                Result.ResponseCode = HttpResponse->GetResponseCode();
+                Result.Content = bUseBodyWriter
+                    ? MakeShared<const TArray<uint8>, ESPMode::ThreadSafe>(MoveTemp(BodyWriter->Bytes))
+                    : MakeShared<const TArray<uint8>, ESPMode::ThreadSafe>(HttpResponse->GetContent());
+                Result.Location = HttpResponse->GetHeader(TEXT("Location"));
+                Result.ETag = HttpResponse->GetHeader(TEXT("ETag"));
+                Result.LastModified = HttpResponse->GetHeader(TEXT("Last-Modified"));
+                Result.RetryAfter = HttpResponse->GetHeader(TEXT("Retry-After"));
 
-            if (bSuccess && HttpResponse.IsValid())
+                // Проверяем код ответа
+                Result.bSuccess = Result.ResponseCode >= 200 && Result.ResponseCode < 300;
+                if (!Result.bSuccess)
+                {
+                    Result.ErrorMessage = FString::Printf(TEXT("HTTP %d: %s"), Result.ResponseCode, *Result.GetContentAsString());
+                }
+            }
+            else if (HttpRequest.IsValid() && HttpRequest->GetStatus() == EHttpRequestStatus::Failed
+                && HttpRequest->GetFailureReason() == EHttpFailureReason::TimedOut)
             {
-                ResponseCode = HttpResponse->GetResponseCode();
-                ResponseContent = HttpResponse->GetContentAsString();
+                Result.ErrorMessage = TEXT("Request timed out");
+                Result.bTimedOut = true;
+            }
+            else
+            {
+                Result.ErrorMessage = TEXT("Request failed to complete");
             }
 
-            RequestCompleteEvent->Trigger();
+            Continuation->Invoke(MoveTemp(Result));
         }
     );
 
     if (!Request->ProcessRequest())
     {
-        OutErrorMessage = TEXT("Failed to process request");
-        FPlatformProcess::ReturnSynchEventToPool(RequestCompleteEvent);
+        FRadioGardenHttpResult Result;
+        Result.ErrorMessage = TEXT("Failed to process request");
+        Continuation->Invoke(MoveTemp(Result));
         return false;
     }
 
-    // Ожидаем завершения (с таймаутом)
-    const bool bTimedOut = !RequestCompleteEvent->Wait(static_cast<uint32>(DefaultTimeout * 1000));
-    FPlatformProcess::ReturnSynchEventToPool(RequestCompleteEvent);
+    return true;
+}
 
-    if (bTimedOut)
+void FRadioGardenHttpRequest::StartHedgedRequest(const TSharedPtr<IHttpRequest>& Request, ERadioGardenEndpointClass EndpointClass,
+    const FRadioGardenCancellationPtr& Cancellation, FRadioGardenHttpCallback&& OnComplete)
+{
+    // Без дубля и без отмены запрос обходится без общего состояния
+    if (!FRadioGardenHedgePolicy::IsHedgeable(EndpointClass) && !Cancellation.IsValid())
     {
-        OutErrorMessage = TEXT("Request timed out");
-        UE_LOG(LogRadioGardenAPI, Error, TEXT("%s"), *OutErrorMessage);
-        return false;
+        StartRequest(Request, MoveTemp(OnComplete));
+        return;
     }
 
-    if (!bRequestComplete)
+    double HedgeDelay = 0.0;
+    const bool bHedge = FRadioGardenHedgePolicy::IsHedgeable(EndpointClass) && FRadioGardenHedgePolicy::Get().BeginRequest(EndpointClass, HedgeDelay);
+
+    TSharedRef<FHedgedRequest, ESPMode::ThreadSafe> Hedged = MakeShared<FHedgedRequest, ESPMode::ThreadSafe>();
+    Hedged->Callback = MoveTemp(OnComplete);
+    Hedged->EndpointClass = EndpointClass;
+    Hedged->StartTime = FPlatformTime::Seconds();
+    Hedged->Requests[0] = Request;
+    Hedged->Cancellation = Cancellation;
+
+    StartRequest(Request, [Hedged](FRadioGardenHttpResult&& Result)
     {
-        OutErrorMessage = TEXT("Request failed to complete");
+        Hedged->Complete(0, MoveTemp(Result));
+    });
+
+    // Подписка после запуска: прерывать можно только отправленный запрос. Уже отменённый вызов прерывается сразу
+    if (Cancellation.IsValid())
+    {
+        const int32 CallbackId = Cancellation->OnCancelled([WeakHedged = TWeakPtr<FHedgedRequest, ESPMode::ThreadSafe>(Hedged)]()
+        {
+            if (const TSharedPtr<FHedgedRequest, ESPMode::ThreadSafe> PinnedHedged = WeakHedged.Pin())
+            {
+                PinnedHedged->Cancel();
+            }
+        });
+
+        bool bCompleted = false;
+        {
+            FScopeLock Lock(&Hedged->CriticalSection);
+            bCompleted = Hedged->bCompleted;
+            Hedged->CancellationCallbackId = CallbackId;
+        }
+
+        if (bCompleted)
+        {
+            Cancellation->RemoveOnCancelled(CallbackId);
+        }
+    }
+
+    if (!bHedge)
+    {
+        return;
+    }
+
+    FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Hedged](float)
+    {
+        {
+            FScopeLock Lock(&Hedged->CriticalSection);
+            if (Hedged->bCompleted || Hedged->bCancelled)
+            {
+                return false;
+            }
+        }
+
+        if (!FRadioGardenHedgePolicy::Get().TryAcquireHedge())
+        {
+            return false;
+        }
+
+        // Копия с теми же заголовками, включая условные заголовки кэша
+        const TSharedPtr<IHttpRequest>& Original = Hedged->Requests[0];
+        TSharedPtr<IHttpRequest> Duplicate = CreateRequest(Original->GetURL());
+        if (!Duplicate.IsValid())
+        {
+            return false;
+        }
+        for (const FString& Header : Original->GetAllHeaders())
+        {
+            FString Name;
+            FString Value;
+            if (Header.Split(TEXT(": "), &Name, &Value))
+            {
+                Duplicate->SetHeader(Name, Value);
+            }
+        }
+
+        {
+            FScopeLock Lock(&Hedged->CriticalSection);
+            if (Hedged->bCompleted || Hedged->bCancelled)
+            {
+                return false;
+            }
+            Hedged->Requests[1] = Duplicate;
+            ++Hedged->PendingRequests;
+        }
+
+        UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API GET (hedge): %s"), *Original->GetURL());
+        FRadioGardenStats::HedgedRequests.fetch_add(1, std::memory_order_relaxed);
+
+        StartRequest(Duplicate, [Hedged](FRadioGardenHttpResult&& Result)
+        {
+            Hedged->Complete(1, MoveTemp(Result));
+        });
+        return false;
+    }), static_cast<float>(HedgeDelay));
+}
+
+bool FRadioGardenHttpRequest::ExecuteRequestSync(const TSharedPtr<IHttpRequest>& Request, FRadioGardenHttpResult& OutResult)
+{
+    // Состояние разделяется с колбэком: он может прийти уже после выхода по таймауту
+    struct FSyncState
+    {
+        FEventRef CompleteEvent;
+        FRadioGardenHttpResult Result;
+    };
+    TSharedRef<FSyncState, ESPMode::ThreadSafe> State = MakeShared<FSyncState, ESPMode::ThreadSafe>();
+
+    if (!StartRequest(Request, [State](FRadioGardenHttpResult&& Result)
+        {
+            State->Result = MoveTemp(Result);
+            State->CompleteEvent->Trigger();
+        }))
+    {
+        OutResult = MoveTemp(State->Result);
         return false;
     }
 
-    // Проверяем код ответа
-    if (ResponseCode < 200 || ResponseCode >= 300)
+    // Ожидаем завершения (с таймаутом)
+    if (!State->CompleteEvent->Wait(static_cast<uint32>(DefaultTimeout * 1000)))
     {
-        OutErrorMessage = FString::Printf(TEXT("HTTP %d: %s"), ResponseCode, *ResponseContent);
+        Request->CancelRequest();
+
+        OutResult = FRadioGardenHttpResult();
+        OutResult.ErrorMessage = TEXT("Request timed out");
+        OutResult.bTimedOut = true;
+        UE_LOG(LogRadioGardenAPI, Error, TEXT("%s"), *OutResult.ErrorMessage);
         return false;
     }
 
-    OutResponse = ResponseContent;
-    return true;
+    OutResult = MoveTemp(State->Result);
+    return OutResult.bSuccess;
 }
@@ -8,28 +8,146 @@
 #include "Interfaces/IHttpResponse.h"
 #include "Dom/JsonObject.h"
 #include "RadioGardenTypes.h"
+#include "RadioGardenCancellation.h"
+
+/**
+ * Класс эндпоинта API, определяет TTL кэширования
+ */
+enum class ERadioGardenEndpointClass : uint8
+{
+    /** /ara/content/places */
+    Places,
+    /** /ara/content/page/{id} и /ara/content/page/{id}/channels */
+    Channels,
+    /** /ara/content/channel/{id} */
+    Channel,
+    /** /search */
+    Search,
+    /** /geo */
+    Geo,
+    /** Прочее (редиректы на потоки) */
+    Other
+};
+
+/**
+ * Приоритет сетевого запроса в планировщике (FRadioGardenRequestScheduler)
+ */
+enum class ERadioGardenRequestPriority : uint8
+{
+    /** Одиночный запрос, ответа которого ждёт пользователь */
+    Interactive,
+    /** Массовые операции: ближайшие станции, области, маршруты */
+    Normal,
+    /** Фоновое обновление каталога и упреждение */
+    Background
+};
+
+/** Тело ответа в исходной кодировке (UTF-8), разделяется между результатами и кэшем без копирования */
+using FRadioGardenHttpContent = TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe>;
+
+/**
+ * Результат выполнения HTTP запроса
+ */
+struct FRadioGardenHttpResult
+{
+    /** Запрос завершён с кодом 2xx */
+    bool bSuccess = false;
+
+    /** Ответ взят из кэша (свежая запись или 304 Not Modified) */
+    bool bFromCache = false;
+
+    /** HTTP код ответа (0 если ответ не получен) */
+    int32 ResponseCode = 0;
+
+    /** Тело ответа */
+    FRadioGardenHttpContent Content;
+
+    /** Версия содержимого в кэше (0 если ответ не кэшировался), не меняется при 304 */
+    uint64 ContentVersion = 0;
+
+    /** Значение заголовка Location */
+    FString Location;
+
+    /** Значение заголовка ETag */
+    FString ETag;
+
+    /** Значение заголовка Last-Modified */
+    FString LastModified;
+
+    /** Значение заголовка Retry-After */
+    FString RetryAfter;
+
+    /** Ответ не получен за отведённое время */
+    bool bTimedOut = false;
+
+    /** Запрос отменён токеном отмены */
+    bool bCancelled = false;
+
+    /** Сообщение об ошибке */
+    FString ErrorMessage;
+
+    /** Тело ответа как UTF-8 текст, без копирования и конвертации */
+    FUtf8StringView GetContentView() const
+    {
+        return Content.IsValid()
+            ? FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Content->GetData()), Content->Num())
+            : FUtf8StringView();
+    }
+
+    /** Тело ответа, сконвертированное в FString (для логов и коротких ответов) */
+    FString GetContentAsString() const
+    {
+        return FString(GetContentView());
+    }
+};
+
+/** Продолжение асинхронного запроса, вызывается в фоновом потоке */
+using FRadioGardenHttpCallback = TFunction<void(FRadioGardenHttpResult&&)>;
+
+/** Продолжение асинхронного запроса редиректа */
+using FRadioGardenRedirectCallback = TFunction<void(bool bSuccess, const FString& RedirectUrl, const FString& ErrorMessage)>;
 
 /**
  * Обработчик HTTP запросов к Radio Garden API
- * Обеспечивает безопасное выполнение запросов с обработкой ошибок
+ * Обеспечивает безопасное выполнение запросов с обработкой ошибок.
+ * Запросы повторяются при временных ошибках (FRadioGardenRetryPolicy)
+ * и отклоняются сразу, пока открыт предохранитель хоста (FRadioGardenCircuitBreaker).
+ * Асинхронный запрос с отменённым токеном снимается из очереди планировщика или прерывается,
+ * продолжение получает результат с bCancelled
  */
 class FRadioGardenHttpRequest
 {
 public:
-    /** Базовый URL API */
+    /** Базовый URL API по умолчанию */
     static const FString BaseUrl;
 
+    /**
+     * Базовый URL API с учётом переопределения RadioGarden.BaseUrl (например, локальный тестовый сервер)
+     */
+    static FString GetBaseUrl();
+
     /** Таймаут запроса (секунды) */
     static constexpr float DefaultTimeout = 30.0f;
 
     /**
-     * Выполнить GET запрос
+     * Выполнить GET запрос (синхронно, блокирует вызывающий поток, поэтому с приоритетом Interactive)
      * @param Endpoint Эндпоинт API
-     * @param OutResponse Ответ от сервера
-     * @param OutErrorMessage Сообщение об ошибке
+     * @param OutResult Результат запроса
      * @return true если запрос успешен
      */
-    static bool ExecuteGet(const FString& Endpoint, FString& OutResponse, FString& OutErrorMessage);
+    static bool ExecuteGet(const FString& Endpoint, FRadioGardenHttpResult& OutResult);
+
+    /**
+     * Выполнить GET запрос асинхронно
+     * Ни один поток не ожидает сетевой ответ: продолжение запускается из колбэка завершения HTTP
+     * и выполняется в фоновой задаче, где можно парсить ответ
+     * @param Endpoint Эндпоинт API
+     * @param OnComplete Продолжение с результатом запроса
+     * @param Priority Приоритет запроса
+     * @param Cancellation Токен отмены (nullptr - запрос не отменяется)
+     */
+    static void ExecuteGetAsync(const FString& Endpoint, FRadioGardenHttpCallback&& OnComplete, ERadioGardenRequestPriority Priority = ERadioGardenRequestPriority::Normal,
+        const FRadioGardenCancellationPtr& Cancellation = nullptr);
 
     /**
      * Выполнить GET запрос и получить redirect URL
@@ -40,6 +158,16 @@ public:
      */
     static bool ExecuteGetRedirect(const FString& Endpoint, FString& OutRedirectUrl, FString& OutErrorMessage);
 
+    /**
+     * Выполнить GET запрос и получить redirect URL асинхронно
+     * @param Endpoint Эндпоинт API
+     * @param OnComplete Продолжение с URL редиректа
+     * @param Priority Приоритет запроса
+     * @param Cancellation Токен отмены (nullptr - запрос не отменяется)
+     */
+    static void ExecuteGetRedirectAsync(const FString& Endpoint, FRadioGardenRedirectCallback&& OnComplete, ERadioGardenRequestPriority Priority = ERadioGardenRequestPriority::Normal,
+        const FRadioGardenCancellationPtr& Cancellation = nullptr);
+
     /**
      * Парсит JSON ответ
      * @param JsonResponse Строка с JSON
@@ -48,6 +176,14 @@ public:
      */
     static bool ParseJson(const FString& JsonResponse, TSharedPtr<FJsonObject>& OutJsonObject);
 
+    /**
+     * Парсит JSON ответ прямо из UTF-8 буфера, без конвертации всего тела в FString
+     * @param JsonResponse Тело ответа в UTF-8
+     * @param OutJsonObject Распаршенный объект
+     * @return true если JSON валиден
+     */
+    static bool ParseJson(FUtf8StringView JsonResponse, TSharedPtr<FJsonObject>& OutJsonObject);
+
     /**
      * Безопасно получить строковое поле из JSON
      */
@@ -74,6 +210,11 @@ public:
     static bool GetObjectSafe(const TSharedPtr<FJsonObject>& JsonObject, const FString& FieldName, const TSharedPtr<FJsonObject>*& OutObject);
     static bool GetObjectSafe(const TSharedPtr<FJsonObject>& JsonObject, const FString& FieldName, TSharedPtr<FJsonObject>& OutObject);
 
+    /**
+     * Определить класс эндпоинта
+     */
+    static ERadioGardenEndpointClass ClassifyEndpoint(const FString& Endpoint);
+
     /**
      * Конвертировать статус HTTP в статус API
      */
@@ -85,8 +226,57 @@ private:
      */
     static TSharedPtr<IHttpRequest> CreateRequest(const FString& Url);
 
+    /**
+     * Подготовить запрос с учётом кэша
+     * @param bConditional Перепроверять устаревшую запись условным запросом
+     * @return true если в кэше есть свежий ответ и запрос выполнять не нужно
+     */
+    static bool PrepareCachedRequest(const FString& Endpoint, const TSharedPtr<IHttpRequest>& Request, FRadioGardenHttpResult& OutCachedResult,
+        bool bConditional = true);
+
+    /**
+     * Обработать ответ с учётом кэша: 304 берётся из кэша, успешный ответ сохраняется
+     * @return false если на 304 запись уже вытеснена и запрос нужно повторить без условий
+     */
+    static bool ResolveCachedResult(const FString& Endpoint, FRadioGardenHttpResult& Result);
+
+    /**
+     * Выполнить запрос с повторами синхронно
+     * Пауза перед повтором усыпляет вызывающий поток, поэтому в игровом потоке делается одна попытка без повторов
+     * @param bUseCache Учитывать кэш ответов (свежая запись, условный запрос, сохранение ответа)
+     */
+    static bool ExecuteWithRetry(const FString& Endpoint, bool bUseCache, FRadioGardenHttpResult& OutResult);
+
+    /**
+     * Запустить запрос с повторами; OnComplete вызывается в HTTP потоке, потоке тикера или сразу
+     * @param Attempt Номер попытки (с 1)
+     * @param Priority Приоритет в планировщике, сохраняется для повторов
+     * @param Cancellation Токен отмены: отменённый запрос не повторяется и не учитывается предохранителем
+     * @param bConditional Перепроверять устаревшую запись кэша условным запросом (false - повтор после вытеснения записи)
+     */
+    static void StartWithRetry(const FString& Endpoint, bool bUseCache, int32 Attempt, ERadioGardenRequestPriority Priority,
+        const FRadioGardenCancellationPtr& Cancellation, FRadioGardenHttpCallback&& OnComplete, bool bConditional = true);
+
+    /**
+     * Запустить запрос, OnComplete вызывается прямо в HTTP потоке
+     */
+    static bool StartRequest(const TSharedPtr<IHttpRequest>& Request, FRadioGardenHttpCallback&& OnComplete);
+
+    /**
+     * Запустить запрос с дублированием (FRadioGardenHedgePolicy): если он задерживается, отправляется
+     * копия, OnComplete получает первый ответ, проигравший запрос отменяется.
+     * Отмена токена Cancellation прерывает оба запроса
+     */
+    static void StartHedgedRequest(const TSharedPtr<IHttpRequest>& Request, ERadioGardenEndpointClass EndpointClass,
+        const FRadioGardenCancellationPtr& Cancellation, FRadioGardenHttpCallback&& OnComplete);
+
     /**
      * Выполнить запрос синхронно
      */
-    static bool ExecuteRequestSync(TSharedPtr<IHttpRequest> Request, FString& OutResponse, FString& OutErrorMessage);
+    static bool ExecuteRequestSync(const TSharedPtr<IHttpRequest>& Request, FRadioGardenHttpResult& OutResult);
+
+    /**
+     * Извлечь URL редиректа из результата запроса
+     */
+    static bool ExtractRedirectUrl(const FRadioGardenHttpResult& Result, FString& OutRedirectUrl, FString& OutErrorMessage);
 };
@@ -0,0 +1,591 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <type_traits>
+
+/**
+ * Потоковый (pull) сканер JSON без построения DOM
+ * Читает значения прямо из текста по мере обхода: вызывающий сам решает, какие поля материализовать,
+ * остальные пропускаются без выделения памяти. Строки и числа создаются только при чтении.
+ * Сканер рассчитан на ответы сервера и не проверяет расстановку запятых
+ */
+template <typename CharType>
+class TRadioGardenJsonScanner
+{
+public:
+    /** Тип следующего значения */
+    enum class EValueType : uint8
+    {
+        Invalid,
+        Object,
+        Array,
+        String,
+        Number,
+        Bool,
+        Null
+    };
+
+    explicit TRadioGardenJsonScanner(TStringView<CharType> InText)
+        : Text(InText.GetData())
+        , Length(InText.Len())
+    {
+    }
+
+    /** Произошла ошибка разбора */
+    bool HasError() const
+    {
+        return bError;
+    }
+
+    /** Текущая позиция в тексте */
+    int32 GetPosition() const
+    {
+        return Position;
+    }
+
+    /**
+     * Определить тип следующего значения, не читая его
+     */
+    EValueType PeekValue()
+    {
+        SkipWhitespace();
+        if (bError || Position >= Length)
+        {
+            return EValueType::Invalid;
+        }
+
+        switch (Text[Position])
+        {
+        case '{':
+            return EValueType::Object;
+        case '[':
+            return EValueType::Array;
+        case '"':
+            return EValueType::String;
+        case 't':
+        case 'f':
+            return EValueType::Bool;
+        case 'n':
+            return EValueType::Null;
+        default:
+            return IsNumberChar(Text[Position]) ? EValueType::Number : EValueType::Invalid;
+        }
+    }
+
+    /**
+     * Войти в объект
+     */
+    bool BeginObject()
+    {
+        return Expect('{');
+    }
+
+    /**
+     * Прочитать следующий ключ объекта
+     * @param OutKey Ключ как есть (без декодирования escape-последовательностей)
+     * @return false если объект закончился или произошла ошибка
+     */
+    bool NextKey(TStringView<CharType>& OutKey)
+    {
+        if (!NextMember('}'))
+        {
+            return false;
+        }
+
+        if (!ReadRawString(OutKey))
+        {
+            return false;
+        }
+
+        return Expect(':');
+    }
+
+    /**
+     * Войти в массив
+     */
+    bool BeginArray()
+    {
+        return Expect('[');
+    }
+
+    /**
+     * Перейти к следующему элементу массива
+     * @return false если массив закончился или произошла ошибка
+     */
+    bool NextElement()
+    {
+        return NextMember(']');
+    }
+
+    /**
+     * Прочитать строку с декодированием escape-последовательностей
+     */
+    bool ReadString(FString& OutValue)
+    {
+        TStringView<CharType> Raw;
+        bool bHasEscapes = false;
+        if (!ReadRawString(Raw, &bHasEscapes))
+        {
+            return false;
+        }
+
+        OutValue.Reset();
+        if (!bHasEscapes)
+        {
+            AppendChars(OutValue, Raw.GetData(), Raw.Len());
+            return true;
+        }
+
+        return DecodeEscapedString(Raw, OutValue);
+    }
+
+    /**
+     * Прочитать число
+     */
+    bool ReadNumber(double& OutValue)
+    {
+        SkipWhitespace();
+
+        ANSICHAR Buffer[64];
+        int32 BufferLen = 0;
+        while (Position < Length && IsNumberChar(Text[Position]))
+        {
+            if (BufferLen >= static_cast<int32>(UE_ARRAY_COUNT(Buffer)) - 1)
+            {
+                return SetError();
+            }
+            Buffer[BufferLen++] = static_cast<ANSICHAR>(Text[Position++]);
+        }
+
+        if (BufferLen == 0)
+        {
+            return SetError();
+        }
+
+        Buffer[BufferLen] = '\0';
+        OutValue = FCStringAnsi::Atod(Buffer);
+        return true;
+    }
+
+    /**
+     * Прочитать булево значение
+     */
+    bool ReadBool(bool& OutValue)
+    {
+        SkipWhitespace();
+        if (MatchLiteral("true"))
+        {
+            OutValue = true;
+            return true;
+        }
+        if (MatchLiteral("false"))
+        {
+            OutValue = false;
+            return true;
+        }
+        return SetError();
+    }
+
+    /**
+     * Пропустить следующее значение любого типа
+     */
+    bool SkipValue()
+    {
+        switch (PeekValue())
+        {
+        case EValueType::String:
+        {
+            TStringView<CharType> Raw;
+            return ReadRawString(Raw);
+        }
+        case EValueType::Number:
+        {
+            while (Position < Length && IsNumberChar(Text[Position]))
+            {
+                ++Position;
+            }
+            return true;
+        }
+        case EValueType::Bool:
+        {
+            bool Unused;
+            return ReadBool(Unused);
+        }
+        case EValueType::Null:
+            return MatchLiteral("null") || SetError();
+        case EValueType::Object:
+        case EValueType::Array:
+            return SkipContainer();
+        default:
+            return SetError();
+        }
+    }
+
+    /**
+     * Прочитать массив, не разбирая элементы: вернуть текст каждого элемента верхнего уровня
+     * Элементы затем можно разбирать отдельными сканерами, в том числе параллельно
+     * @param OutElements Текст элементов в порядке следования
+     */
+    bool SplitArray(TArray<TStringView<CharType>>& OutElements)
+    {
+        if (!Expect('['))
+        {
+            return false;
+        }
+
+        int32 Depth = 0;
+        int32 ElementStart = Position;
+        while (Position < Length)
+        {
+            const CharType Char = Text[Position];
+            if (Char == '"')
+            {
+                ++Position;
+                while (Position < Length && Text[Position] != '"')
+                {
+                    Position += (Text[Position] == '\\') ? 2 : 1;
+                }
+            }
+            else if (Char == '{' || Char == '[')
+            {
+                ++Depth;
+            }
+            else if (Char == '}' || Char == ']')
+            {
+                if (Depth == 0)
+                {
+                    AddElement(OutElements, ElementStart, Position);
+                    ++Position;
+                    return true;
+                }
+                --Depth;
+            }
+            else if (Char == ',' && Depth == 0)
+            {
+                AddElement(OutElements, ElementStart, Position);
+                ElementStart = Position + 1;
+            }
+            ++Position;
+        }
+
+        return SetError();
+    }
+
+    /**
+     * Отметить ошибку разбора (например, найденную при разборе элементов отдельными сканерами)
+     */
+    bool SetError()
+    {
+        bError = true;
+        return false;
+    }
+
+    /**
+     * Сравнить ключ с ASCII литералом
+     */
+    static bool KeyEquals(TStringView<CharType> Key, const ANSICHAR* Literal)
+    {
+        int32 Index = 0;
+        for (; Literal[Index] != '\0'; ++Index)
+        {
+            if (Index >= Key.Len() || Key[Index] != static_cast<CharType>(Literal[Index]))
+            {
+                return false;
+            }
+        }
+        return Index == Key.Len();
+    }
+
+private:
+    static bool IsNumberChar(CharType Char)
+    {
+        return (Char >= '0' && Char <= '9') || Char == '-' || Char == '+' || Char == '.' || Char == 'e' || Char == 'E';
+    }
+
+    static void AppendChars(FString& OutValue, const CharType* Chars, int32 Count)
+    {
+        if (Count <= 0)
+        {
+            return;
+        }
+
+        if constexpr (std::is_same_v<CharType, TCHAR>)
+        {
+            OutValue.AppendChars(Chars, Count);
+        }
+        else
+        {
+            const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Chars), Count);
+            OutValue.AppendChars(Converted.Get(), Converted.Length());
+        }
+    }
+
+    void AddElement(TArray<TStringView<CharType>>& OutElements, int32 Start, int32 End) const
+    {
+        while (Start < End && (Text[Start] == ' ' || Text[Start] == '\n' || Text[Start] == '\r' || Text[Start] == '\t'))
+        {
+            ++Start;
+        }
+        if (Start < End)
+        {
+            OutElements.Emplace(Text + Start, End - Start);
+        }
+    }
+
+    void SkipWhitespace()
+    {
+        while (Position < Length)
+        {
+            const CharType Char = Text[Position];
+            if (Char != ' ' && Char != '\n' && Char != '\r' && Char != '\t')
+            {
+                break;
+            }
+            ++Position;
+        }
+    }
+
+    bool Expect(ANSICHAR Char)
+    {
+        SkipWhitespace();
+        if (bError || Position >= Length || Text[Position] != Char)
+        {
+            return SetError();
+        }
+        ++Position;
+        return true;
+    }
+
+    bool MatchLiteral(const ANSICHAR* Literal)
+    {
+        int32 Index = 0;
+        for (; Literal[Index] != '\0'; ++Index)
+        {
+            if (Position + Index >= Length || Text[Position + Index] != static_cast<CharType>(Literal[Index]))
+            {
+                return false;
+            }
+        }
+        Position += Index;
+        return true;
+    }
+
+    // Общая часть NextKey/NextElement: закрывающая скобка завершает контейнер, запятая разделяет элементы
+    bool NextMember(ANSICHAR CloseChar)
+    {
+        SkipWhitespace();
+        if (bError || Position >= Length)
+        {
+            return SetError();
+        }
+
+        if (Text[Position] == CloseChar)
+        {
+            ++Position;
+            return false;
+        }
+
+        if (Text[Position] == ',')
+        {
+            ++Position;
+            SkipWhitespace();
+            if (Position >= Length)
+            {
+                return SetError();
+            }
+        }
+
+        return true;
+    }
+
+    bool ReadRawString(TStringView<CharType>& OutRaw, bool* bOutHasEscapes = nullptr)
+    {
+        if (!Expect('"'))
+        {
+            return false;
+        }
+
+        const int32 Start = Position;
+        bool bHasEscapes = false;
+        while (Position < Length)
+        {
+            const CharType Char = Text[Position];
+            if (Char == '"')
+            {
+                OutRaw = TStringView<CharType>(Text + Start, Position - Start);
+                ++Position;
+                if (bOutHasEscapes)
+                {
+                    *bOutHasEscapes = bHasEscapes;
+                }
+                return true;
+            }
+            if (Char == '\\')
+            {
+                bHasEscapes = true;
+                ++Position;
+            }
+            ++Position;
+        }
+
+        return SetError();
+    }
+
+    bool DecodeEscapedString(TStringView<CharType> Raw, FString& OutValue)
+    {
+        const CharType* Chars = Raw.GetData();
+        const int32 Count = Raw.Len();
+
+        int32 RunStart = 0;
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            if (Chars[Index] != '\\')
+            {
+                continue;
+            }
+
+            AppendChars(OutValue, Chars + RunStart, Index - RunStart);
+
+            if (++Index >= Count)
+            {
+                return SetError();
+            }
+
+            switch (Chars[Index])
+            {
+            case '"': OutValue.AppendChar(TEXT('"')); break;
+            case '\\': OutValue.AppendChar(TEXT('\\')); break;
+            case '/': OutValue.AppendChar(TEXT('/')); break;
+            case 'b': OutValue.AppendChar(TEXT('\b')); break;
+            case 'f': OutValue.AppendChar(TEXT('\f')); break;
+            case 'n': OutValue.AppendChar(TEXT('\n')); break;
+            case 'r': OutValue.AppendChar(TEXT('\r')); break;
+            case 't': OutValue.AppendChar(TEXT('\t')); break;
+            case 'u':
+            {
+                uint32 CodeUnit = 0;
+                if (!ReadHex4(Chars, Count, Index + 1, CodeUnit))
+                {
+                    return SetError();
+                }
+                Index += 4;
+
+                // Суррогатная пара \uD8xx\uDCxx
+                if (CodeUnit >= 0xD800 && CodeUnit <= 0xDBFF && Index + 6 < Count && Chars[Index + 1] == '\\' && Chars[Index + 2] == 'u')
+                {
+                    uint32 LowUnit = 0;
+                    if (ReadHex4(Chars, Count, Index + 3, LowUnit) && LowUnit >= 0xDC00 && LowUnit <= 0xDFFF)
+                    {
+                        const uint32 CodePoint = 0x10000 + ((CodeUnit - 0xD800) << 10) + (LowUnit - 0xDC00);
+                        AppendCodePoint(OutValue, CodePoint);
+                        Index += 6;
+                        break;
+                    }
+                }
+
+                AppendCodePoint(OutValue, CodeUnit);
+                break;
+            }
+            default:
+                return SetError();
+            }
+
+            RunStart = Index + 1;
+        }
+
+        AppendChars(OutValue, Chars + RunStart, Count - RunStart);
+        return true;
+    }
+
+    static bool ReadHex4(const CharType* Chars, int32 Count, int32 Start, uint32& OutValue)
+    {
+        if (Start + 4 > Count)
+        {
+            return false;
+        }
+
+        OutValue = 0;
+        for (int32 Index = Start; Index < Start + 4; ++Index)
+        {
+            const CharType Char = Chars[Index];
+            uint32 Digit = 0;
+            if (Char >= '0' && Char <= '9')
+            {
+                Digit = Char - '0';
+            }
+            else if (Char >= 'a' && Char <= 'f')
+            {
+                Digit = Char - 'a' + 10;
+            }
+            else if (Char >= 'A' && Char <= 'F')
+            {
+                Digit = Char - 'A' + 10;
+            }
+            else
+            {
+                return false;
+            }
+            OutValue = (OutValue << 4) | Digit;
+        }
+        return true;
+    }
+
+    static void AppendCodePoint(FString& OutValue, uint32 CodePoint)
+    {
+        if (CodePoint > 0xFFFF && sizeof(TCHAR) == 2)
+        {
+            CodePoint -= 0x10000;
+            OutValue.AppendChar(static_cast<TCHAR>(0xD800 + (CodePoint >> 10)));
+            OutValue.AppendChar(static_cast<TCHAR>(0xDC00 + (CodePoint & 0x3FF)));
+        }
+        else
+        {
+            OutValue.AppendChar(static_cast<TCHAR>(CodePoint));
+        }
+    }
+
+    // Пропуск объекта или массива по глубине вложенности, без разбора содержимого
+    bool SkipContainer()
+    {
+        int32 Depth = 0;
+        while (Position < Length)
+        {
+            const CharType Char = Text[Position++];
+            if (Char == '"')
+            {
+                while (Position < Length && Text[Position] != '"')
+                {
+                    Position += (Text[Position] == '\\') ? 2 : 1;
+                }
+                ++Position;
+            }
+            else if (Char == '{' || Char == '[')
+            {
+                ++Depth;
+            }
+            else if (Char == '}' || Char == ']')
+            {
+                if (--Depth == 0)
+                {
+                    return true;
+                }
+            }
+        }
+
+        return SetError();
+    }
+
+    /** Текст */
+    const CharType* Text = nullptr;
+
+    /** Длина текста */
+    int32 Length = 0;
+
+    /** Текущая позиция */
+    int32 Position = 0;
+
+    /** Ошибка разбора */
+    bool bError = false;
+};
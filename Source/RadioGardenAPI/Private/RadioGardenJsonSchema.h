@@ -0,0 +1,223 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RadioGardenJsonScanner.h"
+#include <type_traits>
+
+/** Сканер тел ответов (UTF-8) */
+using FRadioGardenJsonScanner = TRadioGardenJsonScanner<UTF8CHAR>;
+
+/**
+ * Хэш ключа JSON (FNV-1a), для литералов вычисляется на этапе компиляции
+ */
+constexpr uint32 RadioGardenHashKey(const ANSICHAR* Key)
+{
+    uint32 Hash = 2166136261u;
+    for (int32 Index = 0; Key[Index] != '\0'; ++Index)
+    {
+        Hash = (Hash ^ static_cast<uint8>(Key[Index])) * 16777619u;
+    }
+    return Hash;
+}
+
+/**
+ * Хэш ключа, прочитанного сканером
+ */
+inline uint32 RadioGardenHashKey(FUtf8StringView Key)
+{
+    uint32 Hash = 2166136261u;
+    for (int32 Index = 0; Index < Key.Len(); ++Index)
+    {
+        Hash = (Hash ^ static_cast<uint8>(Key[Index])) * 16777619u;
+    }
+    return Hash;
+}
+
+/**
+ * Поле схемы: ключ JSON и функция, читающая значение в структуру
+ */
+template <typename StructType>
+struct TRadioGardenJsonField
+{
+    using FReadFunc = void (*)(FRadioGardenJsonScanner&, StructType&);
+
+    /** Хэш ключа */
+    uint32 KeyHash;
+
+    /** Ключ (для проверки при совпадении хэша) */
+    const ANSICHAR* Key;
+
+    /** Чтение значения */
+    FReadFunc Read;
+};
+
+/**
+ * Чтение значений по типу поля структуры
+ * Значение другого типа пропускается, поле сохраняет значение по умолчанию
+ */
+namespace RadioGardenJsonSchema
+{
+    inline void ReadValue(FRadioGardenJsonScanner& Scanner, FString& OutValue)
+    {
+        if (Scanner.PeekValue() == FRadioGardenJsonScanner::EValueType::String)
+        {
+            Scanner.ReadString(OutValue);
+        }
+        else
+        {
+            Scanner.SkipValue();
+        }
+    }
+
+    inline void ReadValue(FRadioGardenJsonScanner& Scanner, double& OutValue)
+    {
+        if (Scanner.PeekValue() == FRadioGardenJsonScanner::EValueType::Number)
+        {
+            Scanner.ReadNumber(OutValue);
+        }
+        else
+        {
+            Scanner.SkipValue();
+        }
+    }
+
+    inline void ReadValue(FRadioGardenJsonScanner& Scanner, float& OutValue)
+    {
+        double Value = OutValue;
+        ReadValue(Scanner, Value);
+        OutValue = static_cast<float>(Value);
+    }
+
+    inline void ReadValue(FRadioGardenJsonScanner& Scanner, int32& OutValue)
+    {
+        double Value = OutValue;
+        ReadValue(Scanner, Value);
+        OutValue = static_cast<int32>(Value);
+    }
+
+    inline void ReadValue(FRadioGardenJsonScanner& Scanner, bool& OutValue)
+    {
+        if (Scanner.PeekValue() == FRadioGardenJsonScanner::EValueType::Bool)
+        {
+            Scanner.ReadBool(OutValue);
+        }
+        else
+        {
+            Scanner.SkipValue();
+        }
+    }
+
+    template <typename MemberPointerType>
+    struct TMemberTraits;
+
+    template <typename StructType, typename MemberType>
+    struct TMemberTraits<MemberType StructType::*>
+    {
+        using FStruct = StructType;
+    };
+
+    template <auto Member>
+    using TMemberStruct = typename TMemberTraits<decltype(Member)>::FStruct;
+
+    template <auto Member>
+    void ReadMember(FRadioGardenJsonScanner& Scanner, TMemberStruct<Member>& OutStruct)
+    {
+        ReadValue(Scanner, OutStruct.*Member);
+    }
+
+    /**
+     * Прочитать объект по таблице полей за один проход
+     * Ключ хэшируется один раз и сравнивается с заранее посчитанными хэшами таблицы
+     * @return Маска полей таблицы, встретившихся в объекте (бит = индекс поля)
+     */
+    template <typename StructType, int32 FieldCount>
+    uint64 ReadObject(FRadioGardenJsonScanner& Scanner, StructType& OutStruct, const TRadioGardenJsonField<StructType> (&Fields)[FieldCount])
+    {
+        static_assert(FieldCount <= 64, "Too many fields in JSON schema");
+
+        if (Scanner.PeekValue() != FRadioGardenJsonScanner::EValueType::Object)
+        {
+            Scanner.SkipValue();
+            return 0;
+        }
+
+        Scanner.BeginObject();
+
+        uint64 SeenMask = 0;
+        FUtf8StringView Key;
+        while (Scanner.NextKey(Key))
+        {
+            const uint32 KeyHash = RadioGardenHashKey(Key);
+
+            int32 FieldIndex = 0;
+            for (; FieldIndex < FieldCount; ++FieldIndex)
+            {
+                if (Fields[FieldIndex].KeyHash == KeyHash && FRadioGardenJsonScanner::KeyEquals(Key, Fields[FieldIndex].Key))
+                {
+                    break;
+                }
+            }
+
+            if (FieldIndex < FieldCount)
+            {
+                Fields[FieldIndex].Read(Scanner, OutStruct);
+                SeenMask |= 1ull << FieldIndex;
+            }
+            else
+            {
+                Scanner.SkipValue();
+            }
+        }
+
+        return SeenMask;
+    }
+
+    template <typename TableType>
+    struct TTableTraits;
+
+    template <typename StructType, SIZE_T FieldCount>
+    struct TTableTraits<const TRadioGardenJsonField<StructType>[FieldCount]>
+    {
+        using FStruct = StructType;
+    };
+
+    template <const auto& Fields>
+    using TTableStruct = typename TTableTraits<std::remove_reference_t<decltype(Fields)>>::FStruct;
+
+    template <const auto& Fields>
+    void ReadNested(FRadioGardenJsonScanner& Scanner, TTableStruct<Fields>& OutStruct)
+    {
+        ReadObject(Scanner, OutStruct, Fields);
+    }
+}
+
+/**
+ * Поле, значение которого пишется в член структуры
+ * Пример: RadioGardenJsonField<&FRadioGardenPlace::Title>("title")
+ */
+template <auto Member>
+constexpr TRadioGardenJsonField<RadioGardenJsonSchema::TMemberStruct<Member>> RadioGardenJsonField(const ANSICHAR* Key)
+{
+    return { RadioGardenHashKey(Key), Key, &RadioGardenJsonSchema::ReadMember<Member> };
+}
+
+/**
+ * Поле-объект, поля которого по своей таблице пишутся в ту же структуру
+ * Пример: RadioGardenJsonNestedField<ChannelPlaceFields>("place")
+ */
+template <const auto& Fields>
+constexpr TRadioGardenJsonField<RadioGardenJsonSchema::TTableStruct<Fields>> RadioGardenJsonNestedField(const ANSICHAR* Key)
+{
+    return { RadioGardenHashKey(Key), Key, &RadioGardenJsonSchema::ReadNested<Fields> };
+}
+
+/**
+ * Поле со своей функцией чтения (для значений, не ложащихся в один член)
+ */
+template <typename StructType>
+constexpr TRadioGardenJsonField<StructType> RadioGardenJsonCustomField(const ANSICHAR* Key, typename TRadioGardenJsonField<StructType>::FReadFunc Read)
+{
+    return { RadioGardenHashKey(Key), Key, Read };
+}
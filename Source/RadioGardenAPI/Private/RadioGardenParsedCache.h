@@ -0,0 +1,107 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeLock.h"
+
+/**
+ * Кэш распаршенных ответов, привязанный к версии содержимого в кэше HTTP ответов
+ * Если кэш ответов вернул ту же версию (свежая запись или 304), повторный парсинг не нужен
+ */
+template <typename ResultType>
+class TRadioGardenParsedCache
+{
+public:
+    using FResultRef = TSharedRef<const ResultType, ESPMode::ThreadSafe>;
+    using FResultPtr = TSharedPtr<const ResultType, ESPMode::ThreadSafe>;
+
+    /** Максимальное число хранимых ответов */
+    static constexpr int32 MaxEntries = 64;
+
+    /**
+     * Найти ответ, распаршенный из указанной версии содержимого
+     * @param Key Ключ (эндпоинт)
+     * @param Version Версия содержимого
+     */
+    FResultPtr Find(const FString& Key, uint64 Version)
+    {
+        if (Version == 0)
+        {
+            return nullptr;
+        }
+
+        FScopeLock Lock(&CriticalSection);
+
+        FEntry* Entry = Entries.Find(Key);
+        if (!Entry || Entry->Version != Version)
+        {
+            return nullptr;
+        }
+
+        Entry->LastAccess = ++AccessCounter;
+        return Entry->Result;
+    }
+
+    /**
+     * Сохранить распаршенный ответ
+     * @param Key Ключ (эндпоинт)
+     * @param Version Версия содержимого
+     * @param Result Распаршенный ответ
+     */
+    void Add(const FString& Key, uint64 Version, const FResultRef& Result)
+    {
+        if (Version == 0)
+        {
+            return;
+        }
+
+        FScopeLock Lock(&CriticalSection);
+
+        FEntry& Entry = Entries.Add(Key);
+        Entry.Version = Version;
+        Entry.LastAccess = ++AccessCounter;
+        Entry.Result = Result;
+
+        if (Entries.Num() > MaxEntries)
+        {
+            const FString* OldestKey = nullptr;
+            uint64 OldestAccess = MAX_uint64;
+            for (const TPair<FString, FEntry>& Pair : Entries)
+            {
+                if (Pair.Value.LastAccess < OldestAccess)
+                {
+                    OldestKey = &Pair.Key;
+                    OldestAccess = Pair.Value.LastAccess;
+                }
+            }
+            Entries.Remove(FString(*OldestKey));
+        }
+    }
+
+    /**
+     * Удалить все ответы
+     */
+    void Empty()
+    {
+        FScopeLock Lock(&CriticalSection);
+        Entries.Empty();
+    }
+
+private:
+    struct FEntry
+    {
+        uint64 Version = 0;
+        uint64 LastAccess = 0;
+        FResultPtr Result;
+    };
+
+    /** Ответы по ключу */
+    TMap<FString, FEntry> Entries;
+
+    /** Счётчик обращений для LRU */
+    uint64 AccessCounter = 0;
+
+    /** Защита состояния */
+    FCriticalSection CriticalSection;
+};
@@ -0,0 +1,525 @@
+// by Neil Moore
+
+#include "RadioGardenPlacesCatalog.h"
+#include "RadioGardenHttpRequest.h"
+#include "RadioGardenResponseCache.h"
+#include "Async/Async.h"
+#include "Hash/xxhash.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Interfaces/IPluginManager.h"
+
+namespace
+{
+    // Формат снимка (little-endian):
+    //   FCatalogFileHeader
+    //   FCatalogPlaceRecord[PlaceCount] - записи фиксированной ширины
+    //   таблица строк UTF-8, на которую ссылаются записи (одинаковые строки хранятся один раз)
+
+    struct FCatalogFileHeader
+    {
+        uint32 Magic = 0;
+        uint32 FormatVersion = 0;
+        uint32 PlaceCount = 0;
+        uint32 RecordSize = 0;
+        uint32 RecordsOffset = 0;
+        uint32 StringTableOffset = 0;
+        uint32 StringTableSize = 0;
+        uint32 Reserved = 0;
+        int64 CreatedUnixTime = 0;
+    };
+    static_assert(sizeof(FCatalogFileHeader) == 40, "Catalog header layout changed");
+
+    struct FCatalogStringRef
+    {
+        uint32 Offset = 0;
+        uint32 Length = 0;
+    };
+
+    struct FCatalogPlaceRecord
+    {
+        double Longitude = 0.0;
+        double Latitude = 0.0;
+        int32 Size = 0;
+        uint32 Flags = 0;
+        FCatalogStringRef Id;
+        FCatalogStringRef Title;
+        FCatalogStringRef Country;
+        FCatalogStringRef Url;
+    };
+    static_assert(sizeof(FCatalogPlaceRecord) == 56, "Catalog record layout changed");
+
+    constexpr uint32 CatalogPlaceFlagBoost = 1 << 0;
+
+    // Задержка повторной попытки обновления после ошибки (секунды)
+    constexpr double CatalogRefreshRetryDelay = 60.0;
+
+    // Построитель таблицы строк с дедупликацией
+    class FCatalogStringTableBuilder
+    {
+    public:
+        FCatalogStringRef Add(const FString& Value)
+        {
+            if (Value.IsEmpty())
+            {
+                return FCatalogStringRef();
+            }
+
+            if (const FCatalogStringRef* Existing = Known.Find(Value))
+            {
+                return *Existing;
+            }
+
+            const FTCHARToUTF8 Converted(*Value, Value.Len());
+
+            FCatalogStringRef Ref;
+            Ref.Offset = static_cast<uint32>(Bytes.Num());
+            Ref.Length = static_cast<uint32>(Converted.Length());
+            Bytes.Append(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+
+            Known.Add(Value, Ref);
+            return Ref;
+        }
+
+        TArray<uint8> Bytes;
+
+    private:
+        TMap<FString, FCatalogStringRef> Known;
+    };
+
+    bool ReadCatalogString(const uint8* StringTable, uint32 StringTableSize, const FCatalogStringRef& Ref, FString& OutValue)
+    {
+        if (Ref.Offset > StringTableSize || Ref.Length > StringTableSize - Ref.Offset)
+        {
+            return false;
+        }
+
+        if (Ref.Length == 0)
+        {
+            OutValue.Reset();
+            return true;
+        }
+
+        const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(StringTable + Ref.Offset), Ref.Length);
+        OutValue = FString(Converted.Length(), Converted.Get());
+        return true;
+    }
+
+    // Хэш содержимого списка мест: снимок с диска и ответ сети сравниваются по нему, а не по указателю
+    uint64 HashCatalogPlaces(const TArray<FRadioGardenPlace>& Places)
+    {
+        FXxHash64Builder Builder;
+
+        const auto UpdateString = [&Builder](const FString& Value)
+        {
+            const int32 Length = Value.Len();
+            Builder.Update(&Length, sizeof(Length));
+            Builder.Update(*Value, Length * sizeof(TCHAR));
+        };
+
+        for (const FRadioGardenPlace& Place : Places)
+        {
+            const uint8 bBoost = Place.bBoost ? 1 : 0;
+            Builder.Update(&Place.Geo.Longitude, sizeof(Place.Geo.Longitude));
+            Builder.Update(&Place.Geo.Latitude, sizeof(Place.Geo.Latitude));
+            Builder.Update(&Place.Size, sizeof(Place.Size));
+            Builder.Update(&bBoost, sizeof(bBoost));
+            UpdateString(Place.Id);
+            UpdateString(Place.Title);
+            UpdateString(Place.Country);
+            UpdateString(Place.Url);
+        }
+
+        return Builder.Finalize().Hash;
+    }
+
+    bool ParseCatalogSnapshot(const uint8* Data, int64 DataSize, TArray<FRadioGardenPlace>& OutPlaces)
+    {
+        if (DataSize < static_cast<int64>(sizeof(FCatalogFileHeader)))
+        {
+            return false;
+        }
+
+        FCatalogFileHeader Header;
+        FMemory::Memcpy(&Header, Data, sizeof(Header));
+
+        if (Header.Magic != FRadioGardenPlacesCatalog::SnapshotMagic
+            || Header.FormatVersion != FRadioGardenPlacesCatalog::SnapshotFormatVersion
+            || Header.RecordSize != sizeof(FCatalogPlaceRecord))
+        {
+            return false;
+        }
+
+        const int64 RecordsEnd = static_cast<int64>(Header.RecordsOffset) + static_cast<int64>(Header.PlaceCount) * sizeof(FCatalogPlaceRecord);
+        const int64 StringTableEnd = static_cast<int64>(Header.StringTableOffset) + Header.StringTableSize;
+        if (RecordsEnd > DataSize || StringTableEnd > DataSize)
+        {
+            return false;
+        }
+
+        const uint8* StringTable = Data + Header.StringTableOffset;
+
+        OutPlaces.Reset(Header.PlaceCount);
+        for (uint32 Index = 0; Index < Header.PlaceCount; ++Index)
+        {
+            FCatalogPlaceRecord Record;
+            FMemory::Memcpy(&Record, Data + Header.RecordsOffset + Index * sizeof(FCatalogPlaceRecord), sizeof(Record));
+
+            FRadioGardenPlace& Place = OutPlaces.AddDefaulted_GetRef();
+            Place.Geo.Longitude = Record.Longitude;
+            Place.Geo.Latitude = Record.Latitude;
+            Place.Size = Record.Size;
+            Place.bBoost = (Record.Flags & CatalogPlaceFlagBoost) != 0;
+
+            if (!ReadCatalogString(StringTable, Header.StringTableSize, Record.Id, Place.Id)
+                || !ReadCatalogString(StringTable, Header.StringTableSize, Record.Title, Place.Title)
+                || !ReadCatalogString(StringTable, Header.StringTableSize, Record.Country, Place.Country)
+                || !ReadCatalogString(StringTable, Header.StringTableSize, Record.Url, Place.Url))
+            {
+                OutPlaces.Reset();
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+static FAutoConsoleCommand CmdRadioGardenCatalogSaveBundled(
+    TEXT("RadioGarden.Catalog.SaveBundled"),
+    TEXT("Записать текущий каталог мест в Resources/Catalog плагина, чтобы он попал в сборку"),
+    FConsoleCommandDelegate::CreateLambda([]()
+    {
+        const FRadioGardenPlacesCatalog::FPlacesPtr Places = FRadioGardenPlacesCatalog::Get().GetPlaces();
+        if (!Places.IsValid())
+        {
+            UE_LOG(LogRadioGardenAPI, Warning, TEXT("Places catalog is not loaded yet"));
+            return;
+        }
+
+        FRadioGardenPlacesCatalog::SaveSnapshot(Places->Places, FRadioGardenPlacesCatalog::GetBundledSnapshotPath());
+    }));
+
+FRadioGardenPlacesCatalog& FRadioGardenPlacesCatalog::Get()
+{
+    static FRadioGardenPlacesCatalog Instance;
+    return Instance;
+}
+
+FRadioGardenPlacesCatalog::FPlacesPtr FRadioGardenPlacesCatalog::GetPlaces()
+{
+    {
+        FScopeLock Lock(&CriticalSection);
+        if (bDiskLoadAttempted)
+        {
+            return Current;
+        }
+    }
+
+    LoadFromDisk();
+
+    FScopeLock Lock(&CriticalSection);
+    return Current;
+}
+
+uint64 FRadioGardenPlacesCatalog::GetVersion() const
+{
+    return Version.load(std::memory_order_acquire);
+}
+
+uint64 FRadioGardenPlacesCatalog::GetVersion(const FPlacesRef& Places)
+{
+    // Список и версия меняются вместе под блокировкой
+    FScopeLock Lock(&CriticalSection);
+    return Current.Get() == &Places.Get() ? Version.load(std::memory_order_relaxed) : 0;
+}
+
+FRadioGardenPlacesCatalog::FIndexRef FRadioGardenPlacesCatalog::GetIndex(const FPlacesRef& Places)
+{
+    {
+        FScopeLock Lock(&CriticalSection);
+        if (PlacesIndex.IsValid() && &PlacesIndex->GetPlaces() == &Places.Get())
+        {
+            return PlacesIndex.ToSharedRef();
+        }
+    }
+
+    // Строим вне блокировки: получение списка мест не должно ждать построения индекса
+    const FIndexRef NewIndex = MakeShared<const FRadioGardenPlacesIndex, ESPMode::ThreadSafe>(Places);
+
+    FScopeLock Lock(&CriticalSection);
+    if (Current.Get() == &Places.Get())
+    {
+        PlacesIndex = NewIndex;
+    }
+    return NewIndex;
+}
+
+FRadioGardenPlacesCatalog::FClustersRef FRadioGardenPlacesCatalog::GetClusters(const FPlacesRef& Places)
+{
+    {
+        FScopeLock Lock(&CriticalSection);
+        if (PlacesClusters.IsValid() && &PlacesClusters->GetPlaces() == &Places.Get())
+        {
+            return PlacesClusters.ToSharedRef();
+        }
+    }
+
+    const FClustersRef NewClusters = MakeShared<const FRadioGardenPlacesClusters, ESPMode::ThreadSafe>(Places);
+
+    FScopeLock Lock(&CriticalSection);
+    if (Current.Get() == &Places.Get())
+    {
+        PlacesClusters = NewClusters;
+    }
+    return NewClusters;
+}
+
+bool FRadioGardenPlacesCatalog::TryBeginRefresh()
+{
+    FScopeLock Lock(&CriticalSection);
+
+    if (bRefreshInFlight)
+    {
+        return false;
+    }
+
+    const double TimeToLive = FRadioGardenResponseCache::GetTimeToLive(ERadioGardenEndpointClass::Places);
+    if (LastRefreshTime > 0.0 && FPlatformTime::Seconds() - LastRefreshTime < TimeToLive)
+    {
+        return false;
+    }
+
+    bRefreshInFlight = true;
+    return true;
+}
+
+void FRadioGardenPlacesCatalog::FinishRefresh(const FPlacesRef& Places)
+{
+    {
+        FScopeLock Lock(&CriticalSection);
+        bRefreshInFlight = false;
+
+        if (!Places->bSuccessful)
+        {
+            // Оставляем прежний каталог и пробуем снова чуть позже
+            const double TimeToLive = FRadioGardenResponseCache::GetTimeToLive(ERadioGardenEndpointClass::Places);
+            LastRefreshTime = FPlatformTime::Seconds() - TimeToLive + CatalogRefreshRetryDelay;
+            UE_LOG(LogRadioGardenAPI, Warning, TEXT("Places catalog refresh failed: %s"), *Places->ErrorMessage);
+            return;
+        }
+    }
+
+    Update(Places);
+}
+
+void FRadioGardenPlacesCatalog::Update(const FPlacesRef& Places)
+{
+    {
+        FScopeLock Lock(&CriticalSection);
+
+        bDiskLoadAttempted = true;
+        LastRefreshTime = FPlatformTime::Seconds();
+
+        // Неизменившийся ответ (свежий кэш или 304) приходит тем же распаршенным объектом
+        if (Current == Places)
+        {
+            return;
+        }
+    }
+
+    // Ответ с тем же содержимым, что и снимок с диска (обычное первое обновление после запуска), каталог не меняет:
+    // версия, кэш ближайших станций, индекс, кластеры и файл снимка остаются прежними
+    const uint64 NewContentHash = HashCatalogPlaces(Places->Places);
+
+    {
+        FScopeLock Lock(&CriticalSection);
+
+        if (Current.IsValid() && ContentHash == NewContentHash)
+        {
+            UE_LOG(LogRadioGardenAPI, Verbose, TEXT("Places catalog refreshed: content unchanged"));
+            return;
+        }
+
+        Current = Places;
+        ContentHash = NewContentHash;
+        PlacesIndex.Reset();
+        PlacesClusters.Reset();
+        Version.fetch_add(1, std::memory_order_release);
+    }
+
+    UE_LOG(LogRadioGardenAPI, Log, TEXT("Places catalog updated: %d places"), Places->Places.Num());
+
+    // Запись снимка - десятки миллисекунд сериализации и диска, вызывающий (HTTP поток или игровой) их не ждёт
+    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [this, Places]()
+    {
+        FScopeLock SaveLock(&SaveCriticalSection);
+
+        // Каталог успел смениться ещё раз: его снимок запишет следующая задача
+        {
+            FScopeLock Lock(&CriticalSection);
+            if (Current.Get() != &Places.Get())
+            {
+                return;
+            }
+        }
+
+        SaveSnapshot(Places->Places, GetSavedSnapshotPath());
+    });
+}
+
+bool FRadioGardenPlacesCatalog::SaveSnapshot(const TArray<FRadioGardenPlace>& Places, const FString& Filename)
+{
+    FCatalogStringTableBuilder Strings;
+
+    TArray<FCatalogPlaceRecord> Records;
+    Records.Reserve(Places.Num());
+    for (const FRadioGardenPlace& Place : Places)
+    {
+        FCatalogPlaceRecord& Record = Records.AddDefaulted_GetRef();
+        Record.Longitude = Place.Geo.Longitude;
+        Record.Latitude = Place.Geo.Latitude;
+        Record.Size = Place.Size;
+        Record.Flags = Place.bBoost ? CatalogPlaceFlagBoost : 0;
+        Record.Id = Strings.Add(Place.Id);
+        Record.Title = Strings.Add(Place.Title);
+        Record.Country = Strings.Add(Place.Country);
+        Record.Url = Strings.Add(Place.Url);
+    }
+
+    FCatalogFileHeader Header;
+    Header.Magic = SnapshotMagic;
+    Header.FormatVersion = SnapshotFormatVersion;
+    Header.PlaceCount = static_cast<uint32>(Records.Num());
+    Header.RecordSize = sizeof(FCatalogPlaceRecord);
+    Header.RecordsOffset = sizeof(FCatalogFileHeader);
+    Header.StringTableOffset = Header.RecordsOffset + Records.Num() * sizeof(FCatalogPlaceRecord);
+    Header.StringTableSize = static_cast<uint32>(Strings.Bytes.Num());
+    Header.CreatedUnixTime = FDateTime::UtcNow().ToUnixTimestamp();
+
+    TArray<uint8> Data;
+    Data.Reserve(Header.StringTableOffset + Header.StringTableSize);
+    Data.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+    Data.Append(reinterpret_cast<const uint8*>(Records.GetData()), Records.Num() * sizeof(FCatalogPlaceRecord));
+    Data.Append(Strings.Bytes);
+
+    // Пишем во временный файл и подменяем: читающий снимок не должен увидеть половину записи
+    const FString TempFilename = Filename + TEXT(".tmp");
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(Filename), true);
+
+    if (!FFileHelper::SaveArrayToFile(Data, *TempFilename) || !IFileManager::Get().Move(*Filename, *TempFilename, true, true))
+    {
+        UE_LOG(LogRadioGardenAPI, Warning, TEXT("Failed to save places snapshot: %s"), *Filename);
+        IFileManager::Get().Delete(*TempFilename);
+        return false;
+    }
+
+    UE_LOG(LogRadioGardenAPI, Verbose, TEXT("Places snapshot saved: %s (%d places, %d bytes)"), *Filename, Records.Num(), Data.Num());
+    return true;
+}
+
+bool FRadioGardenPlacesCatalog::LoadSnapshot(const FString& Filename, TArray<FRadioGardenPlace>& OutPlaces)
+{
+    if (!FPlatformFileManager::Get().GetPlatformFile().FileExists(*Filename))
+    {
+        return false;
+    }
+
+    // Места всё равно разбираются в FRadioGardenPlace со своими строками, и снимок нужен только на время разбора,
+    // поэтому файл читается одним последовательным чтением, а не отображается в память
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *Filename))
+    {
+        return false;
+    }
+
+    if (!ParseCatalogSnapshot(Data.GetData(), Data.Num(), OutPlaces))
+    {
+        UE_LOG(LogRadioGardenAPI, Warning, TEXT("Places snapshot is invalid or has an old format: %s"), *Filename);
+        return false;
+    }
+
+    return true;
+}
+
+FString FRadioGardenPlacesCatalog::GetSavedSnapshotPath()
+{
+    return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("RadioGarden"), TEXT("Places.rgcat"));
+}
+
+FString FRadioGardenPlacesCatalog::GetBundledSnapshotPath()
+{
+    const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("RadioGardenAPI"));
+    if (!Plugin.IsValid())
+    {
+        return FString();
+    }
+
+    return FPaths::Combine(Plugin->GetBaseDir(), TEXT("Resources"), TEXT("Catalog"), TEXT("Places.rgcat"));
+}
+
+void FRadioGardenPlacesCatalog::LoadFromDisk()
+{
+    FScopeLock DiskLoadLock(&DiskLoadCriticalSection);
+
+    {
+        FScopeLock Lock(&CriticalSection);
+        if (bDiskLoadAttempted)
+        {
+            return;
+        }
+    }
+
+    // Разбор снимка занимает миллисекунды: версия, индекс и обновление из сети его не ждут
+    FPlacesPtr Loaded;
+    uint64 LoadedContentHash = 0;
+    FString LoadedFilename;
+    const double StartTime = FPlatformTime::Seconds();
+
+    // Снимок из Saved новее поставляемого со сборкой
+    for (const FString& Filename : { GetSavedSnapshotPath(), GetBundledSnapshotPath() })
+    {
+        if (Filename.IsEmpty())
+        {
+            continue;
+        }
+
+        TSharedRef<FRadioGardenPlacesResponse, ESPMode::ThreadSafe> Snapshot = MakeShared<FRadioGardenPlacesResponse, ESPMode::ThreadSafe>();
+        if (LoadSnapshot(Filename, Snapshot->Places))
+        {
+            Snapshot->Status = ERadioGardenStatus::Success;
+            Snapshot->bSuccessful = true;
+            LoadedContentHash = HashCatalogPlaces(Snapshot->Places);
+            Loaded = Snapshot;
+            LoadedFilename = Filename;
+            break;
+        }
+    }
+
+    {
+        FScopeLock Lock(&CriticalSection);
+
+        // Пока читался файл, мог прийти список из сети: он новее снимка
+        if (bDiskLoadAttempted)
+        {
+            return;
+        }
+
+        bDiskLoadAttempted = true;
+        if (!Loaded.IsValid())
+        {
+            return;
+        }
+
+        Current = Loaded;
+        ContentHash = LoadedContentHash;
+        Version.fetch_add(1, std::memory_order_release);
+    }
+
+    UE_LOG(LogRadioGardenAPI, Log, TEXT("Places catalog loaded from %s: %d places in %.1f ms"),
+        *LoadedFilename, Loaded->Places.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
@@ -0,0 +1,152 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RadioGardenTypes.h"
+#include "RadioGardenPlacesIndex.h"
+#include "RadioGardenPlacesClusters.h"
+#include <atomic>
+
+/**
+ * Каталог мест Radio Garden
+ * Хранит текущий список мест и его бинарный снимок на диске. При первом обращении снимок
+ * читается с диска и отдаётся сразу, без сетевого запроса, затем каталог обновляется в фоне.
+ * Снимок ищется в Saved/RadioGarden, затем в Resources/Catalog плагина (попадает в сборку)
+ */
+class FRadioGardenPlacesCatalog
+{
+public:
+    using FPlacesRef = TSharedRef<const FRadioGardenPlacesResponse, ESPMode::ThreadSafe>;
+    using FPlacesPtr = TSharedPtr<const FRadioGardenPlacesResponse, ESPMode::ThreadSafe>;
+    using FIndexRef = FRadioGardenPlacesIndex::FIndexRef;
+    using FClustersRef = FRadioGardenPlacesClusters::FClustersRef;
+
+    /** Сигнатура файла снимка ("RGPC") */
+    static constexpr uint32 SnapshotMagic = 0x43504752;
+
+    /** Версия формата файла снимка */
+    static constexpr uint32 SnapshotFormatVersion = 1;
+
+    /**
+     * Получить экземпляр каталога
+     */
+    static FRadioGardenPlacesCatalog& Get();
+
+    /**
+     * Получить текущий список мест
+     * При первом вызове загружает снимок с диска
+     * @return nullptr если каталог ещё не загружен ни с диска, ни из сети
+     */
+    FPlacesPtr GetPlaces();
+
+    /**
+     * Версия каталога, увеличивается при каждой замене списка мест (0 если каталог пуст)
+     * Не блокирует: безопасно вызывать из игрового потока, пока снимок загружается с диска
+     */
+    uint64 GetVersion() const;
+
+    /**
+     * Версия каталога, если список мест - текущий список каталога
+     * @param Places Список мест (обычно результат GetPlaces или обновления из сети)
+     * @return 0 если каталог успел смениться или список в него не попал
+     */
+    uint64 GetVersion(const FPlacesRef& Places);
+
+    /**
+     * Получить пространственный индекс списка мест
+     * Индекс текущего каталога строится один раз на версию и переиспользуется всеми запросами
+     * @param Places Список мест (обычно результат GetPlaces)
+     */
+    FIndexRef GetIndex(const FPlacesRef& Places);
+
+    /**
+     * Получить кластеры списка мест для отображения на глобусе
+     * Как и индекс, строятся один раз на версию каталога
+     * @param Places Список мест (обычно результат GetPlaces)
+     */
+    FClustersRef GetClusters(const FPlacesRef& Places);
+
+    /**
+     * Начать фоновое обновление, если каталог устарел
+     * @return true если вызывающий должен запросить список мест из сети
+     */
+    bool TryBeginRefresh();
+
+    /**
+     * Завершить фоновое обновление
+     * @param Places Результат запроса списка мест
+     */
+    void FinishRefresh(const FPlacesRef& Places);
+
+    /**
+     * Принять список мест, полученный из сети
+     * Если содержимое изменилось (сравнивается хэш мест, а не объект ответа), каталог заменяется,
+     * а снимок перезаписывается на диске в фоновой задаче; иначе остаётся прежний список и его версия
+     * @param Places Успешный ответ со списком мест
+     */
+    void Update(const FPlacesRef& Places);
+
+    /**
+     * Записать бинарный снимок мест в файл
+     * @param Places Места
+     * @param Filename Путь к файлу
+     * @return true если файл записан
+     */
+    static bool SaveSnapshot(const TArray<FRadioGardenPlace>& Places, const FString& Filename);
+
+    /**
+     * Прочитать бинарный снимок мест из файла
+     * @param Filename Путь к файлу
+     * @param OutPlaces Места
+     * @return true если файл прочитан и прошёл проверку
+     */
+    static bool LoadSnapshot(const FString& Filename, TArray<FRadioGardenPlace>& OutPlaces);
+
+    /**
+     * Путь к снимку, обновляемому во время работы
+     */
+    static FString GetSavedSnapshotPath();
+
+    /**
+     * Путь к снимку, поставляемому вместе со сборкой
+     */
+    static FString GetBundledSnapshotPath();
+
+private:
+    /** Загрузить снимок с диска: разбор идёт вне блокировки состояния, под ней только подмена списка */
+    void LoadFromDisk();
+
+    /** Текущий список мест */
+    FPlacesPtr Current;
+
+    /** Версия каталога */
+    std::atomic<uint64> Version{0};
+
+    /** Хэш содержимого текущего списка мест */
+    uint64 ContentHash = 0;
+
+    /** Индекс текущего списка мест (строится при первом запросе) */
+    TSharedPtr<const FRadioGardenPlacesIndex, ESPMode::ThreadSafe> PlacesIndex;
+
+    /** Кластеры текущего списка мест (строятся при первом запросе) */
+    TSharedPtr<const FRadioGardenPlacesClusters, ESPMode::ThreadSafe> PlacesClusters;
+
+    /** Попытка загрузки с диска уже выполнялась */
+    bool bDiskLoadAttempted = false;
+
+    /** Идёт фоновое обновление */
+    bool bRefreshInFlight = false;
+
+    /** Время последнего обновления из сети (FPlatformTime::Seconds, 0 если не обновлялся) */
+    double LastRefreshTime = 0.0;
+
+    /** Защита состояния */
+    FCriticalSection CriticalSection;
+
+    /** Один загрузчик снимка с диска: остальные первые вызовы GetPlaces ждут его результата */
+    FCriticalSection DiskLoadCriticalSection;
+
+    /** Фоновые записи снимка идут по одной: они пишут в один и тот же файл */
+    FCriticalSection SaveCriticalSection;
+};
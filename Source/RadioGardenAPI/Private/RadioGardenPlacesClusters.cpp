@@ -0,0 +1,212 @@
+// by Neil Moore
+
+#include "RadioGardenPlacesClusters.h"
+#include "Algo/BinarySearch.h"
+
+namespace
+{
+    int32 GetClusterRows(int32 Level)
+    {
+        return 1 << Level;
+    }
+
+    int32 GetClusterColumns(int32 Level)
+    {
+        return 2 << Level;
+    }
+
+    int32 GetClusterRow(int32 Level, double Latitude)
+    {
+        const int32 Rows = GetClusterRows(Level);
+        return FMath::Clamp(FMath::FloorToInt32((Latitude + 90.0) / 180.0 * Rows), 0, Rows - 1);
+    }
+
+    int32 GetClusterColumn(int32 Level, double Longitude)
+    {
+        const int32 Columns = GetClusterColumns(Level);
+        return FMath::Clamp(FMath::FloorToInt32((FMath::UnwindDegrees(Longitude) + 180.0) / 360.0 * Columns), 0, Columns - 1);
+    }
+
+    // Накопитель кластера при построении: сумма векторов не нормирована, чтобы слияние ячеек было сложением
+    struct FClusterAccumulator
+    {
+        FVector WeightedSum = FVector::ZeroVector;
+        int32 TotalSize = 0;
+        int32 PlaceCount = 0;
+        int32 RepresentativePlace = INDEX_NONE;
+    };
+
+    void MergeRepresentative(const TArray<FRadioGardenPlace>& Places, FClusterAccumulator& Target, int32 PlaceIndex)
+    {
+        if (Target.RepresentativePlace == INDEX_NONE || Places[PlaceIndex].Size > Places[Target.RepresentativePlace].Size)
+        {
+            Target.RepresentativePlace = PlaceIndex;
+        }
+    }
+}
+
+FRadioGardenPlacesClusters::FVisibleRegion::FVisibleRegion(double InLatitude, double InLongitude, double RadiusKm, const TArray<FPlane>& InFrustumPlanes)
+    : Latitude(InLatitude)
+    , Longitude(InLongitude)
+    , AngularRadius(FMath::Clamp(RadiusKm / FRadioGardenPlacesIndex::EarthRadiusKm, 0.0, UE_DOUBLE_PI))
+    , Center(FRadioGardenPlacesIndex::ToUnitVector(InLatitude, InLongitude))
+    , MinDot(FMath::Cos(AngularRadius))
+    , FrustumPlanes(InFrustumPlanes)
+{
+}
+
+bool FRadioGardenPlacesClusters::FVisibleRegion::Contains(const FVector& Point) const
+{
+    if (FVector::DotProduct(Point, Center) < MinDot)
+    {
+        return false;
+    }
+
+    for (const FPlane& Plane : FrustumPlanes)
+    {
+        if (Plane.PlaneDot(Point) > 0.0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+FRadioGardenPlacesClusters::FRadioGardenPlacesClusters(const FPlacesRef& InPlaces)
+    : Places(InPlaces)
+{
+    const TArray<FRadioGardenPlace>& Source = Places->Places;
+    Levels.SetNum(MaxZoomLevel + 1);
+
+    // Самый подробный уровень собирается из мест
+    TMap<uint64, FClusterAccumulator> Cells;
+    Cells.Reserve(Source.Num());
+    for (int32 PlaceIndex = 0; PlaceIndex < Source.Num(); ++PlaceIndex)
+    {
+        const FRadioGardenPlace& Place = Source[PlaceIndex];
+        FClusterAccumulator& Cell = Cells.FindOrAdd(GetCellKey(MaxZoomLevel, Place.Geo.Latitude, Place.Geo.Longitude));
+        Cell.WeightedSum += FRadioGardenPlacesIndex::ToUnitVector(Place.Geo.Latitude, Place.Geo.Longitude) * FMath::Max(1, Place.Size);
+        Cell.TotalSize += Place.Size;
+        ++Cell.PlaceCount;
+        MergeRepresentative(Source, Cell, PlaceIndex);
+    }
+
+    for (int32 Level = MaxZoomLevel; Level >= 0; --Level)
+    {
+        TArray<FCluster>& Clusters = Levels[Level];
+        Clusters.Reserve(Cells.Num());
+        for (const TPair<uint64, FClusterAccumulator>& Cell : Cells)
+        {
+            FCluster& Cluster = Clusters.AddDefaulted_GetRef();
+            Cluster.CellKey = Cell.Key;
+            Cluster.TotalSize = Cell.Value.TotalSize;
+            Cluster.PlaceCount = Cell.Value.PlaceCount;
+            Cluster.RepresentativePlace = Cell.Value.RepresentativePlace;
+            Cluster.Center = Cell.Value.WeightedSum.GetSafeNormal();
+
+            // Противолежащие места дают нулевую сумму
+            if (Cluster.Center.IsZero())
+            {
+                const FRadioGardenCoords& Geo = Source[Cluster.RepresentativePlace].Geo;
+                Cluster.Center = FRadioGardenPlacesIndex::ToUnitVector(Geo.Latitude, Geo.Longitude);
+            }
+        }
+
+        Clusters.Sort([](const FCluster& A, const FCluster& B)
+        {
+            return A.CellKey < B.CellKey;
+        });
+
+        if (Level == 0)
+        {
+            break;
+        }
+
+        // Родительская ячейка: строка и столбец вдвое меньше
+        const uint64 Columns = GetClusterColumns(Level);
+        TMap<uint64, FClusterAccumulator> Parents;
+        Parents.Reserve(Cells.Num());
+        for (const TPair<uint64, FClusterAccumulator>& Cell : Cells)
+        {
+            const uint64 ParentKey = (Cell.Key / Columns / 2) * (Columns / 2) + (Cell.Key % Columns) / 2;
+            FClusterAccumulator& Parent = Parents.FindOrAdd(ParentKey);
+            Parent.WeightedSum += Cell.Value.WeightedSum;
+            Parent.TotalSize += Cell.Value.TotalSize;
+            Parent.PlaceCount += Cell.Value.PlaceCount;
+            MergeRepresentative(Source, Parent, Cell.Value.RepresentativePlace);
+        }
+        Cells = MoveTemp(Parents);
+    }
+}
+
+void FRadioGardenPlacesClusters::FindVisible(int32 ZoomLevel, const FVisibleRegion& Region, TArray<const FCluster*>& OutClusters) const
+{
+    const int32 Level = FMath::Clamp(ZoomLevel, 0, MaxZoomLevel);
+    const TArray<FCluster>& Clusters = Levels[Level];
+    const int32 Columns = GetClusterColumns(Level);
+    const double RowDegrees = 180.0 / GetClusterRows(Level);
+    const double ColumnDegrees = 360.0 / Columns;
+
+    // Центр кластера может выйти за свою ячейку (среднее точек на сфере смещается к полюсу),
+    // поэтому диапазон ячеек расширяется на одну ячейку в каждую сторону
+    const double RadiusDegrees = FMath::RadiansToDegrees(Region.AngularRadius);
+    const double South = Region.Latitude - RadiusDegrees - RowDegrees;
+    const double North = Region.Latitude + RadiusDegrees + RowDegrees;
+
+    // Столбцы шапки: половина её ширины по долготе - asin(sin(r) / cos(lat)); шапка с полюсом занимает все долготы
+    int32 ColumnRanges[2][2] = { { 0, Columns - 1 }, { 0, -1 } };
+    if (South > -90.0 && North < 90.0)
+    {
+        const double SinRadius = FMath::Sin(Region.AngularRadius);
+        const double CosLatitude = FMath::Cos(FMath::DegreesToRadians(Region.Latitude));
+        const double HalfWidth = SinRadius < CosLatitude
+            ? FMath::RadiansToDegrees(FMath::Asin(SinRadius / CosLatitude)) + ColumnDegrees
+            : 180.0;
+
+        if (HalfWidth < 180.0)
+        {
+            const int32 FirstColumn = GetClusterColumn(Level, Region.Longitude - HalfWidth);
+            const int32 LastColumn = GetClusterColumn(Level, Region.Longitude + HalfWidth);
+            if (FirstColumn <= LastColumn)
+            {
+                ColumnRanges[0][0] = FirstColumn;
+                ColumnRanges[0][1] = LastColumn;
+            }
+            else
+            {
+                // Шапка пересекает 180-й меридиан
+                ColumnRanges[0][0] = FirstColumn;
+                ColumnRanges[1][1] = LastColumn;
+            }
+        }
+    }
+
+    const int32 FirstRow = GetClusterRow(Level, South);
+    const int32 LastRow = GetClusterRow(Level, North);
+    for (int32 Row = FirstRow; Row <= LastRow; ++Row)
+    {
+        for (const auto& Range : ColumnRanges)
+        {
+            if (Range[0] > Range[1])
+            {
+                continue;
+            }
+
+            const uint64 RowKey = static_cast<uint64>(Row) * Columns;
+            const uint64 LastKey = RowKey + Range[1];
+            for (int32 ClusterIndex = Algo::LowerBoundBy(Clusters, RowKey + Range[0], &FCluster::CellKey);
+                ClusterIndex < Clusters.Num() && Clusters[ClusterIndex].CellKey <= LastKey; ++ClusterIndex)
+            {
+                if (Region.Contains(Clusters[ClusterIndex].Center))
+                {
+                    OutClusters.Add(&Clusters[ClusterIndex]);
+                }
+            }
+        }
+    }
+}
+
+uint64 FRadioGardenPlacesClusters::GetCellKey(int32 ZoomLevel, double Latitude, double Longitude)
+{
+    return static_cast<uint64>(GetClusterRow(ZoomLevel, Latitude)) * GetClusterColumns(ZoomLevel) + GetClusterColumn(ZoomLevel, Longitude);
+}
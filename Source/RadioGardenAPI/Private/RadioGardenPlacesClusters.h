@@ -0,0 +1,100 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RadioGardenTypes.h"
+#include "RadioGardenPlacesIndex.h"
+
+/**
+ * Иерархическая кластеризация мест для отображения на глобусе
+ * Уровень Level делит глобус сеткой 2^Level строк на 2^(Level + 1) столбцов, ячейки соседних уровней вложены.
+ * Кластеры самого подробного уровня собираются из мест, каждый следующий - слиянием четырёх дочерних ячеек.
+ * Как и индекс, строится один раз на версию каталога и не изменяется
+ */
+class FRadioGardenPlacesClusters
+{
+public:
+    using FPlacesRef = FRadioGardenPlacesIndex::FPlacesRef;
+    using FClustersRef = TSharedRef<const FRadioGardenPlacesClusters, ESPMode::ThreadSafe>;
+
+    /** Самый подробный уровень кластеров (ячейка около 0.044°); на более крупных масштабах показываются сами места */
+    static constexpr int32 MaxZoomLevel = 12;
+
+    /**
+     * Кластер мест одной ячейки сетки
+     */
+    struct FCluster
+    {
+        /** Единичный вектор центра: среднее мест, взвешенное по количеству станций */
+        FVector Center = FVector::ZeroVector;
+
+        /** Ячейка сетки уровня (строка * столбцов + столбец) */
+        uint64 CellKey = 0;
+
+        /** Сумма станций мест */
+        int32 TotalSize = 0;
+
+        /** Количество мест */
+        int32 PlaceCount = 0;
+
+        /** Самое крупное место кластера */
+        int32 RepresentativePlace = INDEX_NONE;
+    };
+
+    /**
+     * Видимая область глобуса: сферическая шапка и необязательные плоскости пирамиды видимости
+     */
+    struct FVisibleRegion
+    {
+        FVisibleRegion(double InLatitude, double InLongitude, double RadiusKm, const TArray<FPlane>& InFrustumPlanes);
+
+        /** Видна ли точка (единичный вектор) */
+        bool Contains(const FVector& Point) const;
+
+        double Latitude = 0.0;
+        double Longitude = 0.0;
+
+        /** Угловой радиус шапки (радианы) */
+        double AngularRadius = 0.0;
+
+        FVector Center = FVector::ZeroVector;
+
+        /** Косинус углового радиуса: точка в шапке, если её скалярное произведение с центром не меньше */
+        double MinDot = 0.0;
+
+        /** Точка видна, если она не снаружи ни одной плоскости */
+        TArray<FPlane> FrustumPlanes;
+    };
+
+    /**
+     * Построить кластеры всех уровней, O(N * MaxZoomLevel)
+     */
+    explicit FRadioGardenPlacesClusters(const FPlacesRef& InPlaces);
+
+    /**
+     * Список мест, по которому построены кластеры
+     */
+    const FRadioGardenPlacesResponse& GetPlaces() const { return *Places; }
+
+    /**
+     * Найти видимые кластеры уровня
+     * Просматриваются только ячейки, покрывающие шапку, а не все кластеры уровня
+     * @param ZoomLevel Уровень (приводится к [0, MaxZoomLevel])
+     * @param Region Видимая область
+     * @param OutClusters Видимые кластеры
+     */
+    void FindVisible(int32 ZoomLevel, const FVisibleRegion& Region, TArray<const FCluster*>& OutClusters) const;
+
+    /**
+     * Ячейка сетки уровня, в которую попадает точка
+     */
+    static uint64 GetCellKey(int32 ZoomLevel, double Latitude, double Longitude);
+
+private:
+    /** Список мест */
+    FPlacesRef Places;
+
+    /** Кластеры каждого уровня по возрастанию ключа ячейки */
+    TArray<TArray<FCluster>> Levels;
+};
@@ -0,0 +1,184 @@
+// by Neil Moore
+
+#include "RadioGardenPlacesCoords.h"
+#include "RadioGardenPlacesCatalog.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+void FRadioGardenPlacesCoords::Reserve(int32 Count)
+{
+    X.Reserve(Count);
+    Y.Reserve(Count);
+    Z.Reserve(Count);
+}
+
+void FRadioGardenPlacesCoords::Add(const FVector& UnitVector)
+{
+    X.Add(UnitVector.X);
+    Y.Add(UnitVector.Y);
+    Z.Add(UnitVector.Z);
+}
+
+void FRadioGardenPlacesCoords::ComputeChordSquared(const FVector& Query, int32 Begin, int32 Count, double* OutChordSquared) const
+{
+    check(Begin >= 0 && Count >= 0 && Begin + Count <= Num());
+    ChordSquaredBatch(Query, X.GetData() + Begin, Y.GetData() + Begin, Z.GetData() + Begin, Count, OutChordSquared);
+}
+
+void FRadioGardenPlacesCoords::ChordSquaredBatch(const FVector& Query, const double* InX, const double* InY, const double* InZ, int32 Count, double* OutChordSquared)
+{
+    int32 Index = 0;
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS || PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+    const VectorRegister4Double QueryX = VectorLoadFloat1(&Query.X);
+    const VectorRegister4Double QueryY = VectorLoadFloat1(&Query.Y);
+    const VectorRegister4Double QueryZ = VectorLoadFloat1(&Query.Z);
+
+    for (; Index + 4 <= Count; Index += 4)
+    {
+        const VectorRegister4Double DX = VectorSubtract(VectorLoad(InX + Index), QueryX);
+        const VectorRegister4Double DY = VectorSubtract(VectorLoad(InY + Index), QueryY);
+        const VectorRegister4Double DZ = VectorSubtract(VectorLoad(InZ + Index), QueryZ);
+
+        VectorRegister4Double Sum = VectorMultiply(DX, DX);
+        Sum = VectorMultiplyAdd(DY, DY, Sum);
+        Sum = VectorMultiplyAdd(DZ, DZ, Sum);
+        VectorStore(Sum, OutChordSquared + Index);
+    }
+#endif
+
+    ChordSquaredBatchScalar(Query, InX + Index, InY + Index, InZ + Index, Count - Index, OutChordSquared + Index);
+}
+
+void FRadioGardenPlacesCoords::ChordSquaredBatchScalar(const FVector& Query, const double* InX, const double* InY, const double* InZ, int32 Count, double* OutChordSquared)
+{
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        const double DX = InX[Index] - Query.X;
+        const double DY = InY[Index] - Query.Y;
+        const double DZ = InZ[Index] - Query.Z;
+        OutChordSquared[Index] = DX * DX + DY * DY + DZ * DZ;
+    }
+}
+
+double FRadioGardenPlacesCoords::HaversineDistance(double Lat1, double Lon1, double Lat2, double Lon2)
+{
+    const double DLat = FMath::DegreesToRadians(Lat2 - Lat1);
+    const double DLon = FMath::DegreesToRadians(Lon2 - Lon1);
+
+    const double A = FMath::Sin(DLat / 2) * FMath::Sin(DLat / 2) +
+                     FMath::Cos(FMath::DegreesToRadians(Lat1)) * FMath::Cos(FMath::DegreesToRadians(Lat2)) *
+                     FMath::Sin(DLon / 2) * FMath::Sin(DLon / 2);
+
+    const double C = 2 * FMath::Atan2(FMath::Sqrt(A), FMath::Sqrt(1 - A));
+    return FRadioGardenPlacesIndex::EarthRadiusKm * C;
+}
+
+// ========== Benchmark ==========
+
+namespace
+{
+    // Допустимое расхождение пакетного расчёта с формулой Хаверсина (км)
+    constexpr double CoordsDistanceToleranceKm = 1e-3;
+
+    // Проверка и замер пакетного расчёта на текущем каталоге мест:
+    // расстояния через хорды сверяются с формулой Хаверсина, векторный вариант - со скалярным
+    void RunDistanceKernelBenchmark(int32 Iterations)
+    {
+        const FRadioGardenPlacesCatalog::FPlacesPtr Places = FRadioGardenPlacesCatalog::Get().GetPlaces();
+        if (!Places.IsValid() || Places->Places.Num() == 0)
+        {
+            UE_LOG(LogRadioGardenAPI, Warning, TEXT("Distance kernel benchmark: places catalog is not loaded"));
+            return;
+        }
+
+        const TArray<FRadioGardenPlace>& Source = Places->Places;
+
+        FRadioGardenPlacesCoords Coords;
+        Coords.Reserve(Source.Num());
+        for (const FRadioGardenPlace& Place : Source)
+        {
+            Coords.Add(FRadioGardenPlacesIndex::ToUnitVector(Place.Geo.Latitude, Place.Geo.Longitude));
+        }
+
+        TArray<double> Batch;
+        TArray<double> Scalar;
+        Batch.SetNumUninitialized(Source.Num());
+        Scalar.SetNumUninitialized(Source.Num());
+
+        // Сверка на точках запроса, разбросанных по всему шару, включая полюса и антимеридиан
+        const FVector2D QueryPoints[] = { { 0.0, 0.0 }, { 55.75, 37.62 }, { -33.87, 151.21 }, { 89.9, 0.0 }, { -89.9, 179.9 }, { 40.71, -74.01 } };
+
+        double MaxErrorKm = 0.0;
+        bool bBatchMatchesScalar = true;
+        for (const FVector2D& QueryPoint : QueryPoints)
+        {
+            const FVector Query = FRadioGardenPlacesIndex::ToUnitVector(QueryPoint.X, QueryPoint.Y);
+            Coords.ComputeChordSquared(Query, 0, Source.Num(), Batch.GetData());
+
+            for (int32 Index = 0; Index < Source.Num(); ++Index)
+            {
+                const double Expected = FRadioGardenPlacesCoords::HaversineDistance(QueryPoint.X, QueryPoint.Y, Source[Index].Geo.Latitude, Source[Index].Geo.Longitude);
+                MaxErrorKm = FMath::Max(MaxErrorKm, FMath::Abs(FRadioGardenPlacesIndex::ChordSquaredToDistance(Batch[Index]) - Expected));
+                bBatchMatchesScalar &= FMath::IsNearlyEqual(Batch[Index], Coords.GetChordSquared(Query, Index), 1e-12);
+            }
+        }
+
+        const FVector Query = FRadioGardenPlacesIndex::ToUnitVector(QueryPoints[1].X, QueryPoints[1].Y);
+
+        double StartTime = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            Coords.ComputeChordSquared(Query, 0, Source.Num(), Batch.GetData());
+        }
+        const double BatchSeconds = FPlatformTime::Seconds() - StartTime;
+
+        StartTime = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            for (int32 Index = 0; Index < Source.Num(); ++Index)
+            {
+                Scalar[Index] = Coords.GetChordSquared(Query, Index);
+            }
+        }
+        const double ScalarSeconds = FPlatformTime::Seconds() - StartTime;
+
+        StartTime = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            for (int32 Index = 0; Index < Source.Num(); ++Index)
+            {
+                Scalar[Index] = FRadioGardenPlacesCoords::HaversineDistance(QueryPoints[1].X, QueryPoints[1].Y, Source[Index].Geo.Latitude, Source[Index].Geo.Longitude);
+            }
+        }
+        const double HaversineSeconds = FPlatformTime::Seconds() - StartTime;
+
+        UE_LOG(LogRadioGardenAPI, Log, TEXT("Distance kernel benchmark (%d places, %d iterations):"), Source.Num(), Iterations);
+        UE_LOG(LogRadioGardenAPI, Log, TEXT("  Batch:     %.3f ms"), BatchSeconds * 1000.0 / Iterations);
+        UE_LOG(LogRadioGardenAPI, Log, TEXT("  Scalar:    %.3f ms"), ScalarSeconds * 1000.0 / Iterations);
+        UE_LOG(LogRadioGardenAPI, Log, TEXT("  Haversine: %.3f ms"), HaversineSeconds * 1000.0 / Iterations);
+
+        if (MaxErrorKm > CoordsDistanceToleranceKm || !bBatchMatchesScalar)
+        {
+            UE_LOG(LogRadioGardenAPI, Error, TEXT("Distance kernel check FAILED: max error %.6f km, batch matches scalar: %d"), MaxErrorKm, bBatchMatchesScalar ? 1 : 0);
+        }
+        else
+        {
+            UE_LOG(LogRadioGardenAPI, Log, TEXT("Distance kernel check passed: max error %.6f km"), MaxErrorKm);
+        }
+    }
+}
+
+static FAutoConsoleCommand CmdRadioGardenBenchmarkDistanceKernel(
+    TEXT("RadioGarden.Benchmark.DistanceKernel"),
+    TEXT("Сверить пакетный расчёт расстояний с формулой Хаверсина и замерить его на каталоге мест. Аргумент: число итераций (по умолчанию 100)"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        const int32 Iterations = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 100;
+
+        AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Iterations]()
+        {
+            RunDistanceKernelBenchmark(Iterations);
+        });
+    }));
@@ -0,0 +1,84 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Координаты мест в виде структуры массивов
+ * Единичные векторы точек лежат в трёх плотных массивах, поэтому проход по координатам не тянет
+ * в кэш строки FRadioGardenPlace, а расстояния считаются пакетно векторными инструкциями
+ */
+class FRadioGardenPlacesCoords
+{
+public:
+    /**
+     * Зарезервировать место под точки
+     */
+    void Reserve(int32 Count);
+
+    /**
+     * Добавить точку
+     * @param UnitVector Единичный вектор точки на сфере
+     */
+    void Add(const FVector& UnitVector);
+
+    /**
+     * Количество точек
+     */
+    int32 Num() const { return X.Num(); }
+
+    /**
+     * Координата точки по оси (0 - X, 1 - Y, 2 - Z)
+     */
+    double GetAxis(int32 Axis, int32 Index) const
+    {
+        return Axis == 0 ? X[Index] : (Axis == 1 ? Y[Index] : Z[Index]);
+    }
+
+    /**
+     * Единичный вектор точки
+     */
+    FVector GetPoint(int32 Index) const
+    {
+        return FVector(X[Index], Y[Index], Z[Index]);
+    }
+
+    /**
+     * Квадрат хорды от точки запроса до одной точки
+     */
+    double GetChordSquared(const FVector& Query, int32 Index) const
+    {
+        const double DX = X[Index] - Query.X;
+        const double DY = Y[Index] - Query.Y;
+        const double DZ = Z[Index] - Query.Z;
+        return DX * DX + DY * DY + DZ * DZ;
+    }
+
+    /**
+     * Квадраты хорд от точки запроса до точек [Begin, Begin + Count)
+     * @param OutChordSquared Буфер на Count значений
+     */
+    void ComputeChordSquared(const FVector& Query, int32 Begin, int32 Count, double* OutChordSquared) const;
+
+    /**
+     * Пакетный расчёт квадратов хорд, по четыре точки за итерацию (SSE/AVX/NEON через VectorRegister)
+     * Хвост и платформы без векторных инструкций считаются скалярно
+     */
+    static void ChordSquaredBatch(const FVector& Query, const double* InX, const double* InY, const double* InZ, int32 Count, double* OutChordSquared);
+
+    /**
+     * Скалярный вариант ChordSquaredBatch (для сравнения и платформ без векторных инструкций)
+     */
+    static void ChordSquaredBatchScalar(const FVector& Query, const double* InX, const double* InY, const double* InZ, int32 Count, double* OutChordSquared);
+
+    /**
+     * Расстояние по формуле Хаверсина (км), эталон для проверки пакетного расчёта
+     */
+    static double HaversineDistance(double Lat1, double Lon1, double Lat2, double Lon2);
+
+private:
+    TArray<double> X;
+    TArray<double> Y;
+    TArray<double> Z;
+};
@@ -0,0 +1,227 @@
+// by Neil Moore
+
+#include "RadioGardenPlacesIndex.h"
+#include <algorithm>
+
+FRadioGardenPlacesIndex::FRadioGardenPlacesIndex(const FPlacesRef& InPlaces)
+    : Places(InPlaces)
+{
+    const TArray<FRadioGardenPlace>& Source = Places->Places;
+
+    // Сначала точки в порядке каталога, дерево строится перестановкой индексов
+    TArray<FVector> Points;
+    Points.Reserve(Source.Num());
+    PlaceIndices.Reserve(Source.Num());
+    for (int32 PlaceIndex = 0; PlaceIndex < Source.Num(); ++PlaceIndex)
+    {
+        Points.Add(ToUnitVector(Source[PlaceIndex].Geo.Latitude, Source[PlaceIndex].Geo.Longitude));
+        PlaceIndices.Add(PlaceIndex);
+    }
+
+    SplitAxes.SetNumZeroed(Source.Num());
+    Build(Points, 0, PlaceIndices.Num());
+
+    // Координаты в порядке дерева: точки листа лежат подряд и считаются одним пакетом
+    Coords.Reserve(PlaceIndices.Num());
+    for (const int32 PlaceIndex : PlaceIndices)
+    {
+        Coords.Add(Points[PlaceIndex]);
+    }
+}
+
+void FRadioGardenPlacesIndex::Build(const TArray<FVector>& Points, int32 Begin, int32 End)
+{
+    if (End - Begin <= LeafSize)
+    {
+        return;
+    }
+
+    // Делим по оси наибольшего разброса
+    FVector Min(TNumericLimits<double>::Max());
+    FVector Max(TNumericLimits<double>::Lowest());
+    for (int32 TreeIndex = Begin; TreeIndex < End; ++TreeIndex)
+    {
+        const FVector& Point = Points[PlaceIndices[TreeIndex]];
+        Min = Min.ComponentMin(Point);
+        Max = Max.ComponentMax(Point);
+    }
+
+    const FVector Extent = Max - Min;
+    const uint8 Axis = Extent.X >= Extent.Y
+        ? (Extent.X >= Extent.Z ? 0 : 2)
+        : (Extent.Y >= Extent.Z ? 1 : 2);
+
+    const int32 Mid = (Begin + End) / 2;
+    int32* Order = PlaceIndices.GetData();
+    std::nth_element(Order + Begin, Order + Mid, Order + End, [&Points, Axis](int32 A, int32 B)
+    {
+        return Points[A][Axis] < Points[B][Axis];
+    });
+
+    SplitAxes[Mid] = Axis;
+    Build(Points, Begin, Mid);
+    Build(Points, Mid + 1, End);
+}
+
+void FRadioGardenPlacesIndex::FindNearest(const FIndexRef& Index, double Latitude, double Longitude, int32 Count, TArray<FNearestPlace>& OutPlaces)
+{
+    OutPlaces.Reset();
+    OutPlaces.Reserve(FMath::Min(Count, Index->PlaceIndices.Num()));
+
+    FNearestIterator Iterator(Index, Latitude, Longitude);
+    FNearestPlace Place;
+    while (OutPlaces.Num() < Count && Iterator.Next(Place))
+    {
+        OutPlaces.Add(Place);
+    }
+}
+
+void FRadioGardenPlacesIndex::FindWithinRadius(const FIndexRef& Index, double Latitude, double Longitude, double RadiusKm, TArray<FNearestPlace>& OutPlaces)
+{
+    OutPlaces.Reset();
+
+    // Расширяющееся кольцо останавливается на первом месте дальше радиуса
+    FNearestIterator Iterator(Index, Latitude, Longitude);
+    FNearestPlace Place;
+    while (Iterator.Next(Place) && Place.Distance <= RadiusKm)
+    {
+        OutPlaces.Add(Place);
+    }
+}
+
+void FRadioGardenPlacesIndex::FindInBox(const FBox& Box, TArray<int32>& OutPlaceIndices) const
+{
+    FindInBox(Box, 0, PlaceIndices.Num(), OutPlaceIndices);
+}
+
+void FRadioGardenPlacesIndex::FindInBox(const FBox& Box, int32 Begin, int32 End, TArray<int32>& OutPlaceIndices) const
+{
+    if (End - Begin <= LeafSize)
+    {
+        for (int32 TreeIndex = Begin; TreeIndex < End; ++TreeIndex)
+        {
+            if (Box.IsInsideOrOn(Coords.GetPoint(TreeIndex)))
+            {
+                OutPlaceIndices.Add(PlaceIndices[TreeIndex]);
+            }
+        }
+        return;
+    }
+
+    const int32 Mid = (Begin + End) / 2;
+    const uint8 Axis = SplitAxes[Mid];
+    const double Split = Coords.GetAxis(Axis, Mid);
+
+    if (Box.IsInsideOrOn(Coords.GetPoint(Mid)))
+    {
+        OutPlaceIndices.Add(PlaceIndices[Mid]);
+    }
+
+    // Слева от точки деления координаты по оси не больше неё, справа - не меньше
+    if (Box.Min[Axis] <= Split)
+    {
+        FindInBox(Box, Begin, Mid, OutPlaceIndices);
+    }
+    if (Box.Max[Axis] >= Split)
+    {
+        FindInBox(Box, Mid + 1, End, OutPlaceIndices);
+    }
+}
+
+FVector FRadioGardenPlacesIndex::ToUnitVector(double Latitude, double Longitude)
+{
+    double SinLat, CosLat, SinLon, CosLon;
+    FMath::SinCos(&SinLat, &CosLat, FMath::DegreesToRadians(Latitude));
+    FMath::SinCos(&SinLon, &CosLon, FMath::DegreesToRadians(Longitude));
+    return FVector(CosLat * CosLon, CosLat * SinLon, SinLat);
+}
+
+double FRadioGardenPlacesIndex::ChordSquaredToDistance(double ChordSquared)
+{
+    // Хорда c стягивает центральный угол 2 * asin(c / 2)
+    const double HalfChord = FMath::Min(FMath::Sqrt(FMath::Max(ChordSquared, 0.0)) * 0.5, 1.0);
+    return EarthRadiusKm * 2.0 * FMath::Asin(HalfChord);
+}
+
+// ========== Nearest Iterator ==========
+
+namespace
+{
+    struct FIndexQueueLess
+    {
+        template <typename EntryType>
+        bool operator()(const EntryType& A, const EntryType& B) const
+        {
+            return A.DistanceSquared < B.DistanceSquared;
+        }
+    };
+}
+
+FRadioGardenPlacesIndex::FNearestIterator::FNearestIterator(const FIndexRef& InIndex, double Latitude, double Longitude)
+    : Index(InIndex)
+    , Query(ToUnitVector(Latitude, Longitude))
+{
+    if (InIndex->PlaceIndices.Num() > 0)
+    {
+        Queue.HeapPush(FQueueEntry{ 0.0, 0, InIndex->PlaceIndices.Num() }, FIndexQueueLess());
+    }
+}
+
+bool FRadioGardenPlacesIndex::FNearestIterator::Next(FNearestPlace& OutPlace)
+{
+    while (Queue.Num() > 0)
+    {
+        FQueueEntry Entry;
+        Queue.HeapPop(Entry, FIndexQueueLess(), EAllowShrinking::No);
+
+        if (Entry.End == INDEX_NONE)
+        {
+            // Точка извлекается, только когда все непросмотренные узлы не ближе её
+            OutPlace.PlaceIndex = Index->PlaceIndices[Entry.Begin];
+            OutPlace.Distance = ChordSquaredToDistance(Entry.DistanceSquared);
+            return true;
+        }
+
+        ExpandNode(Entry);
+    }
+
+    return false;
+}
+
+void FRadioGardenPlacesIndex::FNearestIterator::PushPoint(int32 TreeIndex)
+{
+    Queue.HeapPush(FQueueEntry{ Index->Coords.GetChordSquared(Query, TreeIndex), TreeIndex, INDEX_NONE }, FIndexQueueLess());
+}
+
+void FRadioGardenPlacesIndex::FNearestIterator::ExpandNode(const FQueueEntry& Node)
+{
+    if (Node.End - Node.Begin <= LeafSize)
+    {
+        double ChordSquared[LeafSize];
+        Index->Coords.ComputeChordSquared(Query, Node.Begin, Node.End - Node.Begin, ChordSquared);
+
+        for (int32 TreeIndex = Node.Begin; TreeIndex < Node.End; ++TreeIndex)
+        {
+            Queue.HeapPush(FQueueEntry{ ChordSquared[TreeIndex - Node.Begin], TreeIndex, INDEX_NONE }, FIndexQueueLess());
+        }
+        return;
+    }
+
+    const int32 Mid = (Node.Begin + Node.End) / 2;
+    const uint8 Axis = Index->SplitAxes[Mid];
+    const double Offset = Query[Axis] - Index->Coords.GetAxis(Axis, Mid);
+
+    PushPoint(Mid);
+
+    // Ближнее поддерево наследует оценку узла, дальнее не ближе плоскости деления
+    const FQueueEntry Left{ Node.DistanceSquared, Node.Begin, Mid };
+    const FQueueEntry Right{ Node.DistanceSquared, Mid + 1, Node.End };
+    FQueueEntry Far = Offset < 0.0 ? Right : Left;
+    Far.DistanceSquared = FMath::Max(Node.DistanceSquared, Offset * Offset);
+
+    Queue.HeapPush(Offset < 0.0 ? Left : Right, FIndexQueueLess());
+    if (Far.Begin < Far.End)
+    {
+        Queue.HeapPush(Far, FIndexQueueLess());
+    }
+}
@@ -0,0 +1,145 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RadioGardenTypes.h"
+#include "RadioGardenPlacesCoords.h"
+
+/**
+ * Пространственный индекс мест
+ * k-d дерево по единичным векторам точек на сфере. Хорда между единичными векторами монотонна
+ * расстоянию по дуге большого круга, поэтому порядок ближайших в пространстве совпадает с порядком на Земле.
+ * Индекс неизменяем, строится один раз на версию каталога и держит ссылку на список мест
+ */
+class FRadioGardenPlacesIndex
+{
+public:
+    using FPlacesRef = TSharedRef<const FRadioGardenPlacesResponse, ESPMode::ThreadSafe>;
+    using FIndexRef = TSharedRef<const FRadioGardenPlacesIndex, ESPMode::ThreadSafe>;
+
+    /** Средний радиус Земли (км) */
+    static constexpr double EarthRadiusKm = 6371.0;
+
+    /** Максимальное число точек в листе дерева */
+    static constexpr int32 LeafSize = 8;
+
+    /**
+     * Место, найденное запросом
+     */
+    struct FNearestPlace
+    {
+        /** Индекс места в списке мест индекса */
+        int32 PlaceIndex = INDEX_NONE;
+
+        /** Расстояние по дуге большого круга (км) */
+        double Distance = 0.0;
+    };
+
+    /**
+     * Обход мест в порядке удаления от точки (расширяющееся кольцо)
+     * Каждый шаг раскрывает только узлы дерева ближе очередного результата, поэтому получение
+     * первых k мест стоит O(k + log N), а не обход всего каталога
+     */
+    class FNearestIterator
+    {
+    public:
+        FNearestIterator() = default;
+        FNearestIterator(const FIndexRef& InIndex, double Latitude, double Longitude);
+
+        /**
+         * Получить следующее по удалённости место
+         * @return false если места закончились
+         */
+        bool Next(FNearestPlace& OutPlace);
+
+    private:
+        /** Элемент очереди: узел дерева [Begin, End) или точка (End == INDEX_NONE) с нижней оценкой квадрата хорды */
+        struct FQueueEntry
+        {
+            double DistanceSquared;
+            int32 Begin;
+            int32 End;
+        };
+
+        /** Добавить в очередь точку дерева */
+        void PushPoint(int32 TreeIndex);
+
+        /** Раскрыть узел дерева: добавить в очередь его точку деления и поддеревья */
+        void ExpandNode(const FQueueEntry& Node);
+
+        TSharedPtr<const FRadioGardenPlacesIndex, ESPMode::ThreadSafe> Index;
+        FVector Query = FVector::ZeroVector;
+        TArray<FQueueEntry> Queue;
+    };
+
+    /**
+     * Построить индекс по списку мест, O(N log N)
+     */
+    explicit FRadioGardenPlacesIndex(const FPlacesRef& InPlaces);
+
+    /**
+     * Список мест, по которому построен индекс
+     */
+    const FRadioGardenPlacesResponse& GetPlaces() const { return *Places; }
+
+    /**
+     * Найти ближайшие места
+     * @param Index Индекс
+     * @param Latitude Широта точки
+     * @param Longitude Долгота точки
+     * @param Count Сколько мест найти
+     * @param OutPlaces Места по возрастанию расстояния
+     */
+    static void FindNearest(const FIndexRef& Index, double Latitude, double Longitude, int32 Count, TArray<FNearestPlace>& OutPlaces);
+
+    /**
+     * Найти места в радиусе от точки
+     * @param Index Индекс
+     * @param Latitude Широта центра
+     * @param Longitude Долгота центра
+     * @param RadiusKm Радиус (км)
+     * @param OutPlaces Места по возрастанию расстояния
+     */
+    static void FindWithinRadius(const FIndexRef& Index, double Latitude, double Longitude, double RadiusKm, TArray<FNearestPlace>& OutPlaces);
+
+    /** Запас параллелепипеда FindInBox на погрешность округления: кандидаты на границе всё равно проверяются точно */
+    static constexpr double BoxPadding = 1e-9;
+
+    /**
+     * Найти места, единичные векторы которых лежат в параллелепипеде
+     * Обходит только поддеревья, пересекающие его; используется как грубый отбор перед точной проверкой
+     * @param Box Параллелепипед в пространстве единичных векторов
+     * @param OutPlaceIndices Индексы мест (без упорядочивания)
+     */
+    void FindInBox(const FBox& Box, TArray<int32>& OutPlaceIndices) const;
+
+    /**
+     * Единичный вектор точки на сфере
+     */
+    static FVector ToUnitVector(double Latitude, double Longitude);
+
+    /**
+     * Перевести квадрат хорды между единичными векторами в расстояние по дуге (км)
+     */
+    static double ChordSquaredToDistance(double ChordSquared);
+
+private:
+    /** Отбор по параллелепипеду в поддереве [Begin, End) */
+    void FindInBox(const FBox& Box, int32 Begin, int32 End, TArray<int32>& OutPlaceIndices) const;
+
+    /** Построить поддерево [Begin, End) по точкам в порядке каталога */
+    void Build(const TArray<FVector>& Points, int32 Begin, int32 End);
+
+    /** Список мест */
+    FPlacesRef Places;
+
+    /** Точки в порядке дерева: корень поддерева [Begin, End) лежит в (Begin + End) / 2, листья идут подряд */
+    FRadioGardenPlacesCoords Coords;
+
+    /** Индекс места для каждой точки дерева */
+    TArray<int32> PlaceIndices;
+
+    /** Ось деления для каждого внутреннего узла (по позиции его точки) */
+    TArray<uint8> SplitAxes;
+};
@@ -0,0 +1,353 @@
+// by Neil Moore
+
+#include "RadioGardenPrefetcher.h"
+#include "RadioGardenPlacesCatalog.h"
+#include "RadioGardenResponseCache.h"
+#include "RadioGardenStats.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+
+static TAutoConsoleVariable<float> CVarRadioGardenPrefetchRequestsPerSecond(
+    TEXT("RadioGarden.Prefetch.RequestsPerSecond"),
+    2.0f,
+    TEXT("Сколько упреждающих запросов станций мест допускается в секунду"));
+
+static TAutoConsoleVariable<int32> CVarRadioGardenPrefetchMaxConcurrentRequests(
+    TEXT("RadioGarden.Prefetch.MaxConcurrentRequests"),
+    2,
+    TEXT("Сколько упреждающих запросов выполняется одновременно"));
+
+static TAutoConsoleVariable<int32> CVarRadioGardenPrefetchBudgetKB(
+    TEXT("RadioGarden.Prefetch.BudgetKB"),
+    2048,
+    TEXT("Бюджет памяти упреждения (КБ): пока неиспользованные загруженные ответы больше него, новые места не запрашиваются"));
+
+static TAutoConsoleVariable<float> CVarRadioGardenPrefetchLookaheadSeconds(
+    TEXT("RadioGarden.Prefetch.LookaheadSeconds"),
+    30.0f,
+    TEXT("На сколько секунд вперёд по траектории загружаются станции мест"));
+
+static TAutoConsoleVariable<int32> CVarRadioGardenPrefetchPlacesPerPoint(
+    TEXT("RadioGarden.Prefetch.PlacesPerPoint"),
+    4,
+    TEXT("Сколько ближайших мест берётся у каждой точки предсказанного пути"));
+
+namespace
+{
+    // Точек на предсказанном пути (включая текущее положение)
+    constexpr int32 PrefetchPathPoints = 8;
+
+    // Период шага упреждения (секунды)
+    constexpr float PrefetchTickInterval = 0.25f;
+
+    // Оценка памяти, занятой распаршенным ответом
+    int64 EstimateChannelsBytes(const FRadioGardenChannelsResponse& Response)
+    {
+        int64 Bytes = Response.Channels.GetAllocatedSize();
+        for (const FRadioGardenChannel& Channel : Response.Channels)
+        {
+            Bytes += Channel.Id.GetAllocatedSize() + Channel.Title.GetAllocatedSize() + Channel.Url.GetAllocatedSize()
+                + Channel.Website.GetAllocatedSize() + Channel.PlaceId.GetAllocatedSize() + Channel.PlaceTitle.GetAllocatedSize()
+                + Channel.CountryId.GetAllocatedSize() + Channel.CountryTitle.GetAllocatedSize() + Channel.StreamUrl.GetAllocatedSize();
+        }
+        return Bytes;
+    }
+}
+
+FRadioGardenPrefetcher& FRadioGardenPrefetcher::Get()
+{
+    static FRadioGardenPrefetcher Instance;
+    return Instance;
+}
+
+void FRadioGardenPrefetcher::UpdateTrajectory(double InLatitude, double InLongitude, const FVector2D& VelocityKmPerSecond, FFetchPlaceChannels&& InFetch)
+{
+    FScopeLock Lock(&CriticalSection);
+
+    Latitude = InLatitude;
+    Longitude = InLongitude;
+    Velocity = VelocityKmPerSecond;
+    Fetch = MoveTemp(InFetch);
+    bReplan = true;
+
+    if (!TickHandle.IsValid())
+    {
+        Tokens = 1.0;
+        TickHandle = FTSTicker::GetCoreTicker().AddTicker(
+            FTickerDelegate::CreateRaw(this, &FRadioGardenPrefetcher::Tick), PrefetchTickInterval);
+    }
+}
+
+void FRadioGardenPrefetcher::Stop()
+{
+    FTSTicker::FDelegateHandle Handle;
+    {
+        FScopeLock Lock(&CriticalSection);
+
+        Handle = TickHandle;
+        TickHandle.Reset();
+        Queue.Reset();
+        QueueHead = 0;
+        Prefetched.Reset();
+        Bytes = 0;
+        bReplan = false;
+    }
+
+    FRadioGardenStats::PrefetchBytes.store(0, std::memory_order_relaxed);
+
+    if (Handle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(Handle);
+    }
+}
+
+void FRadioGardenPrefetcher::Shutdown()
+{
+    Stop();
+
+    // Построение очереди занимает миллисекунды, поэтому его достаточно переждать
+    for (;;)
+    {
+        {
+            FScopeLock Lock(&CriticalSection);
+            if (!bPlanning)
+            {
+                return;
+            }
+        }
+        FPlatformProcess::Sleep(0.001f);
+    }
+}
+
+void FRadioGardenPrefetcher::BeginForegroundRequest(const FString& PlaceId)
+{
+    ForegroundInFlight.fetch_add(1, std::memory_order_relaxed);
+
+    FScopeLock Lock(&CriticalSection);
+
+    if (!TickHandle.IsValid())
+    {
+        return;
+    }
+
+    // Попадание - первое обращение к месту, загруженному (или загружаемому) упреждением, пока запись свежая
+    FPrefetchedPlace* Place = Prefetched.Find(PlaceId);
+    if (Place && !Place->bUsed && Place->ExpiresAt > FPlatformTime::Seconds())
+    {
+        Place->bUsed = true;
+        Bytes -= Place->Bytes;
+        Place->Bytes = 0;
+        FRadioGardenStats::PrefetchHits.fetch_add(1, std::memory_order_relaxed);
+        FRadioGardenStats::PrefetchBytes.store(Bytes, std::memory_order_relaxed);
+    }
+    else
+    {
+        // Место не загружалось, уже использовано или устарело: все такие обращения входят в знаменатель PrefetchHitRate
+        FRadioGardenStats::PrefetchMisses.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void FRadioGardenPrefetcher::EndForegroundRequest()
+{
+    ForegroundInFlight.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void FRadioGardenPrefetcher::PredictPath(double StartLatitude, double StartLongitude, const FVector2D& VelocityKmPerSecond, double Seconds, int32 PointCount, TArray<FRadioGardenCoords>& OutPoints)
+{
+    OutPoints.Reset(PointCount);
+    OutPoints.Emplace(StartLongitude, StartLatitude);
+
+    const double Speed = VelocityKmPerSecond.Size();
+    if (Speed <= UE_DOUBLE_KINDA_SMALL_NUMBER || Seconds <= 0.0)
+    {
+        return;
+    }
+
+    // Пункт назначения по начальному азимуту и угловому расстоянию
+    const double Bearing = FMath::Atan2(VelocityKmPerSecond.X, VelocityKmPerSecond.Y);
+    const double LatitudeRad = FMath::DegreesToRadians(StartLatitude);
+    const double SinLatitude = FMath::Sin(LatitudeRad);
+    const double CosLatitude = FMath::Cos(LatitudeRad);
+
+    for (int32 PointIndex = 1; PointIndex < PointCount; ++PointIndex)
+    {
+        const double Angle = Speed * Seconds * PointIndex / (PointCount - 1) / FRadioGardenPlacesIndex::EarthRadiusKm;
+        const double SinTarget = FMath::Clamp(SinLatitude * FMath::Cos(Angle) + CosLatitude * FMath::Sin(Angle) * FMath::Cos(Bearing), -1.0, 1.0);
+        const double DeltaLongitude = FMath::Atan2(FMath::Sin(Bearing) * FMath::Sin(Angle) * CosLatitude, FMath::Cos(Angle) - SinLatitude * SinTarget);
+
+        OutPoints.Emplace(
+            FMath::UnwindDegrees(StartLongitude + FMath::RadiansToDegrees(DeltaLongitude)),
+            FMath::RadiansToDegrees(FMath::Asin(SinTarget)));
+    }
+}
+
+bool FRadioGardenPrefetcher::Tick(float DeltaTime)
+{
+    TArray<FString, TInlineAllocator<8>> Dispatch;
+    FFetchPlaceChannels DispatchFetch;
+    {
+        FScopeLock Lock(&CriticalSection);
+
+        const double Now = FPlatformTime::Seconds();
+        ExpireLocked(Now);
+
+        const double RequestsPerSecond = FMath::Max(0.0f, CVarRadioGardenPrefetchRequestsPerSecond.GetValueOnGameThread());
+        Tokens = FMath::Min(Tokens + DeltaTime * RequestsPerSecond, FMath::Max(1.0, RequestsPerSecond));
+
+        if (bReplan && !bPlanning)
+        {
+            bReplan = false;
+            bPlanning = true;
+            AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [this]()
+            {
+                Plan();
+            });
+        }
+
+        // Обычные запросы станций мест важнее: пока они идут, упреждение ждёт
+        if (ForegroundInFlight.load(std::memory_order_relaxed) > 0)
+        {
+            return true;
+        }
+
+        const int32 MaxConcurrent = FMath::Max(1, CVarRadioGardenPrefetchMaxConcurrentRequests.GetValueOnGameThread());
+        const int64 BudgetBytes = int64(FMath::Max(0, CVarRadioGardenPrefetchBudgetKB.GetValueOnGameThread())) * 1024;
+        const double TimeToLive = FRadioGardenResponseCache::GetTimeToLive(ERadioGardenEndpointClass::Channels);
+
+        while (QueueHead < Queue.Num() && Tokens >= 1.0 && InFlight < MaxConcurrent && Bytes < BudgetBytes)
+        {
+            const FString& PlaceId = Queue[QueueHead++];
+            if (Prefetched.Contains(PlaceId))
+            {
+                continue;
+            }
+
+            Prefetched.Add(PlaceId).ExpiresAt = Now + TimeToLive;
+            Tokens -= 1.0;
+            ++InFlight;
+            Dispatch.Add(PlaceId);
+        }
+
+        if (Dispatch.Num() > 0)
+        {
+            DispatchFetch = Fetch;
+        }
+    }
+
+    for (const FString& PlaceId : Dispatch)
+    {
+        FRadioGardenStats::PrefetchRequests.fetch_add(1, std::memory_order_relaxed);
+        DispatchFetch(PlaceId, [this, PlaceId](const FRadioGardenChannelsResponse& Response)
+        {
+            OnFetched(PlaceId, Response);
+        });
+    }
+
+    return true;
+}
+
+void FRadioGardenPrefetcher::Plan()
+{
+    double PathLatitude = 0.0;
+    double PathLongitude = 0.0;
+    FVector2D PathVelocity = FVector2D::ZeroVector;
+    {
+        FScopeLock Lock(&CriticalSection);
+        PathLatitude = Latitude;
+        PathLongitude = Longitude;
+        PathVelocity = Velocity;
+    }
+
+    // Упреждение не загружает каталог само: без него ждём, пока его загрузит обычный запрос
+    TArray<FString> NewQueue;
+    const FRadioGardenPlacesCatalog::FPlacesPtr Places = FRadioGardenPlacesCatalog::Get().GetPlaces();
+    if (Places.IsValid() && Places->bSuccessful)
+    {
+        const FRadioGardenPlacesCatalog::FIndexRef Index = FRadioGardenPlacesCatalog::Get().GetIndex(Places.ToSharedRef());
+
+        TArray<FRadioGardenCoords> Path;
+        PredictPath(PathLatitude, PathLongitude, PathVelocity, CVarRadioGardenPrefetchLookaheadSeconds.GetValueOnAnyThread(), PrefetchPathPoints, Path);
+
+        // Места идут в порядке прохождения пути, у каждой точки - от ближайшего
+        const int32 PlacesPerPoint = FMath::Max(1, CVarRadioGardenPrefetchPlacesPerPoint.GetValueOnAnyThread());
+        TSet<int32> Seen;
+        TArray<FRadioGardenPlacesIndex::FNearestPlace> Nearest;
+        for (const FRadioGardenCoords& Point : Path)
+        {
+            FRadioGardenPlacesIndex::FindNearest(Index, Point.Latitude, Point.Longitude, PlacesPerPoint, Nearest);
+            for (const FRadioGardenPlacesIndex::FNearestPlace& Place : Nearest)
+            {
+                bool bAlreadySeen = false;
+                Seen.Add(Place.PlaceIndex, &bAlreadySeen);
+                if (!bAlreadySeen)
+                {
+                    NewQueue.Add(Places->Places[Place.PlaceIndex].Id);
+                }
+            }
+        }
+    }
+
+    FScopeLock Lock(&CriticalSection);
+    bPlanning = false;
+    if (TickHandle.IsValid())
+    {
+        Queue = MoveTemp(NewQueue);
+        QueueHead = 0;
+    }
+}
+
+void FRadioGardenPrefetcher::OnFetched(const FString& PlaceId, const FRadioGardenChannelsResponse& Response)
+{
+    FScopeLock Lock(&CriticalSection);
+
+    --InFlight;
+
+    FPrefetchedPlace* Place = Prefetched.Find(PlaceId);
+    if (!Place)
+    {
+        return;
+    }
+
+    // Неудачный ответ не кэшируется, место можно будет запросить снова
+    if (!Response.bSuccessful)
+    {
+        Prefetched.Remove(PlaceId);
+        return;
+    }
+
+    Place->bCompleted = true;
+    if (!Place->bUsed)
+    {
+        Place->Bytes = EstimateChannelsBytes(Response);
+        Bytes += Place->Bytes;
+        FRadioGardenStats::PrefetchBytes.store(Bytes, std::memory_order_relaxed);
+    }
+}
+
+void FRadioGardenPrefetcher::ExpireLocked(double Now)
+{
+    bool bChanged = false;
+    for (auto It = Prefetched.CreateIterator(); It; ++It)
+    {
+        const FPrefetchedPlace& Place = It.Value();
+        if (Place.ExpiresAt > Now || !Place.bCompleted)
+        {
+            continue;
+        }
+
+        if (!Place.bUsed)
+        {
+            FRadioGardenStats::PrefetchWasted.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Bytes -= Place.Bytes;
+        bChanged = true;
+        It.RemoveCurrent();
+    }
+
+    if (bChanged)
+    {
+        FRadioGardenStats::PrefetchBytes.store(Bytes, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,121 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RadioGardenTypes.h"
+#include "Containers/Ticker.h"
+#include <atomic>
+
+/**
+ * Упреждающая загрузка станций мест по траектории слушателя
+ * По положению и скорости предсказывается путь на RadioGarden.Prefetch.LookaheadSeconds вперёд,
+ * станции ближайших к нему мест запрашиваются заранее и оседают в кэше ответов.
+ * Работает с низким приоритетом: не больше RadioGarden.Prefetch.RequestsPerSecond запросов в секунду,
+ * не больше RadioGarden.Prefetch.MaxConcurrentRequests одновременно, в пределах RadioGarden.Prefetch.BudgetKB
+ * и только пока нет обычных запросов станций мест
+ */
+class FRadioGardenPrefetcher
+{
+public:
+    /** Запросить станции места; OnFetched вызывается с ответом в фоновом потоке */
+    using FFetchPlaceChannels = TFunction<void(const FString& PlaceId, TFunction<void(const FRadioGardenChannelsResponse&)>&& OnFetched)>;
+
+    /**
+     * Получить экземпляр
+     */
+    static FRadioGardenPrefetcher& Get();
+
+    /**
+     * Обновить траекторию; первый вызов запускает упреждающую загрузку
+     * @param InLatitude Широта слушателя
+     * @param InLongitude Долгота слушателя
+     * @param VelocityKmPerSecond Скорость (X - на восток, Y - на север, км/с)
+     * @param InFetch Запрос станций места
+     */
+    void UpdateTrajectory(double InLatitude, double InLongitude, const FVector2D& VelocityKmPerSecond, FFetchPlaceChannels&& InFetch);
+
+    /**
+     * Остановить упреждающую загрузку и забыть загруженные места
+     */
+    void Stop();
+
+    /**
+     * Остановить упреждающую загрузку и дождаться фонового построения очереди
+     * Вызывается при выгрузке модуля: после него ни тикер, ни фоновая задача не обращаются к упреждению
+     */
+    void Shutdown();
+
+    /**
+     * Отметить начало обычного запроса станций места: учитывает попадание упреждения
+     * и приостанавливает упреждающие запросы до EndForegroundRequest
+     */
+    void BeginForegroundRequest(const FString& PlaceId);
+
+    /**
+     * Отметить завершение обычного запроса станций места
+     */
+    void EndForegroundRequest();
+
+    /**
+     * Предсказать путь по дуге большого круга
+     * @param StartLatitude Широта начала
+     * @param StartLongitude Долгота начала
+     * @param VelocityKmPerSecond Скорость (X - на восток, Y - на север, км/с)
+     * @param Seconds На сколько секунд вперёд
+     * @param PointCount Число точек (первая - начало пути)
+     * @param OutPoints Точки пути
+     */
+    static void PredictPath(double StartLatitude, double StartLongitude, const FVector2D& VelocityKmPerSecond, double Seconds, int32 PointCount, TArray<FRadioGardenCoords>& OutPoints);
+
+private:
+    /** Место, загруженное упреждением */
+    struct FPrefetchedPlace
+    {
+        /** Когда запись кэша устареет и загрузка перестанет приносить пользу */
+        double ExpiresAt = 0.0;
+
+        /** Оценка объёма ответа (байты) */
+        int64 Bytes = 0;
+
+        bool bCompleted = false;
+        bool bUsed = false;
+    };
+
+    /** Шаг упреждения (игровой поток) */
+    bool Tick(float DeltaTime);
+
+    /** Пересчитать очередь мест по траектории (фоновый поток) */
+    void Plan();
+
+    /** Ответ упреждающего запроса */
+    void OnFetched(const FString& PlaceId, const FRadioGardenChannelsResponse& Response);
+
+    /** Забыть места, записи кэша которых устарели (под блокировкой) */
+    void ExpireLocked(double Now);
+
+    FCriticalSection CriticalSection;
+    FTSTicker::FDelegateHandle TickHandle;
+    FFetchPlaceChannels Fetch;
+
+    /** Последняя траектория */
+    double Latitude = 0.0;
+    double Longitude = 0.0;
+    FVector2D Velocity = FVector2D::ZeroVector;
+    bool bReplan = false;
+    bool bPlanning = false;
+
+    /** Места по порядку прохождения пути, [QueueHead, Num) ещё не запрошены */
+    TArray<FString> Queue;
+    int32 QueueHead = 0;
+
+    /** Доступные запросы (ведро токенов RequestsPerSecond) */
+    double Tokens = 0.0;
+
+    int32 InFlight = 0;
+    int64 Bytes = 0;
+    TMap<FString, FPrefetchedPlace> Prefetched;
+
+    /** Обычные запросы станций мест в работе */
+    std::atomic<int32> ForegroundInFlight{0};
+};
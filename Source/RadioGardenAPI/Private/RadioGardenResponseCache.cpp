@@ -0,0 +1,223 @@
+// by Neil Moore
+
+#include "RadioGardenResponseCache.h"
+#include "RadioGardenStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+static TAutoConsoleVariable<bool> CVarRadioGardenCacheEnabled(
+    TEXT("RadioGarden.Cache.Enabled"),
+    true,
+    TEXT("Кэшировать ответы Radio Garden API в памяти"));
+
+static TAutoConsoleVariable<int32> CVarRadioGardenCacheBudgetMB(
+    TEXT("RadioGarden.Cache.BudgetMB"),
+    64,
+    TEXT("Бюджет памяти кэша ответов (МБ), сверх него записи вытесняются по LRU"));
+
+static TAutoConsoleVariable<float> CVarRadioGardenCacheTTLPlaces(
+    TEXT("RadioGarden.Cache.TTL.Places"),
+    3600.0f,
+    TEXT("TTL списка мест (секунды)"));
+
+static TAutoConsoleVariable<float> CVarRadioGardenCacheTTLChannels(
+    TEXT("RadioGarden.Cache.TTL.Channels"),
+    600.0f,
+    TEXT("TTL страниц мест и списков их станций (секунды)"));
+
+static TAutoConsoleVariable<float> CVarRadioGardenCacheTTLChannel(
+    TEXT("RadioGarden.Cache.TTL.Channel"),
+    3600.0f,
+    TEXT("TTL информации о станции (секунды)"));
+
+static TAutoConsoleVariable<float> CVarRadioGardenCacheTTLSearch(
+    TEXT("RadioGarden.Cache.TTL.Search"),
+    120.0f,
+    TEXT("TTL результатов поиска (секунды)"));
+
+static TAutoConsoleVariable<float> CVarRadioGardenCacheTTLGeo(
+    TEXT("RadioGarden.Cache.TTL.Geo"),
+    1800.0f,
+    TEXT("TTL геолокации клиента (секунды)"));
+
+FRadioGardenResponseCache& FRadioGardenResponseCache::Get()
+{
+    static FRadioGardenResponseCache Instance;
+    return Instance;
+}
+
+double FRadioGardenResponseCache::GetTimeToLive(ERadioGardenEndpointClass EndpointClass)
+{
+    switch (EndpointClass)
+    {
+    case ERadioGardenEndpointClass::Places:
+        return CVarRadioGardenCacheTTLPlaces.GetValueOnAnyThread();
+    case ERadioGardenEndpointClass::Channels:
+        return CVarRadioGardenCacheTTLChannels.GetValueOnAnyThread();
+    case ERadioGardenEndpointClass::Channel:
+        return CVarRadioGardenCacheTTLChannel.GetValueOnAnyThread();
+    case ERadioGardenEndpointClass::Search:
+        return CVarRadioGardenCacheTTLSearch.GetValueOnAnyThread();
+    case ERadioGardenEndpointClass::Geo:
+        return CVarRadioGardenCacheTTLGeo.GetValueOnAnyThread();
+    default:
+        // Редиректы на потоки и прочее не кэшируем
+        return 0.0;
+    }
+}
+
+FRadioGardenResponseCache::ELookup FRadioGardenResponseCache::Find(const FString& Endpoint, FRadioGardenHttpResult& OutResult, FString& OutETag, FString& OutLastModified)
+{
+    if (!CVarRadioGardenCacheEnabled.GetValueOnAnyThread())
+    {
+        return ELookup::Miss;
+    }
+
+    FScopeLock Lock(&CriticalSection);
+
+    FEntry* Entry = Entries.Find(Endpoint);
+    if (!Entry)
+    {
+        FRadioGardenStats::CacheMisses.fetch_add(1, std::memory_order_relaxed);
+        return ELookup::Miss;
+    }
+
+    if (FPlatformTime::Seconds() < Entry->ExpiresAt)
+    {
+        FillResult(*Entry, OutResult);
+        FRadioGardenStats::CacheHits.fetch_add(1, std::memory_order_relaxed);
+        return ELookup::Fresh;
+    }
+
+    // Без валидаторов перепроверить запись нельзя, загружаем заново
+    if (Entry->ETag.IsEmpty() && Entry->LastModified.IsEmpty())
+    {
+        FRadioGardenStats::CacheMisses.fetch_add(1, std::memory_order_relaxed);
+        return ELookup::Miss;
+    }
+
+    OutETag = Entry->ETag;
+    OutLastModified = Entry->LastModified;
+    return ELookup::Stale;
+}
+
+void FRadioGardenResponseCache::Store(const FString& Endpoint, FRadioGardenHttpResult& Result, const FString& ETag, const FString& LastModified)
+{
+    const double TimeToLive = GetTimeToLive(FRadioGardenHttpRequest::ClassifyEndpoint(Endpoint));
+    if (!CVarRadioGardenCacheEnabled.GetValueOnAnyThread() || TimeToLive <= 0.0 || !Result.Content.IsValid())
+    {
+        return;
+    }
+
+    FScopeLock Lock(&CriticalSection);
+
+    FEntry* StoredEntry = Entries.Find(Endpoint);
+    if (StoredEntry)
+    {
+        TotalBytes -= StoredEntry->SizeBytes;
+    }
+    else
+    {
+        StoredEntry = &Entries.Add(Endpoint);
+        StoredEntry->LruNode = new FLruNode(Endpoint);
+        LruList.AddHead(StoredEntry->LruNode);
+    }
+
+    FEntry& Entry = *StoredEntry;
+    Touch(Entry);
+    Entry.Content = Result.Content;
+    Entry.ETag = ETag;
+    Entry.LastModified = LastModified;
+    Entry.ExpiresAt = FPlatformTime::Seconds() + TimeToLive;
+    Entry.Version = ++VersionCounter;
+    Entry.SizeBytes = Endpoint.GetAllocatedSize() + Result.Content->GetAllocatedSize() + ETag.GetAllocatedSize() + LastModified.GetAllocatedSize() + sizeof(FEntry);
+    TotalBytes += Entry.SizeBytes;
+
+    Result.ContentVersion = Entry.Version;
+
+    EvictOverBudget();
+}
+
+bool FRadioGardenResponseCache::Revalidate(const FString& Endpoint, FRadioGardenHttpResult& OutResult, const FString& ETag, const FString& LastModified)
+{
+    FScopeLock Lock(&CriticalSection);
+
+    FEntry* Entry = Entries.Find(Endpoint);
+    if (!Entry)
+    {
+        return false;
+    }
+
+    // Сервер может прислать в 304 новые валидаторы: следующий условный запрос должен идти уже с ними
+    if (!ETag.IsEmpty() || !LastModified.IsEmpty())
+    {
+        TotalBytes -= Entry->SizeBytes;
+        Entry->SizeBytes -= Entry->ETag.GetAllocatedSize() + Entry->LastModified.GetAllocatedSize();
+        if (!ETag.IsEmpty())
+        {
+            Entry->ETag = ETag;
+        }
+        if (!LastModified.IsEmpty())
+        {
+            Entry->LastModified = LastModified;
+        }
+        Entry->SizeBytes += Entry->ETag.GetAllocatedSize() + Entry->LastModified.GetAllocatedSize();
+        TotalBytes += Entry->SizeBytes;
+        FRadioGardenStats::CacheBytes.store(TotalBytes, std::memory_order_relaxed);
+    }
+
+    Entry->ExpiresAt = FPlatformTime::Seconds() + GetTimeToLive(FRadioGardenHttpRequest::ClassifyEndpoint(Endpoint));
+    FillResult(*Entry, OutResult);
+    FRadioGardenStats::CacheRevalidations.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void FRadioGardenResponseCache::Empty()
+{
+    FScopeLock Lock(&CriticalSection);
+    Entries.Empty();
+    LruList.Empty();
+    TotalBytes = 0;
+    FRadioGardenStats::CacheBytes.store(0, std::memory_order_relaxed);
+}
+
+void FRadioGardenResponseCache::FillResult(FEntry& Entry, FRadioGardenHttpResult& OutResult)
+{
+    Touch(Entry);
+
+    OutResult.bSuccess = true;
+    OutResult.bFromCache = true;
+    OutResult.ResponseCode = 200;
+    OutResult.Content = Entry.Content;
+    OutResult.ContentVersion = Entry.Version;
+    OutResult.ErrorMessage.Empty();
+}
+
+void FRadioGardenResponseCache::Touch(FEntry& Entry)
+{
+    if (Entry.LruNode != LruList.GetHead())
+    {
+        LruList.RemoveNode(Entry.LruNode, false);
+        LruList.AddHead(Entry.LruNode);
+    }
+}
+
+void FRadioGardenResponseCache::EvictOverBudget()
+{
+    const int64 BudgetBytes = static_cast<int64>(FMath::Max(CVarRadioGardenCacheBudgetMB.GetValueOnAnyThread(), 0)) * 1024 * 1024;
+
+    // Записей столько же, сколько запрошенных эндпоинтов (станции, места, поиски), поэтому самая старая
+    // берётся из хвоста списка LRU, а не поиском по всем записям
+    while (TotalBytes > BudgetBytes && LruList.Num() > 0)
+    {
+        FLruNode* OldestNode = LruList.GetTail();
+
+        const FEntry& OldestEntry = Entries.FindChecked(OldestNode->GetValue());
+        TotalBytes -= OldestEntry.SizeBytes;
+        Entries.Remove(OldestNode->GetValue());
+        LruList.RemoveNode(OldestNode);
+        FRadioGardenStats::CacheEvictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    FRadioGardenStats::CacheBytes.store(TotalBytes, std::memory_order_relaxed);
+}
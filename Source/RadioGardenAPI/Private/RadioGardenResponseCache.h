@@ -0,0 +1,113 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/List.h"
+#include "RadioGardenHttpRequest.h"
+
+/**
+ * Кэш HTTP ответов Radio Garden API в памяти
+ * Записи живут TTL, заданный для класса эндпоинта, после чего перепроверяются условным GET
+ * (If-None-Match / If-Modified-Since). Ответ 304 продлевает запись без повторной загрузки тела.
+ * Общий объём ограничен бюджетом, при превышении вытесняются давно не использованные записи (LRU)
+ */
+class FRadioGardenResponseCache
+{
+public:
+    /** Результат поиска в кэше */
+    enum class ELookup : uint8
+    {
+        /** Записи нет */
+        Miss,
+        /** Запись свежая, можно отдать без запроса */
+        Fresh,
+        /** Запись устарела, нужен условный запрос */
+        Stale
+    };
+
+    /**
+     * Получить экземпляр кэша
+     */
+    static FRadioGardenResponseCache& Get();
+
+    /**
+     * Найти ответ в кэше
+     * @param Endpoint Эндпоинт API
+     * @param OutResult Заполняется содержимым записи для Fresh
+     * @param OutETag ETag записи для Stale
+     * @param OutLastModified Last-Modified записи для Stale
+     */
+    ELookup Find(const FString& Endpoint, FRadioGardenHttpResult& OutResult, FString& OutETag, FString& OutLastModified);
+
+    /**
+     * Сохранить успешный ответ
+     * @param Endpoint Эндпоинт API
+     * @param Result Результат запроса, получает версию содержимого
+     * @param ETag Заголовок ETag ответа
+     * @param LastModified Заголовок Last-Modified ответа
+     */
+    void Store(const FString& Endpoint, FRadioGardenHttpResult& Result, const FString& ETag, const FString& LastModified);
+
+    /**
+     * Продлить запись после ответа 304 Not Modified
+     * @param Endpoint Эндпоинт API
+     * @param OutResult Заполняется содержимым записи
+     * @param ETag Заголовок ETag ответа 304 (пусто - оставить прежний)
+     * @param LastModified Заголовок Last-Modified ответа 304 (пусто - оставить прежний)
+     * @return false если запись успела быть вытеснена
+     */
+    bool Revalidate(const FString& Endpoint, FRadioGardenHttpResult& OutResult, const FString& ETag, const FString& LastModified);
+
+    /**
+     * Очистить кэш
+     */
+    void Empty();
+
+    /**
+     * Получить TTL класса эндпоинта (секунды)
+     */
+    static double GetTimeToLive(ERadioGardenEndpointClass EndpointClass);
+
+private:
+    using FLruList = TDoubleLinkedList<FString>;
+    using FLruNode = FLruList::TDoubleLinkedListNode;
+
+    /** Запись кэша */
+    struct FEntry
+    {
+        FRadioGardenHttpContent Content;
+        FString ETag;
+        FString LastModified;
+        double ExpiresAt = 0.0;
+        uint64 Version = 0;
+        int64 SizeBytes = 0;
+
+        /** Узел записи в списке LRU (владеет список) */
+        FLruNode* LruNode = nullptr;
+    };
+
+    /** Заполнить результат из записи и отметить использование */
+    void FillResult(FEntry& Entry, FRadioGardenHttpResult& OutResult);
+
+    /** Переместить запись в начало списка LRU */
+    void Touch(FEntry& Entry);
+
+    /** Вытеснить записи сверх бюджета */
+    void EvictOverBudget();
+
+    /** Записи по эндпоинту */
+    TMap<FString, FEntry> Entries;
+
+    /** Эндпоинты записей от недавно использованных к давно не использованным */
+    FLruList LruList;
+
+    /** Общий размер записей (байты) */
+    int64 TotalBytes = 0;
+
+    /** Счётчик версий содержимого */
+    uint64 VersionCounter = 0;
+
+    /** Защита состояния кэша */
+    FCriticalSection CriticalSection;
+};
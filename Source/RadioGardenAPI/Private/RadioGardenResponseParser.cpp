@@ -0,0 +1,751 @@
+// by Neil Moore
+
+#include "RadioGardenResponseParser.h"
+#include "RadioGardenJsonSchema.h"
+#include "RadioGardenHttpRequest.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/MemoryBase.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include <atomic>
+
+static TAutoConsoleVariable<int32> CVarRadioGardenParseParallelThresholdKB(
+    TEXT("RadioGarden.Parse.ParallelThresholdKB"),
+    256,
+    TEXT("Размер ответа (КБ), начиная с которого большие массивы разбираются параллельно. 0 - всегда последовательно"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarRadioGardenParseMinElementsPerChunk(
+    TEXT("RadioGarden.Parse.MinElementsPerChunk"),
+    256,
+    TEXT("Минимум элементов массива на одну часть при параллельном разборе; сверить пороги можно командой RadioGarden.Benchmark.PlacesParse"),
+    ECVF_Default);
+
+namespace
+{
+    // ========== Схемы ==========
+
+    // Координаты места: [долгота, широта]
+    void SchemaReadPlaceGeo(FRadioGardenJsonScanner& Scanner, FRadioGardenPlace& OutPlace)
+    {
+        if (Scanner.PeekValue() != FRadioGardenJsonScanner::EValueType::Array)
+        {
+            Scanner.SkipValue();
+            return;
+        }
+
+        Scanner.BeginArray();
+
+        double Coords[2] = { 0.0, 0.0 };
+        int32 Index = 0;
+        while (Scanner.NextElement())
+        {
+            if (Index < 2)
+            {
+                RadioGardenJsonSchema::ReadValue(Scanner, Coords[Index]);
+            }
+            else
+            {
+                Scanner.SkipValue();
+            }
+            ++Index;
+        }
+
+        if (Index >= 2)
+        {
+            OutPlace.Geo.Longitude = Coords[0];
+            OutPlace.Geo.Latitude = Coords[1];
+        }
+    }
+
+    constexpr TRadioGardenJsonField<FRadioGardenPlace> SchemaPlaceFields[] =
+    {
+        RadioGardenJsonField<&FRadioGardenPlace::Id>("id"),
+        RadioGardenJsonField<&FRadioGardenPlace::Title>("title"),
+        RadioGardenJsonField<&FRadioGardenPlace::Country>("country"),
+        RadioGardenJsonField<&FRadioGardenPlace::Url>("url"),
+        RadioGardenJsonField<&FRadioGardenPlace::Size>("size"),
+        RadioGardenJsonField<&FRadioGardenPlace::bBoost>("boost"),
+        RadioGardenJsonCustomField<FRadioGardenPlace>("geo", &SchemaReadPlaceGeo),
+    };
+
+    // Станция в списке станций места: { page: { url: "/listen/station-name/ChannelId", title: "..." } }
+    constexpr TRadioGardenJsonField<FRadioGardenChannel> SchemaChannelPageFields[] =
+    {
+        RadioGardenJsonField<&FRadioGardenChannel::Title>("title"),
+        RadioGardenJsonField<&FRadioGardenChannel::Url>("url"),
+    };
+
+    constexpr TRadioGardenJsonField<FRadioGardenChannel> SchemaChannelItemFields[] =
+    {
+        RadioGardenJsonNestedField<SchemaChannelPageFields>("page"),
+    };
+
+    // Станция из /ara/content/channel/{id}
+    constexpr TRadioGardenJsonField<FRadioGardenChannel> SchemaChannelPlaceFields[] =
+    {
+        RadioGardenJsonField<&FRadioGardenChannel::PlaceId>("id"),
+        RadioGardenJsonField<&FRadioGardenChannel::PlaceTitle>("title"),
+    };
+
+    constexpr TRadioGardenJsonField<FRadioGardenChannel> SchemaChannelCountryFields[] =
+    {
+        RadioGardenJsonField<&FRadioGardenChannel::CountryId>("id"),
+        RadioGardenJsonField<&FRadioGardenChannel::CountryTitle>("title"),
+    };
+
+    constexpr TRadioGardenJsonField<FRadioGardenChannel> SchemaChannelFields[] =
+    {
+        RadioGardenJsonField<&FRadioGardenChannel::Id>("id"),
+        RadioGardenJsonField<&FRadioGardenChannel::Title>("title"),
+        RadioGardenJsonField<&FRadioGardenChannel::Url>("url"),
+        RadioGardenJsonField<&FRadioGardenChannel::Website>("website"),
+        RadioGardenJsonField<&FRadioGardenChannel::bSecure>("secure"),
+        RadioGardenJsonNestedField<SchemaChannelPlaceFields>("place"),
+        RadioGardenJsonNestedField<SchemaChannelCountryFields>("country"),
+    };
+
+    // Результат поиска: { _id, _score, _source: { type, title, subtitle, code, url } }
+    constexpr TRadioGardenJsonField<FRadioGardenSearchResult> SchemaSearchSourceFields[] =
+    {
+        RadioGardenJsonField<&FRadioGardenSearchResult::Type>("type"),
+        RadioGardenJsonField<&FRadioGardenSearchResult::Title>("title"),
+        RadioGardenJsonField<&FRadioGardenSearchResult::Subtitle>("subtitle"),
+        RadioGardenJsonField<&FRadioGardenSearchResult::CountryCode>("code"),
+        RadioGardenJsonField<&FRadioGardenSearchResult::Url>("url"),
+    };
+
+    constexpr TRadioGardenJsonField<FRadioGardenSearchResult> SchemaSearchHitFields[] =
+    {
+        RadioGardenJsonNestedField<SchemaSearchSourceFields>("_source"),
+        RadioGardenJsonField<&FRadioGardenSearchResult::Id>("_id"),
+        RadioGardenJsonField<&FRadioGardenSearchResult::Score>("_score"),
+    };
+
+    constexpr TRadioGardenJsonField<FRadioGardenGeolocation> SchemaGeolocationFields[] =
+    {
+        RadioGardenJsonField<&FRadioGardenGeolocation::Ip>("ip"),
+        RadioGardenJsonField<&FRadioGardenGeolocation::CountryCode>("country_code"),
+        RadioGardenJsonField<&FRadioGardenGeolocation::CountryName>("country_name"),
+        RadioGardenJsonField<&FRadioGardenGeolocation::RegionCode>("region_code"),
+        RadioGardenJsonField<&FRadioGardenGeolocation::RegionName>("region_name"),
+        RadioGardenJsonField<&FRadioGardenGeolocation::City>("city"),
+        RadioGardenJsonField<&FRadioGardenGeolocation::ZipCode>("zip_code"),
+        RadioGardenJsonField<&FRadioGardenGeolocation::TimeZone>("time_zone"),
+        RadioGardenJsonField<&FRadioGardenGeolocation::Latitude>("latitude"),
+        RadioGardenJsonField<&FRadioGardenGeolocation::Longitude>("longitude"),
+        RadioGardenJsonField<&FRadioGardenGeolocation::MetroCode>("metro_code"),
+    };
+
+    // ========== Обход ответа ==========
+
+    // Обойти объект и вызвать Visit для значения с ключом Key (Visit обязан прочитать значение).
+    // Остальные значения пропускаются, объект дочитывается до конца
+    template <typename FuncType>
+    bool ParserVisitMember(FRadioGardenJsonScanner& Scanner, const ANSICHAR* Key, FuncType&& Visit)
+    {
+        if (Scanner.PeekValue() != FRadioGardenJsonScanner::EValueType::Object)
+        {
+            Scanner.SkipValue();
+            return false;
+        }
+
+        Scanner.BeginObject();
+
+        bool bFound = false;
+        FUtf8StringView MemberKey;
+        while (Scanner.NextKey(MemberKey))
+        {
+            if (!bFound && FRadioGardenJsonScanner::KeyEquals(MemberKey, Key))
+            {
+                bFound = true;
+                Visit();
+            }
+            else
+            {
+                Scanner.SkipValue();
+            }
+        }
+
+        return bFound;
+    }
+
+    // Обойти массив и вызвать Visit для каждого элемента (Visit обязан прочитать элемент)
+    template <typename FuncType>
+    bool ParserVisitElements(FRadioGardenJsonScanner& Scanner, FuncType&& Visit)
+    {
+        if (Scanner.PeekValue() != FRadioGardenJsonScanner::EValueType::Array)
+        {
+            Scanner.SkipValue();
+            return false;
+        }
+
+        Scanner.BeginArray();
+
+        int32 Index = 0;
+        while (Scanner.NextElement())
+        {
+            Visit(Index++);
+        }
+
+        return true;
+    }
+
+    // Порог параллельного разбора для текущего потока (КБ, -1 - из RadioGarden.Parse.ParallelThresholdKB):
+    // бенчмарк сравнивает последовательный и параллельный разбор, не меняя настройку для остальных запросов
+    thread_local int32 ParserParallelThresholdOverrideKB = -1;
+
+    template <typename StructType, int32 FieldCount>
+    void ParserReadArrayElement(FRadioGardenJsonScanner& Scanner, TArray<StructType>& OutItems,
+        const TRadioGardenJsonField<StructType> (&Fields)[FieldCount], bool (*Accept)(StructType&, uint64))
+    {
+        if (Scanner.PeekValue() != FRadioGardenJsonScanner::EValueType::Object)
+        {
+            Scanner.SkipValue();
+            return;
+        }
+
+        StructType Item;
+        const uint64 SeenMask = RadioGardenJsonSchema::ReadObject(Scanner, Item, Fields);
+        if (Accept(Item, SeenMask))
+        {
+            OutItems.Add(MoveTemp(Item));
+        }
+    }
+
+    // Прочитать массив объектов по схеме. Элементы, не являющиеся объектами, и отклонённые Accept пропускаются.
+    // В больших ответах массив сначала делится на элементы одним проходом по байтам,
+    // затем части разбираются в ParallelFor и склеиваются в исходном порядке
+    template <typename StructType, int32 FieldCount>
+    bool ParserReadObjectArray(FRadioGardenJsonScanner& Scanner, int32 PayloadSize, TArray<StructType>& OutItems,
+        const TRadioGardenJsonField<StructType> (&Fields)[FieldCount], bool (*Accept)(StructType&, uint64))
+    {
+        if (Scanner.PeekValue() != FRadioGardenJsonScanner::EValueType::Array)
+        {
+            Scanner.SkipValue();
+            return false;
+        }
+
+        const int32 ThresholdKB = ParserParallelThresholdOverrideKB >= 0
+            ? ParserParallelThresholdOverrideKB
+            : CVarRadioGardenParseParallelThresholdKB.GetValueOnAnyThread();
+        if (ThresholdKB <= 0 || PayloadSize < ThresholdKB * 1024)
+        {
+            ParserVisitElements(Scanner, [&](int32)
+            {
+                ParserReadArrayElement(Scanner, OutItems, Fields, Accept);
+            });
+            return true;
+        }
+
+        TArray<FUtf8StringView> Elements;
+        if (!Scanner.SplitArray(Elements))
+        {
+            return true;
+        }
+
+        const int32 MaxChunks = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+        const int32 MinElementsPerChunk = FMath::Max(1, CVarRadioGardenParseMinElementsPerChunk.GetValueOnAnyThread());
+        const int32 NumChunks = FMath::Clamp(Elements.Num() / MinElementsPerChunk, 1, MaxChunks);
+
+        struct FChunk
+        {
+            TArray<StructType> Items;
+            bool bError = false;
+        };
+        TArray<FChunk> Chunks;
+        Chunks.SetNum(NumChunks);
+
+        ParallelFor(NumChunks, [&Elements, &Chunks, &Fields, Accept, NumChunks](int32 ChunkIndex)
+        {
+            const int32 Begin = static_cast<int32>(static_cast<int64>(Elements.Num()) * ChunkIndex / NumChunks);
+            const int32 End = static_cast<int32>(static_cast<int64>(Elements.Num()) * (ChunkIndex + 1) / NumChunks);
+
+            FChunk& Chunk = Chunks[ChunkIndex];
+            Chunk.Items.Reserve(End - Begin);
+            for (int32 Index = Begin; Index < End; ++Index)
+            {
+                FRadioGardenJsonScanner ElementScanner(Elements[Index]);
+                ParserReadArrayElement(ElementScanner, Chunk.Items, Fields, Accept);
+                if (ElementScanner.HasError())
+                {
+                    Chunk.bError = true;
+                    return;
+                }
+            }
+        }, NumChunks == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+        int32 TotalItems = 0;
+        for (const FChunk& Chunk : Chunks)
+        {
+            if (Chunk.bError)
+            {
+                Scanner.SetError();
+                return true;
+            }
+            TotalItems += Chunk.Items.Num();
+        }
+
+        OutItems.Reserve(OutItems.Num() + TotalItems);
+        for (FChunk& Chunk : Chunks)
+        {
+            OutItems.Append(MoveTemp(Chunk.Items));
+        }
+
+        return true;
+    }
+
+    bool ParserAcceptPlace(FRadioGardenPlace& Place, uint64 SeenMask)
+    {
+        return true;
+    }
+
+    bool ParserCheckScanner(const FRadioGardenJsonScanner& Scanner, FString& OutErrorMessage)
+    {
+        if (Scanner.HasError())
+        {
+            OutErrorMessage = FString::Printf(TEXT("Failed to parse JSON at offset %d"), Scanner.GetPosition());
+            return false;
+        }
+        return true;
+    }
+
+    // Элементы без page (поле 0 схемы) пропускаются.
+    // ID станции берётся из URL страницы (формат: /listen/station-name/ChannelId)
+    bool ParserAcceptChannelItem(FRadioGardenChannel& Channel, uint64 SeenMask)
+    {
+        if (!(SeenMask & 1))
+        {
+            return false;
+        }
+
+        if (!Channel.Url.IsEmpty())
+        {
+            TArray<FString> Parts;
+            Channel.Url.ParseIntoArray(Parts, TEXT("/"), true);
+            if (Parts.Num() >= 2)
+            {
+                Channel.Id = Parts[Parts.Num() - 1];
+            }
+        }
+
+        return true;
+    }
+
+    bool ExtractPlacesFromDom(const TSharedPtr<FJsonObject>& JsonObject, TArray<FRadioGardenPlace>& OutPlaces, FString& OutErrorMessage)
+    {
+        TSharedPtr<FJsonObject> DataObj;
+        const TArray<TSharedPtr<FJsonValue>>* PlacesArray;
+        if (!FRadioGardenHttpRequest::GetObjectSafe(JsonObject, TEXT("data"), DataObj) ||
+            !FRadioGardenHttpRequest::GetArraySafe(DataObj, TEXT("list"), PlacesArray))
+        {
+            OutErrorMessage = TEXT("Invalid response format");
+            return false;
+        }
+
+        OutPlaces.Reserve(PlacesArray->Num());
+        for (const TSharedPtr<FJsonValue>& PlaceValue : *PlacesArray)
+        {
+            const TSharedPtr<FJsonObject>& PlaceObj = PlaceValue->AsObject();
+            if (!PlaceObj.IsValid())
+            {
+                continue;
+            }
+
+            FRadioGardenPlace& Place = OutPlaces.AddDefaulted_GetRef();
+            Place.Id = FRadioGardenHttpRequest::GetStringSafe(PlaceObj, TEXT("id"));
+            Place.Title = FRadioGardenHttpRequest::GetStringSafe(PlaceObj, TEXT("title"));
+            Place.Country = FRadioGardenHttpRequest::GetStringSafe(PlaceObj, TEXT("country"));
+            Place.Url = FRadioGardenHttpRequest::GetStringSafe(PlaceObj, TEXT("url"));
+            Place.Size = static_cast<int32>(FRadioGardenHttpRequest::GetNumberSafe(PlaceObj, TEXT("size")));
+            Place.bBoost = FRadioGardenHttpRequest::GetBoolSafe(PlaceObj, TEXT("boost"));
+
+            const TArray<TSharedPtr<FJsonValue>>* GeoArray;
+            if (PlaceObj->TryGetArrayField(TEXT("geo"), GeoArray) && GeoArray->Num() >= 2)
+            {
+                Place.Geo.Longitude = (*GeoArray)[0]->AsNumber();
+                Place.Geo.Latitude = (*GeoArray)[1]->AsNumber();
+            }
+        }
+
+        return true;
+    }
+
+    // Итог одного варианта разбора в сравнении
+    struct FParseBenchmarkTotals
+    {
+        double Seconds = 0.0;
+        double PeakMB = 0.0;
+        int32 Places = 0;
+    };
+
+    // Замерить один прогон разбора: время и пик памяти процесса относительно начала прогона.
+    // Пик берётся из PeakUsedPhysical, если прогон его поднял, иначе из опроса UsedPhysical отдельным потоком
+    // во время разбора: значение после разбора пик не показывает, временные строки и дерево уже освобождены
+    void MeasurePlacesParse(TFunctionRef<int32()> Parse, FParseBenchmarkTotals& Totals)
+    {
+        // Возвращаем системе память, закэшированную аллокатором после прошлого прогона, чтобы она не скрыла рост
+        GMalloc->Trim(true);
+
+        const FPlatformMemoryStats StartStats = FPlatformMemory::GetStats();
+        std::atomic<bool> bSampling{true};
+        std::atomic<uint64> SampledPeak{StartStats.UsedPhysical};
+
+        TFuture<void> Sampler = Async(EAsyncExecution::Thread, [&bSampling, &SampledPeak]()
+        {
+            while (bSampling.load(std::memory_order_relaxed))
+            {
+                const uint64 Used = FPlatformMemory::GetStats().UsedPhysical;
+                uint64 Peak = SampledPeak.load(std::memory_order_relaxed);
+                while (Used > Peak && !SampledPeak.compare_exchange_weak(Peak, Used, std::memory_order_relaxed))
+                {
+                }
+                FPlatformProcess::Sleep(0.0005f);
+            }
+        });
+
+        const double StartTime = FPlatformTime::Seconds();
+        Totals.Places = Parse();
+        Totals.Seconds += FPlatformTime::Seconds() - StartTime;
+
+        bSampling.store(false, std::memory_order_relaxed);
+        Sampler.Wait();
+
+        const FPlatformMemoryStats EndStats = FPlatformMemory::GetStats();
+        uint64 Peak = SampledPeak.load(std::memory_order_relaxed);
+        if (EndStats.PeakUsedPhysical > StartStats.PeakUsedPhysical)
+        {
+            Peak = FMath::Max<uint64>(Peak, EndStats.PeakUsedPhysical);
+        }
+
+        const double PeakMB = static_cast<double>(Peak - FMath::Min<uint64>(Peak, StartStats.UsedPhysical)) / (1024.0 * 1024.0);
+        Totals.PeakMB = FMath::Max(Totals.PeakMB, PeakMB);
+    }
+
+    // Потоковый разбор с заданным порогом параллельного разбора (0 - последовательно)
+    int32 ParsePlacesWithThreshold(FUtf8StringView Json, int32 ThresholdKB)
+    {
+        const int32 PreviousThresholdKB = ParserParallelThresholdOverrideKB;
+        ParserParallelThresholdOverrideKB = ThresholdKB;
+
+        TArray<FRadioGardenPlace> Places;
+        FString ErrorMessage;
+        FRadioGardenResponseParser::ParsePlaces(Json, Places, ErrorMessage);
+
+        ParserParallelThresholdOverrideKB = PreviousThresholdKB;
+        return Places.Num();
+    }
+
+    // Сравнение DOM и потокового разбора на реальном ответе /ara/content/places.
+    // DOM вариант повторяет прежний путь: конвертация тела в FString и дерево FJsonObject.
+    // Варианты чередуются по итерациям, чтобы ни один не шёл всегда вторым на прогретом аллокаторе;
+    // память - пик UsedPhysical процесса за прогон, поэтому значения приблизительные.
+    // Отдельно потоковый разбор сравнивается последовательно и по частям при любом размере ответа:
+    // по ускорению подбираются RadioGarden.Parse.ParallelThresholdKB и RadioGarden.Parse.MinElementsPerChunk
+    void RunPlacesParseBenchmark(int32 Iterations)
+    {
+        FRadioGardenHttpResult Result;
+        FRadioGardenHttpRequest::ExecuteGet(TEXT("/ara/content/places"), Result);
+        if (!Result.bSuccess)
+        {
+            UE_LOG(LogRadioGardenAPI, Warning, TEXT("Places benchmark: request failed: %s"), *Result.ErrorMessage);
+            return;
+        }
+
+        const FUtf8StringView Json = Result.GetContentView();
+
+        auto ParseDom = [Json]()
+        {
+            TArray<FRadioGardenPlace> Places;
+            FString ErrorMessage;
+            TSharedPtr<FJsonObject> JsonObject;
+            if (FRadioGardenHttpRequest::ParseJson(FString(Json), JsonObject))
+            {
+                ExtractPlacesFromDom(JsonObject, Places, ErrorMessage);
+            }
+            return Places.Num();
+        };
+
+        auto ParseStreaming = [Json]()
+        {
+            TArray<FRadioGardenPlace> Places;
+            FString ErrorMessage;
+            FRadioGardenResponseParser::ParsePlaces(Json, Places, ErrorMessage);
+            return Places.Num();
+        };
+
+        FParseBenchmarkTotals Dom;
+        FParseBenchmarkTotals Streaming;
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            if (Iteration % 2 == 0)
+            {
+                MeasurePlacesParse(ParseDom, Dom);
+                MeasurePlacesParse(ParseStreaming, Streaming);
+            }
+            else
+            {
+                MeasurePlacesParse(ParseStreaming, Streaming);
+                MeasurePlacesParse(ParseDom, Dom);
+            }
+        }
+
+        UE_LOG(LogRadioGardenAPI, Log, TEXT("Places benchmark (%d bytes, %d iterations):"), Json.Len(), Iterations);
+        UE_LOG(LogRadioGardenAPI, Log, TEXT("  DOM:       %.2f ms, ~%.1f MB peak, %d places"), Dom.Seconds * 1000.0 / Iterations, Dom.PeakMB, Dom.Places);
+        UE_LOG(LogRadioGardenAPI, Log, TEXT("  Streaming: %.2f ms, ~%.1f MB peak, %d places"), Streaming.Seconds * 1000.0 / Iterations, Streaming.PeakMB, Streaming.Places);
+
+        // Сводка одной строкой для сравнения машин и версий
+        UE_LOG(LogRadioGardenAPI, Log, TEXT("  Streaming vs DOM: %.1fx faster, %.1fx less peak memory"),
+            Dom.Seconds / FMath::Max(Streaming.Seconds, UE_SMALL_NUMBER), Dom.PeakMB / FMath::Max(Streaming.PeakMB, 0.1));
+
+        // Порог 1 КБ включает разбор по частям для любого реального ответа
+        FParseBenchmarkTotals Serial;
+        FParseBenchmarkTotals Chunked;
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            auto ParseSerial = [Json]() { return ParsePlacesWithThreshold(Json, 0); };
+            auto ParseChunked = [Json]() { return ParsePlacesWithThreshold(Json, 1); };
+            if (Iteration % 2 == 0)
+            {
+                MeasurePlacesParse(ParseSerial, Serial);
+                MeasurePlacesParse(ParseChunked, Chunked);
+            }
+            else
+            {
+                MeasurePlacesParse(ParseChunked, Chunked);
+                MeasurePlacesParse(ParseSerial, Serial);
+            }
+        }
+
+        const int32 MaxChunks = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+        const int32 NumChunks = FMath::Clamp(Chunked.Places / FMath::Max(1, CVarRadioGardenParseMinElementsPerChunk.GetValueOnAnyThread()), 1, MaxChunks);
+        UE_LOG(LogRadioGardenAPI, Log, TEXT("  Serial:    %.2f ms"), Serial.Seconds * 1000.0 / Iterations);
+        UE_LOG(LogRadioGardenAPI, Log, TEXT("  Chunked:   %.2f ms (%d chunks, %d worker threads), %.2fx speedup"),
+            Chunked.Seconds * 1000.0 / Iterations, NumChunks, MaxChunks - 1, Serial.Seconds / FMath::Max(Chunked.Seconds, UE_SMALL_NUMBER));
+    }
+}
+
+static FAutoConsoleCommand CmdRadioGardenBenchmarkPlacesParse(
+    TEXT("RadioGarden.Benchmark.PlacesParse"),
+    TEXT("Сравнить время и память DOM и потокового разбора списка мест. Аргумент: число итераций (по умолчанию 10)"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        const int32 Iterations = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10;
+
+        // Запрос и разбор не должны занимать игровой поток
+        AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Iterations]()
+        {
+            RunPlacesParseBenchmark(Iterations);
+        });
+    }));
+
+bool FRadioGardenResponseParser::ParsePlaces(FUtf8StringView Json, TArray<FRadioGardenPlace>& OutPlaces, FString& OutErrorMessage)
+{
+    OutPlaces.Reset();
+
+    FRadioGardenJsonScanner Scanner(Json);
+    bool bFoundList = false;
+
+    ParserVisitMember(Scanner, "data", [&]()
+    {
+        ParserVisitMember(Scanner, "list", [&]()
+        {
+            bFoundList = ParserReadObjectArray(Scanner, Json.Len(), OutPlaces, SchemaPlaceFields, &ParserAcceptPlace);
+        });
+    });
+
+    if (!ParserCheckScanner(Scanner, OutErrorMessage))
+    {
+        OutPlaces.Reset();
+        return false;
+    }
+
+    if (!bFoundList)
+    {
+        OutErrorMessage = TEXT("Invalid response format");
+        return false;
+    }
+
+    return true;
+}
+
+bool FRadioGardenResponseParser::ParsePlaceChannels(FUtf8StringView Json, TArray<FRadioGardenChannel>& OutChannels, FString& OutErrorMessage)
+{
+    OutChannels.Reset();
+
+    FRadioGardenJsonScanner Scanner(Json);
+    bool bDataIsObject = false;
+    bool bFoundContent = false;
+    bool bContentIsObject = false;
+    bool bFoundItems = false;
+
+    ParserVisitMember(Scanner, "data", [&]()
+    {
+        bDataIsObject = Scanner.PeekValue() == FRadioGardenJsonScanner::EValueType::Object;
+        ParserVisitMember(Scanner, "content", [&]()
+        {
+            // Станции лежат в первом элементе content
+            ParserVisitElements(Scanner, [&](int32 Index)
+            {
+                if (Index != 0)
+                {
+                    Scanner.SkipValue();
+                    return;
+                }
+
+                bFoundContent = true;
+                bContentIsObject = Scanner.PeekValue() == FRadioGardenJsonScanner::EValueType::Object;
+
+                ParserVisitMember(Scanner, "items", [&]()
+                {
+                    bFoundItems = ParserReadObjectArray(Scanner, Json.Len(), OutChannels, SchemaChannelItemFields, &ParserAcceptChannelItem);
+                });
+            });
+        });
+    });
+
+    if (!ParserCheckScanner(Scanner, OutErrorMessage))
+    {
+        OutChannels.Reset();
+        return false;
+    }
+
+    if (!bDataIsObject)
+    {
+        OutErrorMessage = TEXT("Invalid response format");
+        return false;
+    }
+
+    if (!bFoundContent)
+    {
+        OutErrorMessage = TEXT("No channels found");
+        return false;
+    }
+
+    if (!bContentIsObject)
+    {
+        OutErrorMessage = TEXT("Invalid content format");
+        return false;
+    }
+
+    if (!bFoundItems)
+    {
+        OutErrorMessage = TEXT("Invalid items format");
+        return false;
+    }
+
+    return true;
+}
+
+bool FRadioGardenResponseParser::ParseChannel(FUtf8StringView Json, FRadioGardenChannel& OutChannel, FString& OutErrorMessage)
+{
+    OutChannel = FRadioGardenChannel();
+
+    FRadioGardenJsonScanner Scanner(Json);
+    bool bDataIsObject = false;
+
+    ParserVisitMember(Scanner, "data", [&]()
+    {
+        bDataIsObject = Scanner.PeekValue() == FRadioGardenJsonScanner::EValueType::Object;
+        RadioGardenJsonSchema::ReadObject(Scanner, OutChannel, SchemaChannelFields);
+    });
+
+    if (!ParserCheckScanner(Scanner, OutErrorMessage))
+    {
+        return false;
+    }
+
+    if (!bDataIsObject)
+    {
+        OutErrorMessage = TEXT("Invalid response format");
+        return false;
+    }
+
+    return true;
+}
+
+bool FRadioGardenResponseParser::ParseSearch(FUtf8StringView Json, int32& OutTimeTaken, TArray<FRadioGardenSearchResult>& OutResults, FString& OutErrorMessage)
+{
+    OutTimeTaken = 0;
+    OutResults.Reset();
+
+    FRadioGardenJsonScanner Scanner(Json);
+    bool bRootIsObject = false;
+    bool bHitsIsObject = false;
+
+    if (Scanner.PeekValue() == FRadioGardenJsonScanner::EValueType::Object)
+    {
+        bRootIsObject = true;
+        Scanner.BeginObject();
+
+        FUtf8StringView Key;
+        while (Scanner.NextKey(Key))
+        {
+            if (FRadioGardenJsonScanner::KeyEquals(Key, "took"))
+            {
+                RadioGardenJsonSchema::ReadValue(Scanner, OutTimeTaken);
+            }
+            else if (FRadioGardenJsonScanner::KeyEquals(Key, "hits") && Scanner.PeekValue() == FRadioGardenJsonScanner::EValueType::Object)
+            {
+                bHitsIsObject = true;
+                ParserVisitMember(Scanner, "hits", [&]()
+                {
+                    ParserVisitElements(Scanner, [&](int32)
+                    {
+                        // Результаты без _source (поле 0 схемы) пропускаются
+                        FRadioGardenSearchResult Result;
+                        if (RadioGardenJsonSchema::ReadObject(Scanner, Result, SchemaSearchHitFields) & 1)
+                        {
+                            OutResults.Add(MoveTemp(Result));
+                        }
+                    });
+                });
+            }
+            else
+            {
+                Scanner.SkipValue();
+            }
+        }
+    }
+
+    if (!ParserCheckScanner(Scanner, OutErrorMessage))
+    {
+        OutResults.Reset();
+        return false;
+    }
+
+    if (!bRootIsObject || !bHitsIsObject)
+    {
+        OutErrorMessage = TEXT("Invalid response format");
+        return false;
+    }
+
+    return true;
+}
+
+bool FRadioGardenResponseParser::ParseGeolocation(FUtf8StringView Json, FRadioGardenGeolocation& OutGeolocation, FString& OutErrorMessage)
+{
+    OutGeolocation = FRadioGardenGeolocation();
+
+    FRadioGardenJsonScanner Scanner(Json);
+    const bool bRootIsObject = Scanner.PeekValue() == FRadioGardenJsonScanner::EValueType::Object;
+    RadioGardenJsonSchema::ReadObject(Scanner, OutGeolocation, SchemaGeolocationFields);
+
+    if (!ParserCheckScanner(Scanner, OutErrorMessage))
+    {
+        return false;
+    }
+
+    if (!bRootIsObject)
+    {
+        OutErrorMessage = TEXT("Invalid response format");
+        return false;
+    }
+
+    return true;
+}
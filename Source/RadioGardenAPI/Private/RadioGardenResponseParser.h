@@ -0,0 +1,61 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RadioGardenTypes.h"
+
+/**
+ * Разбор ответов API без построения дерева FJsonObject
+ * Поля читаются потоковым сканером прямо в структуры результата по таблицам схем (RadioGardenJsonSchema.h)
+ */
+class FRadioGardenResponseParser
+{
+public:
+    /**
+     * Разобрать список мест (data.list) потоковым сканером
+     * Строки конвертируются из UTF-8 только для читаемых полей
+     * @param Json Тело ответа в UTF-8
+     * @param OutPlaces Места
+     * @param OutErrorMessage Сообщение об ошибке
+     * @return true если успешно
+     */
+    static bool ParsePlaces(FUtf8StringView Json, TArray<FRadioGardenPlace>& OutPlaces, FString& OutErrorMessage);
+
+    /**
+     * Разобрать станции места (data.content[0].items)
+     * @param Json Тело ответа в UTF-8
+     * @param OutChannels Станции
+     * @param OutErrorMessage Сообщение об ошибке
+     * @return true если успешно
+     */
+    static bool ParsePlaceChannels(FUtf8StringView Json, TArray<FRadioGardenChannel>& OutChannels, FString& OutErrorMessage);
+
+    /**
+     * Разобрать информацию о станции (data)
+     * @param Json Тело ответа в UTF-8
+     * @param OutChannel Станция
+     * @param OutErrorMessage Сообщение об ошибке
+     * @return true если успешно
+     */
+    static bool ParseChannel(FUtf8StringView Json, FRadioGardenChannel& OutChannel, FString& OutErrorMessage);
+
+    /**
+     * Разобрать результаты поиска (took, hits.hits)
+     * @param Json Тело ответа в UTF-8
+     * @param OutTimeTaken Время поиска на сервере
+     * @param OutResults Результаты
+     * @param OutErrorMessage Сообщение об ошибке
+     * @return true если успешно
+     */
+    static bool ParseSearch(FUtf8StringView Json, int32& OutTimeTaken, TArray<FRadioGardenSearchResult>& OutResults, FString& OutErrorMessage);
+
+    /**
+     * Разобрать геолокацию клиента
+     * @param Json Тело ответа в UTF-8
+     * @param OutGeolocation Геолокация
+     * @param OutErrorMessage Сообщение об ошибке
+     * @return true если успешно
+     */
+    static bool ParseGeolocation(FUtf8StringView Json, FRadioGardenGeolocation& OutGeolocation, FString& OutErrorMessage);
+};
@@ -0,0 +1,183 @@
+// by Neil Moore
+
+#include "RadioGardenRetry.h"
+#include "RadioGardenStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+static TAutoConsoleVariable<int32> CVarRadioGardenRetryMaxAttempts(
+    TEXT("RadioGarden.Retry.MaxAttempts"),
+    3,
+    TEXT("Сколько раз всего пытаться выполнить запрос при временных ошибках (1 - без повторов)"));
+
+static TAutoConsoleVariable<float> CVarRadioGardenRetryBaseDelay(
+    TEXT("RadioGarden.Retry.BaseDelay"),
+    0.25f,
+    TEXT("Пауза перед первым повтором (секунды), дальше удваивается"));
+
+static TAutoConsoleVariable<float> CVarRadioGardenRetryMaxDelay(
+    TEXT("RadioGarden.Retry.MaxDelay"),
+    8.0f,
+    TEXT("Наибольшая пауза между попытками (секунды); при Retry-After дальше неё запрос не повторяется"));
+
+static TAutoConsoleVariable<int32> CVarRadioGardenCircuitBreakerFailureThreshold(
+    TEXT("RadioGarden.CircuitBreaker.FailureThreshold"),
+    5,
+    TEXT("Сколько неудачных запросов к хосту подряд открывают предохранитель (0 - предохранитель выключен)"));
+
+static TAutoConsoleVariable<float> CVarRadioGardenCircuitBreakerOpenSeconds(
+    TEXT("RadioGarden.CircuitBreaker.OpenSeconds"),
+    15.0f,
+    TEXT("Сколько секунд открытый предохранитель отклоняет запросы до пробного"));
+
+namespace
+{
+    // Нет ответа (обрыв, таймаут) или ошибка сервера
+    bool IsUpstreamFailure(const FRadioGardenHttpResult& Result)
+    {
+        return Result.ResponseCode == 0 || Result.ResponseCode >= 500;
+    }
+}
+
+bool FRadioGardenRetryPolicy::IsRetryable(const FRadioGardenHttpResult& Result)
+{
+    return IsUpstreamFailure(Result) || Result.ResponseCode == 429;
+}
+
+bool FRadioGardenRetryPolicy::GetRetryDelay(int32 Attempt, const FRadioGardenHttpResult& Result, double& OutDelaySeconds)
+{
+    if (Result.bSuccess || !IsRetryable(Result) || Attempt >= CVarRadioGardenRetryMaxAttempts.GetValueOnAnyThread())
+    {
+        return false;
+    }
+
+    const double MaxDelay = FMath::Max(0.0f, CVarRadioGardenRetryMaxDelay.GetValueOnAnyThread());
+    const double BaseDelay = FMath::Max(0.0f, CVarRadioGardenRetryBaseDelay.GetValueOnAnyThread());
+    const double Backoff = FMath::Min(MaxDelay, BaseDelay * FMath::Pow(2.0, FMath::Min(Attempt - 1, 30)));
+    OutDelaySeconds = FMath::FRandRange(0.0, Backoff);
+
+    double RetryAfter = 0.0;
+    if (ParseRetryAfter(Result.RetryAfter, RetryAfter))
+    {
+        if (RetryAfter > MaxDelay)
+        {
+            return false;
+        }
+        OutDelaySeconds = FMath::Max(OutDelaySeconds, RetryAfter);
+    }
+
+    return true;
+}
+
+bool FRadioGardenRetryPolicy::ParseRetryAfter(const FString& Value, double& OutSeconds)
+{
+    const FString Trimmed = Value.TrimStartAndEnd();
+    if (Trimmed.IsEmpty())
+    {
+        return false;
+    }
+
+    if (Trimmed.IsNumeric())
+    {
+        OutSeconds = FMath::Max(0.0, FCString::Atod(*Trimmed));
+        return true;
+    }
+
+    FDateTime Date;
+    if (FDateTime::ParseHttpDate(Trimmed, Date))
+    {
+        OutSeconds = FMath::Max(0.0, (Date - FDateTime::UtcNow()).GetTotalSeconds());
+        return true;
+    }
+
+    return false;
+}
+
+FRadioGardenCircuitBreaker& FRadioGardenCircuitBreaker::Get()
+{
+    static FRadioGardenCircuitBreaker Instance;
+    return Instance;
+}
+
+bool FRadioGardenCircuitBreaker::AllowRequest(const FString& Host, FRadioGardenHttpResult& OutResult)
+{
+    if (CVarRadioGardenCircuitBreakerFailureThreshold.GetValueOnAnyThread() <= 0)
+    {
+        return true;
+    }
+
+    FScopeLock Lock(&CriticalSection);
+
+    FHostState* HostState = Hosts.Find(Host);
+    if (!HostState || HostState->State == EState::Closed)
+    {
+        return true;
+    }
+
+    // Один пробный запрос после паузы, остальные ждут его результата
+    if (HostState->State == EState::Open && FPlatformTime::Seconds() >= HostState->RetryTime)
+    {
+        HostState->State = EState::HalfOpen;
+    }
+
+    if (HostState->State == EState::HalfOpen && !HostState->bProbeInFlight)
+    {
+        HostState->bProbeInFlight = true;
+        return true;
+    }
+
+    FRadioGardenStats::CircuitBreakerRejections.fetch_add(1, std::memory_order_relaxed);
+
+    OutResult = FRadioGardenHttpResult();
+    OutResult.ErrorMessage = FString::Printf(TEXT("Circuit breaker is open for %s"), *Host);
+    return false;
+}
+
+void FRadioGardenCircuitBreaker::RecordResult(const FString& Host, const FRadioGardenHttpResult& Result)
+{
+    const int32 FailureThreshold = CVarRadioGardenCircuitBreakerFailureThreshold.GetValueOnAnyThread();
+    if (FailureThreshold <= 0)
+    {
+        return;
+    }
+
+    FScopeLock Lock(&CriticalSection);
+
+    // Отменённый запрос ничего не говорит о хосте, но освобождает место пробного запроса
+    if (Result.bCancelled)
+    {
+        if (FHostState* HostState = Hosts.Find(Host))
+        {
+            HostState->bProbeInFlight = false;
+        }
+        return;
+    }
+
+    if (!IsUpstreamFailure(Result))
+    {
+        Hosts.Remove(Host);
+        return;
+    }
+
+    FHostState& HostState = Hosts.FindOrAdd(Host);
+    ++HostState.ConsecutiveFailures;
+
+    // Неудачная проба или порог неудач подряд открывают предохранитель
+    if (HostState.State == EState::HalfOpen || HostState.ConsecutiveFailures >= FailureThreshold)
+    {
+        if (HostState.State == EState::Closed)
+        {
+            UE_LOG(LogRadioGardenAPI, Warning, TEXT("RadioGarden API circuit breaker opened for %s after %d failures"), *Host, HostState.ConsecutiveFailures);
+        }
+
+        HostState.State = EState::Open;
+        HostState.RetryTime = FPlatformTime::Seconds() + FMath::Max(0.0f, CVarRadioGardenCircuitBreakerOpenSeconds.GetValueOnAnyThread());
+        HostState.bProbeInFlight = false;
+    }
+}
+
+void FRadioGardenCircuitBreaker::Reset()
+{
+    FScopeLock Lock(&CriticalSection);
+    Hosts.Empty();
+}
@@ -0,0 +1,91 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RadioGardenHttpRequest.h"
+
+/**
+ * Политика повторов HTTP запросов
+ * Повторяются только временные ошибки: нет ответа (обрыв, таймаут), 429 и 5xx; прочие 4xx - никогда.
+ * Пауза растёт экспоненциально от RadioGarden.Retry.BaseDelay до RadioGarden.Retry.MaxDelay со случайным
+ * разбросом (full jitter); если сервер прислал Retry-After, пауза не короче него
+ */
+class FRadioGardenRetryPolicy
+{
+public:
+    /**
+     * Стоит ли повторять запрос с таким результатом
+     */
+    static bool IsRetryable(const FRadioGardenHttpResult& Result);
+
+    /**
+     * Пауза перед следующей попыткой
+     * @param Attempt Номер завершившейся попытки (с 1)
+     * @param Result Её результат
+     * @param OutDelaySeconds Пауза (секунды)
+     * @return false если повторять не нужно: ошибка постоянная, попытки кончились или Retry-After дальше MaxDelay
+     */
+    static bool GetRetryDelay(int32 Attempt, const FRadioGardenHttpResult& Result, double& OutDelaySeconds);
+
+    /**
+     * Разобрать заголовок Retry-After: число секунд или HTTP дата
+     * @return false если заголовок пуст или не разобран
+     */
+    static bool ParseRetryAfter(const FString& Value, double& OutSeconds);
+};
+
+/**
+ * Предохранитель (circuit breaker) по хостам
+ * После RadioGarden.CircuitBreaker.FailureThreshold подряд неудачных запросов к хосту (нет ответа или 5xx)
+ * запросы к нему сразу завершаются ошибкой в течение RadioGarden.CircuitBreaker.OpenSeconds,
+ * затем пропускается один пробный запрос: успех закрывает предохранитель, неудача снова открывает
+ */
+class FRadioGardenCircuitBreaker
+{
+public:
+    /**
+     * Получить экземпляр
+     */
+    static FRadioGardenCircuitBreaker& Get();
+
+    /**
+     * Можно ли отправить запрос к хосту
+     * @param Host Хост
+     * @param OutResult Результат-ошибка, если запрос отклонён
+     */
+    bool AllowRequest(const FString& Host, FRadioGardenHttpResult& OutResult);
+
+    /**
+     * Учесть результат запроса к хосту
+     */
+    void RecordResult(const FString& Host, const FRadioGardenHttpResult& Result);
+
+    /**
+     * Сбросить состояние всех хостов
+     */
+    void Reset();
+
+private:
+    enum class EState : uint8
+    {
+        Closed,
+        Open,
+        HalfOpen
+    };
+
+    struct FHostState
+    {
+        EState State = EState::Closed;
+        int32 ConsecutiveFailures = 0;
+
+        /** Когда разрешить пробный запрос (FPlatformTime::Seconds) */
+        double RetryTime = 0.0;
+
+        /** Пробный запрос в работе */
+        bool bProbeInFlight = false;
+    };
+
+    TMap<FString, FHostState> Hosts;
+    FCriticalSection CriticalSection;
+};
@@ -0,0 +1,249 @@
+// by Neil Moore
+
+#include "RadioGardenRoute.h"
+
+namespace
+{
+    // Наибольшая дуга одного параллелепипеда (радианы, около 640 км): длинные отрезки
+    // покрываются цепочкой узких параллелепипедов, а не одним на полглобуса
+    constexpr double RouteMaxArcAngle = 0.1;
+
+    // Отрезок короче этого угла считается точкой
+    constexpr double RouteMinSegmentAngle = 1e-12;
+
+    // Отрезок маршрута: дуга большого круга от Start до End
+    struct FRouteSegment
+    {
+        FVector Start = FVector::ZeroVector;
+        FVector End = FVector::ZeroVector;
+
+        // Единичный вектор в плоскости дуги, перпендикулярный Start и направленный к End
+        FVector Tangent = FVector::ZeroVector;
+
+        // Нормаль плоскости дуги
+        FVector Normal = FVector::ZeroVector;
+
+        // Угловая длина (радианы)
+        double Angle = 0.0;
+
+        // Расстояние от начала маршрута до Start (км)
+        double StartKm = 0.0;
+    };
+
+    double GetAngleBetween(const FVector& A, const FVector& B)
+    {
+        return FMath::Atan2(FVector::CrossProduct(A, B).Size(), FVector::DotProduct(A, B));
+    }
+
+    void BuildRouteSegments(const FRadioGardenRoute& Route, TArray<FRouteSegment>& OutSegments)
+    {
+        OutSegments.Reset(Route.Waypoints.Num() - 1);
+
+        double TotalKm = 0.0;
+        for (int32 WaypointIndex = 1; WaypointIndex < Route.Waypoints.Num(); ++WaypointIndex)
+        {
+            const FRadioGardenCoords& From = Route.Waypoints[WaypointIndex - 1];
+            const FRadioGardenCoords& To = Route.Waypoints[WaypointIndex];
+
+            FRouteSegment& Segment = OutSegments.AddDefaulted_GetRef();
+            Segment.Start = FRadioGardenPlacesIndex::ToUnitVector(From.Latitude, From.Longitude);
+            Segment.End = FRadioGardenPlacesIndex::ToUnitVector(To.Latitude, To.Longitude);
+            Segment.Angle = GetAngleBetween(Segment.Start, Segment.End);
+            Segment.StartKm = TotalKm;
+
+            if (Segment.Angle > RouteMinSegmentAngle)
+            {
+                Segment.Normal = FVector::CrossProduct(Segment.Start, Segment.End).GetSafeNormal();
+                Segment.Tangent = FVector::CrossProduct(Segment.Normal, Segment.Start);
+            }
+            else
+            {
+                Segment.Angle = 0.0;
+            }
+
+            TotalKm += Segment.Angle * FRadioGardenPlacesIndex::EarthRadiusKm;
+        }
+    }
+
+    // Угловое расстояние от точки до отрезка и угол проекции от Start
+    double GetSegmentDistance(const FRouteSegment& Segment, const FVector& Point, double& OutAlongAngle)
+    {
+        if (Segment.Angle > 0.0)
+        {
+            const double Along = FMath::Atan2(FVector::DotProduct(Point, Segment.Tangent), FVector::DotProduct(Point, Segment.Start));
+            if (Along >= 0.0 && Along <= Segment.Angle)
+            {
+                OutAlongAngle = Along;
+                return FMath::Abs(FMath::Asin(FMath::Clamp(FVector::DotProduct(Point, Segment.Normal), -1.0, 1.0)));
+            }
+        }
+
+        // Проекция вне дуги: ближайший конец
+        const double ToStart = GetAngleBetween(Point, Segment.Start);
+        const double ToEnd = Segment.Angle > 0.0 ? GetAngleBetween(Point, Segment.End) : ToStart;
+        OutAlongAngle = ToEnd < ToStart ? Segment.Angle : 0.0;
+        return FMath::Min(ToStart, ToEnd);
+    }
+
+    // Лежит ли угол Angle (по модулю 2pi) в [From, From + Length]
+    bool IsAngleInArc(double Angle, double From, double Length)
+    {
+        return FMath::Fmod(Angle - From + 4.0 * UE_DOUBLE_PI, 2.0 * UE_DOUBLE_PI) <= Length;
+    }
+
+    // Параллелепипед дуги [From, To] отрезка, расширенный на хорду Padding.
+    // Координата k точки дуги Start*cos(t) + Tangent*sin(t) равна R*cos(t - phi), поэтому её
+    // экстремумы внутри дуги - это +-R, если t = phi или t = phi + pi попадает в дугу, иначе концы
+    FBox MakeRouteArcBox(const FRouteSegment& Segment, double From, double To, double Padding)
+    {
+        const FVector ArcStart = Segment.Start * FMath::Cos(From) + Segment.Tangent * FMath::Sin(From);
+        const FVector ArcEnd = Segment.Start * FMath::Cos(To) + Segment.Tangent * FMath::Sin(To);
+
+        FBox Box(ArcStart.ComponentMin(ArcEnd), ArcStart.ComponentMax(ArcEnd));
+        for (int32 Axis = 0; Axis < 3; ++Axis)
+        {
+            const double Radius = FMath::Sqrt(FMath::Square(Segment.Start[Axis]) + FMath::Square(Segment.Tangent[Axis]));
+            const double Phase = FMath::Atan2(Segment.Tangent[Axis], Segment.Start[Axis]);
+            if (IsAngleInArc(Phase, From, To - From))
+            {
+                Box.Max[Axis] = Radius;
+            }
+            if (IsAngleInArc(Phase + UE_DOUBLE_PI, From, To - From))
+            {
+                Box.Min[Axis] = -Radius;
+            }
+        }
+
+        return Box.ExpandBy(Padding + FRadioGardenPlacesIndex::BoxPadding);
+    }
+
+    // Лучшее совпадение места с маршрутом
+    struct FRouteMatch
+    {
+        double CrossAngle = 0.0;
+        double AlongKm = 0.0;
+    };
+}
+
+bool FRadioGardenRouteQuery::Validate(const FRadioGardenRoute& Route, FString& OutError)
+{
+    if (Route.Waypoints.Num() < 2)
+    {
+        OutError = TEXT("Route must have at least 2 waypoints");
+        return false;
+    }
+
+    if (Route.MaxDistanceKm <= 0.0)
+    {
+        OutError = TEXT("Route corridor distance must be positive");
+        return false;
+    }
+
+    for (int32 WaypointIndex = 0; WaypointIndex < Route.Waypoints.Num(); ++WaypointIndex)
+    {
+        const FRadioGardenCoords& Waypoint = Route.Waypoints[WaypointIndex];
+        if (Waypoint.Latitude < -90.0 || Waypoint.Latitude > 90.0)
+        {
+            OutError = TEXT("Route waypoint latitude must be within [-90, 90]");
+            return false;
+        }
+
+        // Между противоположными точками дуга большого круга не определена
+        if (WaypointIndex > 0)
+        {
+            const FRadioGardenCoords& Previous = Route.Waypoints[WaypointIndex - 1];
+            const double Angle = GetAngleBetween(
+                FRadioGardenPlacesIndex::ToUnitVector(Previous.Latitude, Previous.Longitude),
+                FRadioGardenPlacesIndex::ToUnitVector(Waypoint.Latitude, Waypoint.Longitude));
+            if (Angle > UE_DOUBLE_PI - 1e-9)
+            {
+                OutError = TEXT("Adjacent route waypoints must not be antipodal");
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void FRadioGardenRouteQuery::Project(const FRadioGardenRoute& Route, double Latitude, double Longitude, double& OutAlongTrackKm, double& OutCrossTrackKm)
+{
+    TArray<FRouteSegment> Segments;
+    BuildRouteSegments(Route, Segments);
+
+    const FVector Point = FRadioGardenPlacesIndex::ToUnitVector(Latitude, Longitude);
+    double BestCross = MAX_dbl;
+    double BestAlongKm = 0.0;
+    for (const FRouteSegment& Segment : Segments)
+    {
+        double AlongAngle = 0.0;
+        const double Cross = GetSegmentDistance(Segment, Point, AlongAngle);
+        if (Cross < BestCross)
+        {
+            BestCross = Cross;
+            BestAlongKm = Segment.StartKm + AlongAngle * FRadioGardenPlacesIndex::EarthRadiusKm;
+        }
+    }
+
+    OutAlongTrackKm = BestAlongKm;
+    OutCrossTrackKm = BestCross * FRadioGardenPlacesIndex::EarthRadiusKm;
+}
+
+void FRadioGardenRouteQuery::FindPlaces(const FIndexRef& Index, const FRadioGardenRoute& Route, TArray<FNearestPlace>& OutPlaces)
+{
+    OutPlaces.Reset();
+
+    TArray<FRouteSegment> Segments;
+    BuildRouteSegments(Route, Segments);
+
+    const double MaxAngle = FMath::Min(Route.MaxDistanceKm / FRadioGardenPlacesIndex::EarthRadiusKm, UE_DOUBLE_PI);
+    const double Padding = 2.0 * FMath::Sin(MaxAngle * 0.5);
+    const TArray<FRadioGardenPlace>& Places = Index->GetPlaces().Places;
+
+    // Кандидат проверяется только против отрезка, чей параллелепипед его нашёл; место рядом
+    // с несколькими отрезками получает ближайший из них
+    TMap<int32, FRouteMatch> Matches;
+    TArray<int32> Candidates;
+    for (const FRouteSegment& Segment : Segments)
+    {
+        const int32 ArcCount = FMath::Max(1, FMath::CeilToInt32(Segment.Angle / RouteMaxArcAngle));
+        for (int32 ArcIndex = 0; ArcIndex < ArcCount; ++ArcIndex)
+        {
+            Candidates.Reset();
+            Index->FindInBox(MakeRouteArcBox(Segment, Segment.Angle * ArcIndex / ArcCount, Segment.Angle * (ArcIndex + 1) / ArcCount, Padding), Candidates);
+
+            for (const int32 PlaceIndex : Candidates)
+            {
+                const FRadioGardenCoords& Geo = Places[PlaceIndex].Geo;
+                double AlongAngle = 0.0;
+                const double Cross = GetSegmentDistance(Segment, FRadioGardenPlacesIndex::ToUnitVector(Geo.Latitude, Geo.Longitude), AlongAngle);
+                if (Cross > MaxAngle)
+                {
+                    continue;
+                }
+
+                const double AlongKm = Segment.StartKm + AlongAngle * FRadioGardenPlacesIndex::EarthRadiusKm;
+                FRouteMatch* Match = Matches.Find(PlaceIndex);
+                if (!Match)
+                {
+                    Matches.Add(PlaceIndex, FRouteMatch{ Cross, AlongKm });
+                }
+                else if (Cross < Match->CrossAngle || (Cross == Match->CrossAngle && AlongKm < Match->AlongKm))
+                {
+                    *Match = FRouteMatch{ Cross, AlongKm };
+                }
+            }
+        }
+    }
+
+    OutPlaces.Reserve(Matches.Num());
+    for (const TPair<int32, FRouteMatch>& Match : Matches)
+    {
+        OutPlaces.Add(FNearestPlace{ Match.Key, Match.Value.AlongKm });
+    }
+
+    OutPlaces.Sort([](const FNearestPlace& A, const FNearestPlace& B)
+    {
+        return A.Distance < B.Distance || (A.Distance == B.Distance && A.PlaceIndex < B.PlaceIndex);
+    });
+}
@@ -0,0 +1,44 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RadioGardenTypes.h"
+#include "RadioGardenPlacesIndex.h"
+
+/**
+ * Запросы мест вдоль маршрута через пространственный индекс
+ * Каждый отрезок маршрута (дуга большого круга) делится на короткие дуги; для каждой строится
+ * параллелепипед в пространстве единичных векторов, расширенный на ширину коридора,
+ * индекс отбирает кандидатов внутри него, затем расстояние до отрезка считается точно
+ */
+class FRadioGardenRouteQuery
+{
+public:
+    using FIndexRef = FRadioGardenPlacesIndex::FIndexRef;
+    using FNearestPlace = FRadioGardenPlacesIndex::FNearestPlace;
+
+    /**
+     * Проверить параметры маршрута
+     * @param OutError Описание ошибки
+     * @return true если маршрут корректен
+     */
+    static bool Validate(const FRadioGardenRoute& Route, FString& OutError);
+
+    /**
+     * Спроецировать точку на маршрут
+     * Если точка одинаково близка к нескольким отрезкам, берётся ближайшая к началу проекция
+     * @param Route Корректный маршрут (см. Validate)
+     * @param OutAlongTrackKm Расстояние от начала маршрута до проекции (км)
+     * @param OutCrossTrackKm Расстояние от точки до маршрута (км)
+     */
+    static void Project(const FRadioGardenRoute& Route, double Latitude, double Longitude, double& OutAlongTrackKm, double& OutCrossTrackKm);
+
+    /**
+     * Найти места в коридоре маршрута
+     * @param Index Индекс
+     * @param Route Корректный маршрут (см. Validate)
+     * @param OutPlaces Места по возрастанию расстояния вдоль маршрута; Distance - это расстояние (км)
+     */
+    static void FindPlaces(const FIndexRef& Index, const FRadioGardenRoute& Route, TArray<FNearestPlace>& OutPlaces);
+};
@@ -0,0 +1,435 @@
+// by Neil Moore
+
+#include "RadioGardenScheduler.h"
+#include "RadioGardenStats.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/Event.h"
+#include "Containers/Ticker.h"
+#include "Misc/ScopeLock.h"
+
+static TAutoConsoleVariable<float> CVarRadioGardenRateLimitRequestsPerSecond(
+    TEXT("RadioGarden.RateLimit.RequestsPerSecond"),
+    10.0f,
+    TEXT("Наибольшая средняя частота сетевых запросов к API (в секунду, 0 - без ограничения)"));
+
+static TAutoConsoleVariable<int32> CVarRadioGardenRateLimitBurst(
+    TEXT("RadioGarden.RateLimit.Burst"),
+    20,
+    TEXT("Сколько запросов можно отправить подряд после затишья сверх средней частоты"));
+
+static TAutoConsoleVariable<int32> CVarRadioGardenConcurrencyInitial(
+    TEXT("RadioGarden.Concurrency.Initial"),
+    8,
+    TEXT("Начальный предел одновременных сетевых запросов"));
+
+static TAutoConsoleVariable<int32> CVarRadioGardenConcurrencyMin(
+    TEXT("RadioGarden.Concurrency.Min"),
+    2,
+    TEXT("Наименьший предел одновременных сетевых запросов"));
+
+static TAutoConsoleVariable<int32> CVarRadioGardenConcurrencyMax(
+    TEXT("RadioGarden.Concurrency.Max"),
+    32,
+    TEXT("Наибольший предел одновременных сетевых запросов"));
+
+static TAutoConsoleVariable<float> CVarRadioGardenConcurrencyLatencyTolerance(
+    TEXT("RadioGarden.Concurrency.LatencyTolerance"),
+    2.0f,
+    TEXT("Во сколько раз задержка может превышать задержку без нагрузки, чтобы предел ещё рос"));
+
+static TAutoConsoleVariable<int32> CVarRadioGardenSchedulerInteractiveReserve(
+    TEXT("RadioGarden.Scheduler.InteractiveReserve"),
+    2,
+    TEXT("Сколько мест предела одновременных запросов оставлять запросам пользователя (Interactive)"));
+
+static TAutoConsoleVariable<float> CVarRadioGardenSchedulerAgingSeconds(
+    TEXT("RadioGarden.Scheduler.AgingSeconds"),
+    2.0f,
+    TEXT("Через сколько секунд ожидания запрос поднимается на уровень приоритета (0 - без старения)"));
+
+namespace
+{
+    // Во сколько раз уменьшается предел при перегрузке
+    constexpr double ConcurrencyBackoffFactor = 0.5;
+
+    // Скорость, с которой оценка задержки без нагрузки подтягивается к большим замерам
+    constexpr double NoLoadLatencyDrift = 0.01;
+
+    // Как часто синхронное ожидание само продвигает очередь (мс)
+    constexpr uint32 SchedulerSyncPollMs = 10;
+}
+
+FRadioGardenRequestScheduler& FRadioGardenRequestScheduler::Get()
+{
+    static FRadioGardenRequestScheduler Instance;
+    return Instance;
+}
+
+FRadioGardenRequestScheduler::FRadioGardenRequestScheduler()
+{
+    Tokens = FMath::Max(1, CVarRadioGardenRateLimitBurst.GetValueOnAnyThread());
+    LastRefillTime = FPlatformTime::Seconds();
+    ConcurrencyLimit = FMath::Max(1, CVarRadioGardenConcurrencyInitial.GetValueOnAnyThread());
+    UpdateGauges();
+}
+
+uint64 FRadioGardenRequestScheduler::Enqueue(ERadioGardenRequestPriority Priority, const FString& Key, FStartFunction&& Start)
+{
+    const int32 PriorityIndex = static_cast<int32>(Priority);
+    uint64 Ticket = 0;
+    {
+        FScopeLock Lock(&CriticalSection);
+
+        // Новый запрос не обгоняет ожидающие: порядок между ними решает Pump
+        if (GetQueuedCount() > 0 || !TryTakeSlot(PriorityIndex))
+        {
+            Ticket = NextTicket++;
+            Queues[PriorityIndex].Add(FQueuedRequest{ MoveTemp(Start), Key, FPlatformTime::Seconds(), Ticket });
+
+            FRadioGardenStats::ThrottledRequests.fetch_add(1, std::memory_order_relaxed);
+            UpdateGauges();
+        }
+    }
+
+    if (Ticket != 0)
+    {
+        Pump();
+        return Ticket;
+    }
+
+    Start();
+    return 0;
+}
+
+bool FRadioGardenRequestScheduler::Remove(uint64 Ticket)
+{
+    if (Ticket == 0)
+    {
+        return false;
+    }
+
+    FStartFunction Removed;
+    bool bRemoved = false;
+    {
+        FScopeLock Lock(&CriticalSection);
+
+        for (TArray<FQueuedRequest>& Queue : Queues)
+        {
+            const int32 RequestIndex = Queue.IndexOfByPredicate([Ticket](const FQueuedRequest& Request)
+            {
+                return Request.Ticket == Ticket;
+            });
+            if (RequestIndex != INDEX_NONE)
+            {
+                // Запуск освобождается вне блокировки: его захваты могут держать последние ссылки на запрос
+                Removed = MoveTemp(Queue[RequestIndex].Start);
+                Queue.RemoveAt(RequestIndex);
+                bRemoved = true;
+                UpdateGauges();
+                break;
+            }
+        }
+    }
+
+    return bRemoved;
+}
+
+void FRadioGardenRequestScheduler::Acquire(ERadioGardenRequestPriority Priority)
+{
+    struct FSyncWaiter
+    {
+        FEventRef Event;
+    };
+    TSharedRef<FSyncWaiter, ESPMode::ThreadSafe> Waiter = MakeShared<FSyncWaiter, ESPMode::ThreadSafe>();
+
+    Enqueue(Priority, FString(), [Waiter]()
+    {
+        Waiter->Event->Trigger();
+    });
+
+    // Очередь продвигается и отсюда: тикер игрового потока может ждать этого же вызова
+    while (!Waiter->Event->Wait(SchedulerSyncPollMs))
+    {
+        Pump();
+    }
+}
+
+void FRadioGardenRequestScheduler::Promote(const FString& Key, ERadioGardenRequestPriority Priority)
+{
+    const int32 TargetIndex = static_cast<int32>(Priority);
+    bool bPromoted = false;
+    {
+        FScopeLock Lock(&CriticalSection);
+
+        for (int32 PriorityIndex = TargetIndex + 1; PriorityIndex < PriorityCount && !bPromoted; ++PriorityIndex)
+        {
+            TArray<FQueuedRequest>& Queue = Queues[PriorityIndex];
+            const int32 RequestIndex = Queue.IndexOfByPredicate([&Key](const FQueuedRequest& Request)
+            {
+                return Request.Key == Key;
+            });
+            if (RequestIndex == INDEX_NONE)
+            {
+                continue;
+            }
+
+            // Запрос сохраняет время постановки, поэтому встаёт среди запросов того же возраста
+            FQueuedRequest Request = MoveTemp(Queue[RequestIndex]);
+            Queue.RemoveAt(RequestIndex);
+
+            TArray<FQueuedRequest>& Target = Queues[TargetIndex];
+            int32 InsertIndex = Target.Num();
+            while (InsertIndex > 0 && Target[InsertIndex - 1].EnqueueTime > Request.EnqueueTime)
+            {
+                --InsertIndex;
+            }
+            Target.Insert(MoveTemp(Request), InsertIndex);
+            bPromoted = true;
+        }
+    }
+
+    if (bPromoted)
+    {
+        Pump();
+    }
+}
+
+void FRadioGardenRequestScheduler::Release(ERadioGardenEndpointClass EndpointClass, const FRadioGardenHttpResult& Result, double LatencySeconds)
+{
+    {
+        FScopeLock Lock(&CriticalSection);
+
+        --InFlightRequests;
+
+        const double MinLimit = FMath::Max(1, CVarRadioGardenConcurrencyMin.GetValueOnAnyThread());
+        const double MaxLimit = FMath::Max(MinLimit, double(CVarRadioGardenConcurrencyMax.GetValueOnAnyThread()));
+        const double Now = FPlatformTime::Seconds();
+
+        const bool bOverloaded = Result.ResponseCode == 429 || Result.ResponseCode >= 500 || Result.bTimedOut;
+        if (bOverloaded)
+        {
+            // Запросы, отправленные до прошлого уменьшения, уже учтены им
+            if (Now - LatencySeconds >= LastDecreaseTime)
+            {
+                ConcurrencyLimit = FMath::Max(MinLimit, ConcurrencyLimit * ConcurrencyBackoffFactor);
+                LastDecreaseTime = Now;
+
+                FRadioGardenStats::ConcurrencyBackoffs.fetch_add(1, std::memory_order_relaxed);
+                UE_LOG(LogRadioGardenAPI, Verbose, TEXT("RadioGarden API concurrency limit decreased to %.1f (HTTP %d)"), ConcurrencyLimit, Result.ResponseCode);
+            }
+        }
+        else if (Result.ResponseCode != 0 && EndpointClass != ERadioGardenEndpointClass::Places)
+        {
+            // Задержка списка мест определяется его размером, а не нагрузкой
+            NoLoadLatency = (NoLoadLatency <= 0.0 || LatencySeconds < NoLoadLatency)
+                ? LatencySeconds
+                : NoLoadLatency + (LatencySeconds - NoLoadLatency) * NoLoadLatencyDrift;
+
+            const double Tolerance = FMath::Max(1.0f, CVarRadioGardenConcurrencyLatencyTolerance.GetValueOnAnyThread());
+            if (LatencySeconds <= NoLoadLatency * Tolerance)
+            {
+                ConcurrencyLimit += 1.0 / ConcurrencyLimit;
+            }
+        }
+
+        ConcurrencyLimit = FMath::Clamp(ConcurrencyLimit, MinLimit, MaxLimit);
+        UpdateGauges();
+    }
+
+    Pump();
+}
+
+void FRadioGardenRequestScheduler::Shutdown()
+{
+    FTSTicker::FDelegateHandle Handle;
+    {
+        FScopeLock Lock(&CriticalSection);
+
+        bShutdown = true;
+        bTickerScheduled = false;
+        Handle = MoveTemp(TickerHandle);
+        TickerHandle.Reset();
+
+        for (TArray<FQueuedRequest>& Queue : Queues)
+        {
+            Queue.Empty();
+        }
+        UpdateGauges();
+    }
+
+    if (Handle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(Handle);
+    }
+}
+
+void FRadioGardenRequestScheduler::Pump()
+{
+    TArray<FStartFunction> Ready;
+    double TickerDelay = -1.0;
+    {
+        FScopeLock Lock(&CriticalSection);
+
+        const double Now = FPlatformTime::Seconds();
+        bool bAged = false;
+        int32 PriorityIndex = SelectQueue(Now, bAged);
+        while (PriorityIndex != INDEX_NONE && TryTakeSlot(PriorityIndex))
+        {
+            if (bAged)
+            {
+                FRadioGardenStats::AgedRequests.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            Ready.Add(MoveTemp(Queues[PriorityIndex][0].Start));
+            Queues[PriorityIndex].RemoveAt(0, 1, EAllowShrinking::No);
+            PriorityIndex = SelectQueue(Now, bAged);
+        }
+
+        // Место есть, но нет жетона: проснуться, когда появится следующий
+        const float RequestsPerSecond = CVarRadioGardenRateLimitRequestsPerSecond.GetValueOnAnyThread();
+        if (PriorityIndex != INDEX_NONE && RequestsPerSecond > 0.0f && !bTickerScheduled && !bShutdown)
+        {
+            bTickerScheduled = true;
+            TickerDelay = FMath::Max(0.0, (1.0 - Tokens) / RequestsPerSecond);
+        }
+
+        UpdateGauges();
+    }
+
+    if (TickerDelay >= 0.0)
+    {
+        const FTSTicker::FDelegateHandle Handle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this](float)
+        {
+            {
+                FScopeLock Lock(&CriticalSection);
+                bTickerScheduled = false;
+                TickerHandle.Reset();
+            }
+            Pump();
+            return false;
+        }), static_cast<float>(TickerDelay));
+
+        // Тикер мог успеть сработать: тогда запоминать нечего
+        FScopeLock Lock(&CriticalSection);
+        if (bTickerScheduled)
+        {
+            TickerHandle = Handle;
+        }
+    }
+
+    for (FStartFunction& Start : Ready)
+    {
+        Start();
+    }
+}
+
+bool FRadioGardenRequestScheduler::HasSlot(int32 PriorityIndex) const
+{
+    int32 SlotLimit = GetSlotLimit();
+    if (PriorityIndex != static_cast<int32>(ERadioGardenRequestPriority::Interactive))
+    {
+        SlotLimit = FMath::Max(1, SlotLimit - FMath::Max(0, CVarRadioGardenSchedulerInteractiveReserve.GetValueOnAnyThread()));
+    }
+
+    return InFlightRequests < SlotLimit;
+}
+
+bool FRadioGardenRequestScheduler::HasToken()
+{
+    if (CVarRadioGardenRateLimitRequestsPerSecond.GetValueOnAnyThread() <= 0.0f)
+    {
+        return true;
+    }
+
+    RefillTokens(FPlatformTime::Seconds());
+    return Tokens >= 1.0;
+}
+
+bool FRadioGardenRequestScheduler::TryTakeSlot(int32 PriorityIndex)
+{
+    if (!HasSlot(PriorityIndex) || !HasToken())
+    {
+        return false;
+    }
+
+    if (CVarRadioGardenRateLimitRequestsPerSecond.GetValueOnAnyThread() > 0.0f)
+    {
+        Tokens -= 1.0;
+    }
+
+    ++InFlightRequests;
+    return true;
+}
+
+int32 FRadioGardenRequestScheduler::SelectQueue(double Now, bool& bOutAged) const
+{
+    const double AgingSeconds = CVarRadioGardenSchedulerAgingSeconds.GetValueOnAnyThread();
+
+    int32 BestIndex = INDEX_NONE;
+    int32 BestRank = 0;
+    double BestEnqueueTime = 0.0;
+    bOutAged = false;
+
+    for (int32 PriorityIndex = 0; PriorityIndex < PriorityCount; ++PriorityIndex)
+    {
+        if (Queues[PriorityIndex].IsEmpty() || !HasSlot(PriorityIndex))
+        {
+            continue;
+        }
+
+        // Ранг - приоритет за вычетом уровней, набранных ожиданием; при равенстве первым идёт старший запрос
+        const double EnqueueTime = Queues[PriorityIndex][0].EnqueueTime;
+        const int32 AgedLevels = AgingSeconds > 0.0 ? FMath::FloorToInt32((Now - EnqueueTime) / AgingSeconds) : 0;
+        const int32 Rank = FMath::Max(0, PriorityIndex - AgedLevels);
+
+        if (BestIndex == INDEX_NONE || Rank < BestRank || (Rank == BestRank && EnqueueTime < BestEnqueueTime))
+        {
+            BestIndex = PriorityIndex;
+            BestRank = Rank;
+            BestEnqueueTime = EnqueueTime;
+        }
+    }
+
+    // Старение засчитывается, только если запрос обошёл ожидающий запрос более высокого приоритета
+    for (int32 PriorityIndex = 0; PriorityIndex < BestIndex; ++PriorityIndex)
+    {
+        if (!Queues[PriorityIndex].IsEmpty())
+        {
+            bOutAged = true;
+            break;
+        }
+    }
+
+    return BestIndex;
+}
+
+int32 FRadioGardenRequestScheduler::GetQueuedCount() const
+{
+    int32 QueuedCount = 0;
+    for (const TArray<FQueuedRequest>& Queue : Queues)
+    {
+        QueuedCount += Queue.Num();
+    }
+    return QueuedCount;
+}
+
+void FRadioGardenRequestScheduler::RefillTokens(double Now)
+{
+    const double RequestsPerSecond = CVarRadioGardenRateLimitRequestsPerSecond.GetValueOnAnyThread();
+    const double Burst = FMath::Max(1, CVarRadioGardenRateLimitBurst.GetValueOnAnyThread());
+
+    Tokens = FMath::Min(Burst, Tokens + (Now - LastRefillTime) * RequestsPerSecond);
+    LastRefillTime = Now;
+}
+
+int32 FRadioGardenRequestScheduler::GetSlotLimit() const
+{
+    return FMath::Max(1, FMath::FloorToInt32(ConcurrencyLimit));
+}
+
+void FRadioGardenRequestScheduler::UpdateGauges() const
+{
+    FRadioGardenStats::ConcurrencyLimit.store(GetSlotLimit(), std::memory_order_relaxed);
+    FRadioGardenStats::InFlightRequests.store(InFlightRequests, std::memory_order_relaxed);
+    FRadioGardenStats::QueuedRequests.store(GetQueuedCount(), std::memory_order_relaxed);
+}
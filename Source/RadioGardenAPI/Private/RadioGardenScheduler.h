@@ -0,0 +1,146 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RadioGardenHttpRequest.h"
+#include "Containers/Ticker.h"
+
+/**
+ * Общий планировщик сетевых запросов
+ * Запрос стартует, когда есть жетон ограничителя частоты (RadioGarden.RateLimit.*) и свободное место
+ * в пределе одновременных запросов; остальные ждут в очередях по приоритетам.
+ * Первым стартует запрос высшего приоритета, но каждые RadioGarden.Scheduler.AgingSeconds ожидания
+ * поднимают запрос на уровень, поэтому фоновые запросы не голодают. Последние
+ * RadioGarden.Scheduler.InteractiveReserve мест предела доступны только запросам Interactive.
+ * Предел подстраивается по схеме AIMD: растёт на 1 за "окно" запросов, пока задержка близка к
+ * задержке без нагрузки, и уменьшается вдвое при 429, 5xx и таймаутах (не чаще раза на окно)
+ */
+class FRadioGardenRequestScheduler
+{
+public:
+    using FStartFunction = TUniqueFunction<void()>;
+
+    /**
+     * Получить экземпляр
+     */
+    static FRadioGardenRequestScheduler& Get();
+
+    /**
+     * Запустить запрос, как только позволят пределы
+     * @param Priority Приоритет запроса
+     * @param Key Ключ запроса (эндпоинт) для повышения приоритета, см. Promote
+     * @param Start Запускает запрос; вызывается сразу, в потоке, освободившем место, или в потоке тикера.
+     *              По завершении запроса обязательно вызвать Release
+     * @return Номер ожидающего запроса для Remove (0 если запрос уже запущен)
+     */
+    uint64 Enqueue(ERadioGardenRequestPriority Priority, const FString& Key, FStartFunction&& Start);
+
+    /**
+     * Снять ожидающий запрос (например, отменённый); Start не будет вызван, Release не нужен
+     * @param Ticket Номер, полученный от Enqueue
+     * @return false если запрос уже запущен
+     */
+    bool Remove(uint64 Ticket);
+
+    /**
+     * Дождаться места для синхронного запроса; по завершении обязательно вызвать Release
+     */
+    void Acquire(ERadioGardenRequestPriority Priority);
+
+    /**
+     * Поднять приоритет ожидающего запроса, например когда к нему присоединился более важный
+     * @param Key Ключ запроса
+     * @param Priority Новый приоритет; понижения не происходит
+     */
+    void Promote(const FString& Key, ERadioGardenRequestPriority Priority);
+
+    /**
+     * Освободить место запроса и учесть его результат в пределе
+     * @param EndpointClass Класс эндпоинта
+     * @param Result Результат запроса
+     * @param LatencySeconds Время от старта до ответа
+     */
+    void Release(ERadioGardenEndpointClass EndpointClass, const FRadioGardenHttpResult& Result, double LatencySeconds);
+
+    /**
+     * Снять тикер пополнения жетонов и забыть ожидающие запросы (их Start не будет вызван)
+     * Вызывается при выгрузке модуля: после него тикер не обращается к планировщику
+     */
+    void Shutdown();
+
+private:
+    FRadioGardenRequestScheduler();
+
+    /**
+     * Запустить ожидающие запросы, на которые хватает пределов
+     */
+    void Pump();
+
+    /** Ожидающий запрос */
+    struct FQueuedRequest
+    {
+        FStartFunction Start;
+        FString Key;
+        double EnqueueTime = 0.0;
+        uint64 Ticket = 0;
+    };
+
+    static constexpr int32 PriorityCount = static_cast<int32>(ERadioGardenRequestPriority::Background) + 1;
+
+    /** Есть ли место для запроса этого приоритета (под блокировкой) */
+    bool HasSlot(int32 PriorityIndex) const;
+
+    /** Есть ли жетон (под блокировкой, пополняет жетоны) */
+    bool HasToken();
+
+    /** Занять место и жетон (под блокировкой) */
+    bool TryTakeSlot(int32 PriorityIndex);
+
+    /**
+     * Выбрать очередь, чей первый запрос стартует следующим (под блокировкой)
+     * @return INDEX_NONE если ни один запрос не может стартовать по пределу одновременности
+     */
+    int32 SelectQueue(double Now, bool& bOutAged) const;
+
+    /** Число ожидающих запросов (под блокировкой) */
+    int32 GetQueuedCount() const;
+
+    /** Пополнить жетоны (под блокировкой) */
+    void RefillTokens(double Now);
+
+    /** Текущий предел одновременных запросов (под блокировкой) */
+    int32 GetSlotLimit() const;
+
+    /** Обновить показатели в FRadioGardenStats (под блокировкой) */
+    void UpdateGauges() const;
+
+    /** Очереди по приоритетам, в каждой - по времени постановки */
+    TArray<FQueuedRequest> Queues[PriorityCount];
+
+    /** Жетоны ограничителя частоты */
+    double Tokens = 0.0;
+    double LastRefillTime = 0.0;
+
+    /** Предел одновременных запросов (дробный: растёт на 1/предел за ответ) */
+    double ConcurrencyLimit = 0.0;
+    int32 InFlightRequests = 0;
+
+    /** Оценка задержки без нагрузки: быстро падает к меньшим замерам, медленно растёт */
+    double NoLoadLatency = 0.0;
+
+    /** Когда предел уменьшался в последний раз */
+    double LastDecreaseTime = 0.0;
+
+    /** Номер следующего ожидающего запроса */
+    uint64 NextTicket = 1;
+
+    /** Тикер пополнения жетонов запланирован */
+    bool bTickerScheduled = false;
+    FTSTicker::FDelegateHandle TickerHandle;
+
+    /** Модуль выгружается: новые тикеры не ставятся */
+    bool bShutdown = false;
+
+    FCriticalSection CriticalSection;
+};
@@ -0,0 +1,182 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeLock.h"
+#include "RadioGardenCancellation.h"
+#include "RadioGardenStats.h"
+
+/**
+ * Объединение одинаковых одновременных запросов (single-flight)
+ * Первый вызывающий по ключу становится ведущим и выполняет запрос,
+ * остальные присоединяются к нему и получают тот же распаршенный результат.
+ * Отменённый вызывающий отсоединяется от запроса; когда отсоединились все, запрос отменяется
+ * (токен FFlight::Cancellation), а следующий вызывающий по тому же ключу начинает новый запрос
+ */
+template <typename ResultType>
+class TRadioGardenSingleFlight
+{
+public:
+    using FResultRef = TSharedRef<const ResultType, ESPMode::ThreadSafe>;
+    using FWaiter = TFunction<void(const FResultRef&)>;
+
+    /** Выполняющийся запрос */
+    struct FFlight
+    {
+        FString Key;
+        TArray<FWaiter> Waiters;
+
+        /** Присоединившиеся, которые ещё не отменили свои вызовы */
+        int32 ActiveWaiters = 0;
+
+        bool bCompleted = false;
+
+        /** Подписки присоединившихся на отмену их вызовов, снимаются по завершении */
+        TArray<TPair<FRadioGardenCancellationRef, int32>> Subscriptions;
+
+        /** Отменяется, когда отсоединились все присоединившиеся */
+        FRadioGardenCancellationRef Cancellation = MakeShared<FRadioGardenCancellationToken, ESPMode::ThreadSafe>();
+    };
+
+    using FFlightRef = TSharedRef<FFlight, ESPMode::ThreadSafe>;
+    using FFlightPtr = TSharedPtr<FFlight, ESPMode::ThreadSafe>;
+
+    /**
+     * Присоединиться к запросу по ключу
+     * Отменённый вызывающий всё равно получает результат (например, ошибку отмены) и сам его отбрасывает
+     * @param Key Ключ запроса (эндпоинт)
+     * @param Waiter Продолжение, получающее результат
+     * @param Cancellation Токен отмены вызывающего (nullptr - вызов не отменяется)
+     * @return Новый запрос, если вызывающий стал ведущим и должен его выполнить, иначе nullptr
+     */
+    FFlightPtr Join(const FString& Key, FWaiter&& Waiter, const FRadioGardenCancellationPtr& Cancellation = nullptr)
+    {
+        FFlightPtr Flight;
+        bool bLeader = false;
+        {
+            FScopeLock Lock(&CriticalSection);
+
+            if (const FFlightRef* Existing = InFlight.Find(Key))
+            {
+                Flight = *Existing;
+                FRadioGardenStats::CoalescedRequests.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                Flight = MakeShared<FFlight, ESPMode::ThreadSafe>();
+                Flight->Key = Key;
+                InFlight.Add(Key, Flight.ToSharedRef());
+                bLeader = true;
+            }
+
+            Flight->Waiters.Add(MoveTemp(Waiter));
+            ++Flight->ActiveWaiters;
+        }
+
+        if (Cancellation.IsValid())
+        {
+            const int32 CallbackId = Cancellation->OnCancelled([this, WeakFlight = TWeakPtr<FFlight, ESPMode::ThreadSafe>(Flight)]()
+            {
+                if (const FFlightPtr PinnedFlight = WeakFlight.Pin())
+                {
+                    Leave(PinnedFlight.ToSharedRef());
+                }
+            });
+
+            bool bSubscribed = false;
+            {
+                FScopeLock Lock(&CriticalSection);
+                if (!Flight->bCompleted)
+                {
+                    Flight->Subscriptions.Emplace(Cancellation.ToSharedRef(), CallbackId);
+                    bSubscribed = true;
+                }
+            }
+
+            // Запрос успел завершиться до подписки: она больше не нужна
+            if (!bSubscribed)
+            {
+                Cancellation->RemoveOnCancelled(CallbackId);
+            }
+        }
+
+        return bLeader ? Flight : nullptr;
+    }
+
+    /**
+     * Завершить запрос и раздать результат всем присоединившимся
+     * @param Flight Запрос, полученный ведущим от Join
+     * @param Result Результат запроса
+     */
+    void Complete(const FFlightRef& Flight, ResultType&& Result)
+    {
+        Complete(Flight, MakeShared<const ResultType, ESPMode::ThreadSafe>(MoveTemp(Result)));
+    }
+
+    /**
+     * Завершить запрос уже готовым общим результатом
+     * @param Flight Запрос, полученный ведущим от Join
+     * @param SharedResult Результат запроса
+     */
+    void Complete(const FFlightRef& Flight, const FResultRef& SharedResult)
+    {
+        TArray<FWaiter> Waiters;
+        TArray<TPair<FRadioGardenCancellationRef, int32>> Subscriptions;
+        {
+            FScopeLock Lock(&CriticalSection);
+            Flight->bCompleted = true;
+            Waiters = MoveTemp(Flight->Waiters);
+            Subscriptions = MoveTemp(Flight->Subscriptions);
+            RemoveFlight(Flight);
+        }
+
+        // Токены вызывающих живут дольше запроса: их колбэки отсоединения больше не нужны
+        for (const TPair<FRadioGardenCancellationRef, int32>& Subscription : Subscriptions)
+        {
+            Subscription.Key->RemoveOnCancelled(Subscription.Value);
+        }
+
+        for (FWaiter& Waiter : Waiters)
+        {
+            Waiter(SharedResult);
+        }
+    }
+
+private:
+    /**
+     * Отсоединить отменённого вызывающего; последний отсоединившийся отменяет запрос
+     */
+    void Leave(const FFlightRef& Flight)
+    {
+        {
+            FScopeLock Lock(&CriticalSection);
+
+            if (Flight->bCompleted || --Flight->ActiveWaiters > 0)
+            {
+                return;
+            }
+
+            // Новые вызывающие не должны присоединяться к отменённому запросу
+            RemoveFlight(Flight);
+        }
+
+        Flight->Cancellation->Cancel();
+    }
+
+    /** Убрать запрос из выполняющихся, если по его ключу ещё не начат новый (под блокировкой) */
+    void RemoveFlight(const FFlightRef& Flight)
+    {
+        const FFlightRef* Current = InFlight.Find(Flight->Key);
+        if (Current && &Current->Get() == &Flight.Get())
+        {
+            InFlight.Remove(Flight->Key);
+        }
+    }
+
+    /** Выполняющиеся запросы по ключу */
+    TMap<FString, FFlightRef> InFlight;
+
+    /** Защита InFlight и состояния запросов */
+    FCriticalSection CriticalSection;
+};
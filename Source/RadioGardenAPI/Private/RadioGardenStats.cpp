@@ -0,0 +1,87 @@
+// by Neil Moore
+
+#include "RadioGardenStats.h"
+
+std::atomic<int64> FRadioGardenStats::CoalescedRequests{0};
+std::atomic<int64> FRadioGardenStats::CacheHits{0};
+std::atomic<int64> FRadioGardenStats::CacheMisses{0};
+std::atomic<int64> FRadioGardenStats::CacheRevalidations{0};
+std::atomic<int64> FRadioGardenStats::CacheEvictions{0};
+std::atomic<int64> FRadioGardenStats::CacheBytes{0};
+std::atomic<int64> FRadioGardenStats::ParseSkips{0};
+std::atomic<int64> FRadioGardenStats::NearbyCacheHits{0};
+std::atomic<int64> FRadioGardenStats::NearbyCacheMisses{0};
+std::atomic<int64> FRadioGardenStats::PrefetchRequests{0};
+std::atomic<int64> FRadioGardenStats::PrefetchHits{0};
+std::atomic<int64> FRadioGardenStats::PrefetchMisses{0};
+std::atomic<int64> FRadioGardenStats::PrefetchWasted{0};
+std::atomic<int64> FRadioGardenStats::PrefetchBytes{0};
+std::atomic<int64> FRadioGardenStats::Retries{0};
+std::atomic<int64> FRadioGardenStats::CircuitBreakerRejections{0};
+std::atomic<int64> FRadioGardenStats::HedgedRequests{0};
+std::atomic<int64> FRadioGardenStats::HedgeWins{0};
+std::atomic<int64> FRadioGardenStats::ThrottledRequests{0};
+std::atomic<int64> FRadioGardenStats::ConcurrencyBackoffs{0};
+std::atomic<int64> FRadioGardenStats::AgedRequests{0};
+std::atomic<int64> FRadioGardenStats::ConcurrencyLimit{0};
+std::atomic<int64> FRadioGardenStats::InFlightRequests{0};
+std::atomic<int64> FRadioGardenStats::QueuedRequests{0};
+std::atomic<int64> FRadioGardenStats::CancelledRequests{0};
+
+FRadioGardenRequestStats FRadioGardenStats::GetSnapshot()
+{
+    FRadioGardenRequestStats Stats;
+    Stats.CoalescedRequests = CoalescedRequests.load(std::memory_order_relaxed);
+    Stats.CacheHits = CacheHits.load(std::memory_order_relaxed);
+    Stats.CacheMisses = CacheMisses.load(std::memory_order_relaxed);
+    Stats.CacheRevalidations = CacheRevalidations.load(std::memory_order_relaxed);
+    Stats.CacheEvictions = CacheEvictions.load(std::memory_order_relaxed);
+    Stats.CacheBytes = CacheBytes.load(std::memory_order_relaxed);
+    Stats.ParseSkips = ParseSkips.load(std::memory_order_relaxed);
+    Stats.NearbyCacheHits = NearbyCacheHits.load(std::memory_order_relaxed);
+    Stats.NearbyCacheMisses = NearbyCacheMisses.load(std::memory_order_relaxed);
+    Stats.PrefetchRequests = PrefetchRequests.load(std::memory_order_relaxed);
+    Stats.PrefetchHits = PrefetchHits.load(std::memory_order_relaxed);
+    Stats.PrefetchMisses = PrefetchMisses.load(std::memory_order_relaxed);
+    Stats.PrefetchWasted = PrefetchWasted.load(std::memory_order_relaxed);
+    Stats.PrefetchBytes = PrefetchBytes.load(std::memory_order_relaxed);
+    Stats.Retries = Retries.load(std::memory_order_relaxed);
+    Stats.CircuitBreakerRejections = CircuitBreakerRejections.load(std::memory_order_relaxed);
+    Stats.HedgedRequests = HedgedRequests.load(std::memory_order_relaxed);
+    Stats.HedgeWins = HedgeWins.load(std::memory_order_relaxed);
+    Stats.ThrottledRequests = ThrottledRequests.load(std::memory_order_relaxed);
+    Stats.ConcurrencyBackoffs = ConcurrencyBackoffs.load(std::memory_order_relaxed);
+    Stats.AgedRequests = AgedRequests.load(std::memory_order_relaxed);
+    Stats.ConcurrencyLimit = ConcurrencyLimit.load(std::memory_order_relaxed);
+    Stats.InFlightRequests = InFlightRequests.load(std::memory_order_relaxed);
+    Stats.QueuedRequests = QueuedRequests.load(std::memory_order_relaxed);
+    Stats.CancelledRequests = CancelledRequests.load(std::memory_order_relaxed);
+
+    const int64 PrefetchLookups = Stats.PrefetchHits + Stats.PrefetchMisses;
+    Stats.PrefetchHitRate = PrefetchLookups > 0 ? float(double(Stats.PrefetchHits) / PrefetchLookups) : 0.0f;
+    return Stats;
+}
+
+void FRadioGardenStats::Reset()
+{
+    CoalescedRequests.store(0, std::memory_order_relaxed);
+    CacheHits.store(0, std::memory_order_relaxed);
+    CacheMisses.store(0, std::memory_order_relaxed);
+    CacheRevalidations.store(0, std::memory_order_relaxed);
+    CacheEvictions.store(0, std::memory_order_relaxed);
+    ParseSkips.store(0, std::memory_order_relaxed);
+    NearbyCacheHits.store(0, std::memory_order_relaxed);
+    NearbyCacheMisses.store(0, std::memory_order_relaxed);
+    PrefetchRequests.store(0, std::memory_order_relaxed);
+    PrefetchHits.store(0, std::memory_order_relaxed);
+    PrefetchMisses.store(0, std::memory_order_relaxed);
+    PrefetchWasted.store(0, std::memory_order_relaxed);
+    Retries.store(0, std::memory_order_relaxed);
+    CircuitBreakerRejections.store(0, std::memory_order_relaxed);
+    HedgedRequests.store(0, std::memory_order_relaxed);
+    HedgeWins.store(0, std::memory_order_relaxed);
+    ThrottledRequests.store(0, std::memory_order_relaxed);
+    ConcurrencyBackoffs.store(0, std::memory_order_relaxed);
+    AgedRequests.store(0, std::memory_order_relaxed);
+    CancelledRequests.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,100 @@
+// by Neil Moore
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RadioGardenTypes.h"
+#include <atomic>
+
+/**
+ * Счётчики работы плагина
+ * Обновляются из любых потоков, снимок доступен через IRadioGardenAPI::GetRequestStats
+ */
+class FRadioGardenStats
+{
+public:
+    /** Запросы, присоединённые к уже выполняющемуся идентичному запросу */
+    static std::atomic<int64> CoalescedRequests;
+
+    /** Ответы, отданные из кэша без запроса */
+    static std::atomic<int64> CacheHits;
+
+    /** Запросы, для которых в кэше не нашлось записи */
+    static std::atomic<int64> CacheMisses;
+
+    /** Записи, подтверждённые ответом 304 Not Modified */
+    static std::atomic<int64> CacheRevalidations;
+
+    /** Записи, вытесненные из кэша по бюджету */
+    static std::atomic<int64> CacheEvictions;
+
+    /** Текущий объём кэша (байты) */
+    static std::atomic<int64> CacheBytes;
+
+    /** Ответы, для которых повторный парсинг пропущен (содержимое не изменилось) */
+    static std::atomic<int64> ParseSkips;
+
+    /** Поиски ближайших станций, результат которых взят из кэша ячейки геохэша */
+    static std::atomic<int64> NearbyCacheHits;
+
+    /** Поиски ближайших станций, для ячейки которых в кэше не нашлось результата */
+    static std::atomic<int64> NearbyCacheMisses;
+
+    /** Упреждающие запросы станций мест */
+    static std::atomic<int64> PrefetchRequests;
+
+    /** Обычные запросы станций мест, место которых уже загружено упреждением */
+    static std::atomic<int64> PrefetchHits;
+
+    /** Обычные запросы станций мест, не покрытые упреждением */
+    static std::atomic<int64> PrefetchMisses;
+
+    /** Загруженные упреждением места, которые так и не понадобились */
+    static std::atomic<int64> PrefetchWasted;
+
+    /** Объём загруженных упреждением и ещё не использованных ответов (байты) */
+    static std::atomic<int64> PrefetchBytes;
+
+    /** Повторные попытки запросов после временных ошибок */
+    static std::atomic<int64> Retries;
+
+    /** Запросы, отклонённые открытым предохранителем хоста */
+    static std::atomic<int64> CircuitBreakerRejections;
+
+    /** Отправленные дубли задержавшихся запросов */
+    static std::atomic<int64> HedgedRequests;
+
+    /** Дубли, ответившие раньше исходного запроса */
+    static std::atomic<int64> HedgeWins;
+
+    /** Запросы, ожидавшие в очереди планировщика */
+    static std::atomic<int64> ThrottledRequests;
+
+    /** Уменьшения предела одновременных запросов */
+    static std::atomic<int64> ConcurrencyBackoffs;
+
+    /** Запросы, обошедшие в очереди более приоритетные из-за долгого ожидания */
+    static std::atomic<int64> AgedRequests;
+
+    /** Текущий предел одновременных сетевых запросов */
+    static std::atomic<int64> ConcurrencyLimit;
+
+    /** Сетевые запросы в работе */
+    static std::atomic<int64> InFlightRequests;
+
+    /** Запросы в очереди планировщика */
+    static std::atomic<int64> QueuedRequests;
+
+    /** Асинхронные вызовы, отменённые через IRadioGardenAPI::CancelRequest */
+    static std::atomic<int64> CancelledRequests;
+
+    /**
+     * Получить снимок счётчиков
+     */
+    static FRadioGardenRequestStats GetSnapshot();
+
+    /**
+     * Сбросить счётчики
+     */
+    static void Reset();
+};
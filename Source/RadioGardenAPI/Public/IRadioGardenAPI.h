@@ -19,6 +19,9 @@ class URadioGardenAPI : public UInterface
 
 /**
  * Реализация интерфейса Radio Garden API
+ * Асинхронные методы не занимают потоки на время сетевого ожидания:
+ * ответ парсится в фоновой задаче после завершения HTTP запроса, делегат вызывается в игровом потоке.
+ * Каждый асинхронный метод возвращает дескриптор, по которому вызов можно отменить (CancelRequest)
  */
 class IRadioGardenAPI
 {
@@ -36,8 +39,9 @@ public:
     /**
      * Получить список мест с радиостанциями (асинхронно)
      * @param OnCompleted Делегат завершения
+     * @return Дескриптор вызова для CancelRequest
      */
-    static void GetPlacesAsync(const FOnRadioGardenPlacesReceived& OnCompleted);
+    static FRadioGardenRequestHandle GetPlacesAsync(const FOnRadioGardenPlacesReceived& OnCompleted);
 
     /**
      * Получить детальную информацию о месте (синхронно)
@@ -50,8 +54,9 @@ public:
      * Получить детальную информацию о месте (асинхронно)
      * @param PlaceId ID места
      * @param OnCompleted Делегат завершения
+     * @return Дескриптор вызова для CancelRequest
      */
-    static void GetPlaceDetailsAsync(const FString& PlaceId, const FOnRadioGardenPlacesReceived& OnCompleted);
+    static FRadioGardenRequestHandle GetPlaceDetailsAsync(const FString& PlaceId, const FOnRadioGardenPlacesReceived& OnCompleted);
 
     /**
      * Получить станции в месте (синхронно)
@@ -64,8 +69,9 @@ public:
      * Получить станции в месте (асинхронно)
      * @param PlaceId ID места
      * @param OnCompleted Делегат завершения
+     * @return Дескриптор вызова для CancelRequest
      */
-    static void GetPlaceChannelsAsync(const FString& PlaceId, const FOnRadioGardenChannelsReceived& OnCompleted);
+    static FRadioGardenRequestHandle GetPlaceChannelsAsync(const FString& PlaceId, const FOnRadioGardenChannelsReceived& OnCompleted);
 
     // ========== Channels (Станции) ==========
 
@@ -80,8 +86,9 @@ public:
      * Получить информацию о станции (асинхронно)
      * @param ChannelId ID станции
      * @param OnCompleted Делегат завершения
+     * @return Дескриптор вызова для CancelRequest
      */
-    static void GetChannelAsync(const FString& ChannelId, const FOnRadioGardenChannelReceived& OnCompleted);
+    static FRadioGardenRequestHandle GetChannelAsync(const FString& ChannelId, const FOnRadioGardenChannelReceived& OnCompleted);
 
     /**
      * Получить прямую ссылку на поток станции (синхронно)
@@ -96,8 +103,9 @@ public:
      * Получить прямую ссылку на поток станции (асинхронно)
      * @param ChannelId ID станции
      * @param OnCompleted Делегат завершения
+     * @return Дескриптор вызова для CancelRequest
      */
-    static void GetChannelStreamUrlAsync(const FString& ChannelId, const FOnRadioGardenStreamUrlReceived& OnCompleted);
+    static FRadioGardenRequestHandle GetChannelStreamUrlAsync(const FString& ChannelId, const FOnRadioGardenStreamUrlReceived& OnCompleted);
 
     // ========== Search (Поиск) ==========
 
@@ -112,8 +120,9 @@ public:
      * Поиск станций, мест и стран (асинхронно)
      * @param Query Поисковый запрос
      * @param OnCompleted Делегат завершения
+     * @return Дескриптор вызова для CancelRequest
      */
-    static void SearchAsync(const FString& Query, const FOnRadioGardenSearchCompleted& OnCompleted);
+    static FRadioGardenRequestHandle SearchAsync(const FString& Query, const FOnRadioGardenSearchCompleted& OnCompleted);
 
     // ========== Geo (Геолокация) ==========
 
@@ -126,8 +135,16 @@ public:
     /**
      * Получить геолокацию клиента (асинхронно)
      * @param OnCompleted Делегат завершения
+     * @return Дескриптор вызова для CancelRequest
      */
-    static void GetGeolocationAsync(const FOnRadioGardenGeolocationReceived& OnCompleted);
+    static FRadioGardenRequestHandle GetGeolocationAsync(const FOnRadioGardenGeolocationReceived& OnCompleted);
+
+    /**
+     * Забыть геолокацию сессии
+     * Поиск по геолокации запоминает геолокацию клиента на сессию (обновление в фоне - RadioGarden.Geolocation.RefreshSeconds);
+     * после вызова следующий поиск определит её заново
+     */
+    static void ForgetSessionGeolocation();
 
     // ========== Nearby Channels ==========
 
@@ -137,15 +154,142 @@ public:
      * @param Longitude Долгота
      * @param ChannelsCount Количество каналов для получения
      * @param OnCompleted Делегат завершения
+     * @param DeadlineSeconds Дедлайн (секунды, 0 - без дедлайна): по его истечении возвращается частичный результат (bPartial)
+     * @return Дескриптор вызова для CancelRequest
+     */
+    static FRadioGardenRequestHandle GetNearbyChannelsAsync(double Latitude, double Longitude, int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds = 0.0f);
+
+    /**
+     * Получить ближайшие радио станции по координатам с потоковой выдачей (асинхронно)
+     * Каналы выдаются порциями, как только разрешены все более близкие места; порции идут по возрастанию расстояния
+     * @param Latitude Широта
+     * @param Longitude Долгота
+     * @param ChannelsCount Количество каналов для получения
+     * @param OnBatch Делегат порции каналов
+     * @param OnCompleted Делегат завершения (полный список, вызывается после последней порции)
+     * @param DeadlineSeconds Дедлайн (секунды, 0 - без дедлайна)
+     * @return Дескриптор вызова для CancelRequest
      */
-    static void GetNearbyChannelsAsync(double Latitude, double Longitude, int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted);
+    static FRadioGardenRequestHandle GetNearbyChannelsStreamAsync(double Latitude, double Longitude, int32 ChannelsCount,
+        const FOnRadioGardenNearbyChannelsBatch& OnBatch, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds = 0.0f);
+
+    /**
+     * Получить ближайшие радио станции для нескольких точек (асинхронно)
+     * Запросы делят один снимок каталога и его индекс, станции места, нужного нескольким запросам, запрашиваются один раз
+     * @param Queries Точки и количество каналов
+     * @param OnCompleted Делегат завершения (ответы в порядке запросов; успех, если успешен хотя бы один запрос)
+     * @param DeadlineSeconds Дедлайн каждого запроса (секунды, 0 - без дедлайна)
+     * @return Дескриптор вызова для CancelRequest
+     */
+    static FRadioGardenRequestHandle GetNearbyChannelsMultiAsync(const TArray<FRadioGardenNearbyQuery>& Queries, const FOnRadioGardenNearbyChannelsMultiReceived& OnCompleted, float DeadlineSeconds = 0.0f);
 
     /**
      * Получить ближайшие радио станции по геолокации (асинхронно)
+     * Геолокация определяется один раз за сессию и запрашивается параллельно со списком мест,
+     * поэтому повторные вызовы стоят столько же, сколько GetNearbyChannelsAsync
      * @param ChannelsCount Количество каналов для получения
      * @param OnCompleted Делегат завершения
+     * @param DeadlineSeconds Дедлайн от момента вызова, включая определение геолокации (секунды, 0 - без дедлайна)
+     * @return Дескриптор вызова для CancelRequest
+     */
+    static FRadioGardenRequestHandle GetNearbyChannelsByGeolocationAsync(int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds = 0.0f);
+
+    // ========== Areas (Области) ==========
+
+    /**
+     * Получить места в области: круг, прямоугольник (может пересекать 180-й меридиан) или многоугольник (асинхронно)
+     * Места выбираются пространственным индексом каталога без перебора всех мест
+     * @param Area Область
+     * @param OnCompleted Делегат завершения (места по возрастанию расстояния от опорной точки области)
+     * @return Дескриптор вызова для CancelRequest
+     */
+    static FRadioGardenRequestHandle GetPlacesInAreaAsync(const FRadioGardenGeoArea& Area, const FOnRadioGardenPlacesReceived& OnCompleted);
+
+    /**
+     * Получить радио станции мест в области (асинхронно)
+     * Места обходятся от ближайшего к опорной точке области (центр круга, середина прямоугольника, среднее вершин многоугольника)
+     * @param Area Область
+     * @param MaxChannels Максимум каналов (0 - все станции области)
+     * @param OnCompleted Делегат завершения (Distance - расстояние от опорной точки)
+     * @param DeadlineSeconds Дедлайн (секунды, 0 - без дедлайна)
+     * @return Дескриптор вызова для CancelRequest
+     */
+    static FRadioGardenRequestHandle GetChannelsInAreaAsync(const FRadioGardenGeoArea& Area, int32 MaxChannels, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds = 0.0f);
+
+    // ========== Routes (Маршруты) ==========
+
+    /**
+     * Получить места в коридоре вдоль маршрута (асинхронно)
+     * @param Route Точки маршрута и ширина коридора
+     * @param OnCompleted Делегат завершения (места по возрастанию пути вдоль маршрута до их проекции)
+     * @return Дескриптор вызова для CancelRequest
+     */
+    static FRadioGardenRequestHandle GetPlacesAlongRouteAsync(const FRadioGardenRoute& Route, const FOnRadioGardenPlacesReceived& OnCompleted);
+
+    /**
+     * Получить станции мест в коридоре вдоль маршрута (асинхронно)
+     * Станции мест запрашиваются пакетами с ограниченным параллелизмом, как у GetNearbyChannelsAsync
+     * @param Route Точки маршрута и ширина коридора
+     * @param MaxChannels Максимум каналов (0 - все станции коридора)
+     * @param OnCompleted Делегат завершения (Distance - путь вдоль маршрута от первой точки до проекции места)
+     * @param DeadlineSeconds Дедлайн (секунды, 0 - без дедлайна)
+     * @return Дескриптор вызова для CancelRequest
+     */
+    static FRadioGardenRequestHandle GetChannelsAlongRouteAsync(const FRadioGardenRoute& Route, int32 MaxChannels, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds = 0.0f);
+
+    // ========== Cancellation (Отмена) ==========
+
+    /**
+     * Отменить асинхронный вызов
+     * Если вызвать из игрового потока, делегаты вызова больше не вызываются. HTTP запрос прерывается
+     * (или снимается из очереди планировщика), когда его не ждут другие вызовы с тем же запросом;
+     * поиск ближайших станций, областей и маршрутов отменяет все свои запросы мест.
+     * Отмена завершённого или уже отменённого вызова ничего не делает
+     * @param Handle Дескриптор, полученный от асинхронного метода
+     */
+    static void CancelRequest(const FRadioGardenRequestHandle& Handle);
+
+    // ========== Globe View (Глобус) ==========
+
+    /**
+     * Создать вид глобуса: видимые места и кластеры выдаются дельтами относительно предыдущего обновления
+     * @param OnUpdated Делегат обновления (вызывается на каждое обработанное обновление вида)
+     * @return Дескриптор вида
+     */
+    static FRadioGardenGlobeViewHandle CreateGlobeView(const FOnRadioGardenGlobeViewUpdated& OnUpdated);
+
+    /**
+     * Обновить положение камеры вида глобуса
+     * Можно вызывать каждый кадр: отбор и сравнение наборов идут в фоне, пока идёт расчёт,
+     * промежуточные виды заменяются последним
+     * @param Handle Дескриптор вида
+     * @param View Видимая часть глобуса и уровень детализации
+     */
+    static void UpdateGlobeView(const FRadioGardenGlobeViewHandle& Handle, const FRadioGardenGlobeView& View);
+
+    /**
+     * Удалить вид глобуса; после вызова делегат вида больше не вызывается
+     */
+    static void ReleaseGlobeView(const FRadioGardenGlobeViewHandle& Handle);
+
+    // ========== Prefetch (Упреждение) ==========
+
+    /**
+     * Сообщить положение и скорость слушателя для упреждающей загрузки станций мест
+     * Станции мест впереди по пути загружаются заранее и оседают в кэше ответов, так что
+     * GetPlaceChannelsAsync и поиск ближайших станций на пути обходятся без сети.
+     * Загрузка идёт с низким приоритетом в пределах бюджетов RadioGarden.Prefetch.*,
+     * доля попаданий видна в GetRequestStats
+     * @param Latitude Широта слушателя
+     * @param Longitude Долгота слушателя
+     * @param VelocityKmPerSecond Скорость (X - на восток, Y - на север, км/с)
      */
-    static void GetNearbyChannelsByGeolocationAsync(int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted);
+    static void UpdatePrefetchTrajectory(double Latitude, double Longitude, const FVector2D& VelocityKmPerSecond);
+
+    /**
+     * Остановить упреждающую загрузку
+     */
+    static void StopPrefetch();
 
     // ========== Utility ==========
 
@@ -158,4 +302,19 @@ public:
      * Получить базовый URL API
      */
     static FString GetBaseUrl();
+
+    /**
+     * Получить статистику запросов
+     */
+    static FRadioGardenRequestStats GetRequestStats();
+
+    /**
+     * Сбросить статистику запросов
+     */
+    static void ResetRequestStats();
+
+    /**
+     * Очистить кэш ответов
+     */
+    static void ClearResponseCache();
 };
@@ -22,25 +22,28 @@ public:
     /**
      * Получить список всех мест с радиостанциями (асинхронно)
      * @param OnCompleted Делегат завершения
+     * @return Дескриптор вызова для CancelRequest
      */
     UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
-    static void GetPlaces(const FOnRadioGardenPlacesReceived& OnCompleted);
+    static FRadioGardenRequestHandle GetPlaces(const FOnRadioGardenPlacesReceived& OnCompleted);
 
     /**
      * Получить детальную информацию о месте (асинхронно)
      * @param PlaceId ID места
      * @param OnCompleted Делегат завершения
+     * @return Дескриптор вызова для CancelRequest
      */
     UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
-    static void GetPlaceDetails(const FString& PlaceId, const FOnRadioGardenPlacesReceived& OnCompleted);
+    static FRadioGardenRequestHandle GetPlaceDetails(const FString& PlaceId, const FOnRadioGardenPlacesReceived& OnCompleted);
 
     /**
      * Получить все станции в месте (асинхронно)
      * @param PlaceId ID места
      * @param OnCompleted Делегат завершения
+     * @return Дескриптор вызова для CancelRequest
      */
     UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
-    static void GetPlaceChannels(const FString& PlaceId, const FOnRadioGardenChannelsReceived& OnCompleted);
+    static FRadioGardenRequestHandle GetPlaceChannels(const FString& PlaceId, const FOnRadioGardenChannelsReceived& OnCompleted);
 
     // ========== Channels (Станции) ==========
 
@@ -48,17 +51,19 @@ public:
      * Получить информацию о станции (асинхронно)
      * @param ChannelId ID станции
      * @param OnCompleted Делегат завершения
+     * @return Дескриптор вызова для CancelRequest
      */
     UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
-    static void GetChannel(const FString& ChannelId, const FOnRadioGardenChannelReceived& OnCompleted);
+    static FRadioGardenRequestHandle GetChannel(const FString& ChannelId, const FOnRadioGardenChannelReceived& OnCompleted);
 
     /**
      * Получить прямую ссылку на поток станции (асинхронно)
      * @param ChannelId ID станции
      * @param OnCompleted Делегат завершения (bSuccess, StreamUrl)
+     * @return Дескриптор вызова для CancelRequest
      */
     UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
-    static void GetChannelStreamUrl(const FString& ChannelId, const FOnRadioGardenStreamUrlReceived& OnCompleted);
+    static FRadioGardenRequestHandle GetChannelStreamUrl(const FString& ChannelId, const FOnRadioGardenStreamUrlReceived& OnCompleted);
 
     // ========== Search (Поиск) ==========
 
@@ -66,18 +71,26 @@ public:
      * Поиск станций, мест и стран (асинхронно)
      * @param Query Поисковый запрос
      * @param OnCompleted Делегат завершения
+     * @return Дескриптор вызова для CancelRequest
      */
     UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
-    static void Search(const FString& Query, const FOnRadioGardenSearchCompleted& OnCompleted);
+    static FRadioGardenRequestHandle Search(const FString& Query, const FOnRadioGardenSearchCompleted& OnCompleted);
 
     // ========== Geo (Геолокация) ==========
 
     /**
      * Получить геолокацию клиента (асинхронно)
      * @param OnCompleted Делегат завершения
+     * @return Дескриптор вызова для CancelRequest
      */
     UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
-    static void GetGeolocation(const FOnRadioGardenGeolocationReceived& OnCompleted);
+    static FRadioGardenRequestHandle GetGeolocation(const FOnRadioGardenGeolocationReceived& OnCompleted);
+
+    /**
+     * Забыть геолокацию сессии, чтобы поиск по геолокации определил её заново
+     */
+    UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
+    static void ForgetSessionGeolocation();
 
     // ========== Utility ==========
 
@@ -112,21 +125,140 @@ public:
     UFUNCTION(BlueprintPure, Category = "Radio Garden API")
     static FString CoordsToString(const FRadioGardenCoords& Coords);
 
+    /**
+     * Получить статистику запросов
+     * @return Снимок счётчиков
+     */
+    UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
+    static FRadioGardenRequestStats GetRequestStats();
+
     /**
      * Получить ближайшие радио станции по координатам (асинхронно)
      * @param Latitude Широта
      * @param Longitude Долгота
      * @param ChannelsCount Количество каналов для получения
      * @param OnCompleted Делегат завершения
+     * @param DeadlineSeconds Дедлайн (секунды, 0 - без дедлайна)
+     * @return Дескриптор вызова для CancelRequest
+     */
+    UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
+    static FRadioGardenRequestHandle GetNearbyChannels(double Latitude, double Longitude, int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds = 0.0f);
+
+    /**
+     * Получить ближайшие радио станции по координатам порциями (асинхронно)
+     * @param Latitude Широта
+     * @param Longitude Долгота
+     * @param ChannelsCount Количество каналов для получения
+     * @param OnBatch Делегат порции каналов (вызывается несколько раз)
+     * @param OnCompleted Делегат завершения
+     * @param DeadlineSeconds Дедлайн (секунды, 0 - без дедлайна)
+     * @return Дескриптор вызова для CancelRequest
+     */
+    UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
+    static FRadioGardenRequestHandle GetNearbyChannelsStream(double Latitude, double Longitude, int32 ChannelsCount, const FOnRadioGardenNearbyChannelsBatch& OnBatch, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds = 0.0f);
+
+    /**
+     * Получить ближайшие радио станции для нескольких точек (асинхронно)
+     * @param Queries Точки и количество каналов
+     * @param OnCompleted Делегат завершения
+     * @param DeadlineSeconds Дедлайн (секунды, 0 - без дедлайна)
+     * @return Дескриптор вызова для CancelRequest
      */
     UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
-    static void GetNearbyChannels(double Latitude, double Longitude, int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted);
+    static FRadioGardenRequestHandle GetNearbyChannelsMulti(const TArray<FRadioGardenNearbyQuery>& Queries, const FOnRadioGardenNearbyChannelsMultiReceived& OnCompleted, float DeadlineSeconds = 0.0f);
 
     /**
      * Получить ближайшие радио станции по геолокации (асинхронно)
      * @param ChannelsCount Количество каналов для получения
      * @param OnCompleted Делегат завершения
+     * @param DeadlineSeconds Дедлайн (секунды, 0 - без дедлайна)
+     * @return Дескриптор вызова для CancelRequest
+     */
+    UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
+    static FRadioGardenRequestHandle GetNearbyChannelsByGeolocation(int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds = 0.0f);
+
+    /**
+     * Получить места в области (асинхронно)
+     * @param Area Область: круг, прямоугольник или многоугольник
+     * @param OnCompleted Делегат завершения
+     * @return Дескриптор вызова для CancelRequest
+     */
+    UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
+    static FRadioGardenRequestHandle GetPlacesInArea(const FRadioGardenGeoArea& Area, const FOnRadioGardenPlacesReceived& OnCompleted);
+
+    /**
+     * Получить радио станции мест в области (асинхронно)
+     * @param Area Область: круг, прямоугольник или многоугольник
+     * @param MaxChannels Максимум каналов (0 - все станции области)
+     * @param OnCompleted Делегат завершения
+     * @param DeadlineSeconds Дедлайн (секунды, 0 - без дедлайна)
+     * @return Дескриптор вызова для CancelRequest
+     */
+    UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
+    static FRadioGardenRequestHandle GetChannelsInArea(const FRadioGardenGeoArea& Area, int32 MaxChannels, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds = 0.0f);
+
+    /**
+     * Получить места вдоль маршрута
+     * @param Route Точки маршрута и ширина коридора
+     * @param OnCompleted Делегат завершения
+     * @return Дескриптор вызова для CancelRequest
+     */
+    UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
+    static FRadioGardenRequestHandle GetPlacesAlongRoute(const FRadioGardenRoute& Route, const FOnRadioGardenPlacesReceived& OnCompleted);
+
+    /**
+     * Получить станции вдоль маршрута
+     * @param Route Точки маршрута и ширина коридора
+     * @param MaxChannels Максимум каналов (0 - все)
+     * @param OnCompleted Делегат завершения
+     * @param DeadlineSeconds Дедлайн (секунды, 0 - без дедлайна)
+     * @return Дескриптор вызова для CancelRequest
+     */
+    UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
+    static FRadioGardenRequestHandle GetChannelsAlongRoute(const FRadioGardenRoute& Route, int32 MaxChannels, const FOnRadioGardenNearbyChannelsReceived& OnCompleted, float DeadlineSeconds = 0.0f);
+
+    /**
+     * Отменить асинхронный вызов: его делегаты больше не вызываются, ненужные сетевые запросы прерываются
+     * @param Handle Дескриптор, полученный от асинхронного узла
+     */
+    UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
+    static void CancelRequest(const FRadioGardenRequestHandle& Handle);
+
+    /**
+     * Создать вид глобуса
+     * @param OnUpdated Делегат обновления: добавленные и убранные маркеры
+     * @return Дескриптор вида
+     */
+    UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
+    static FRadioGardenGlobeViewHandle CreateGlobeView(const FOnRadioGardenGlobeViewUpdated& OnUpdated);
+
+    /**
+     * Обновить положение камеры вида глобуса
+     * @param Handle Дескриптор вида
+     * @param View Видимая часть глобуса и уровень детализации
+     */
+    UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
+    static void UpdateGlobeView(const FRadioGardenGlobeViewHandle& Handle, const FRadioGardenGlobeView& View);
+
+    /**
+     * Удалить вид глобуса
+     * @param Handle Дескриптор вида
+     */
+    UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
+    static void ReleaseGlobeView(const FRadioGardenGlobeViewHandle& Handle);
+
+    /**
+     * Сообщить положение и скорость слушателя для упреждающей загрузки станций мест
+     * @param Latitude Широта
+     * @param Longitude Долгота
+     * @param VelocityKmPerSecond Скорость (X - на восток, Y - на север, км/с)
+     */
+    UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
+    static void UpdatePrefetchTrajectory(double Latitude, double Longitude, const FVector2D& VelocityKmPerSecond);
+
+    /**
+     * Остановить упреждающую загрузку
      */
     UFUNCTION(BlueprintCallable, Category = "Radio Garden API")
-    static void GetNearbyChannelsByGeolocation(int32 ChannelsCount, const FOnRadioGardenNearbyChannelsReceived& OnCompleted);
+    static void StopPrefetch();
 };
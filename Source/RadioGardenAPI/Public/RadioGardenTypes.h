@@ -47,6 +47,97 @@ struct FRadioGardenCoords
         : Longitude(InLongitude), Latitude(InLatitude) {}
 };
 
+/**
+ * Форма области для запросов мест и станций по области
+ */
+UENUM(BlueprintType)
+enum class ERadioGardenGeoAreaShape : uint8
+{
+    Radius UMETA(DisplayName = "Radius"),
+    Bounds UMETA(DisplayName = "Bounds"),
+    Polygon UMETA(DisplayName = "Polygon")
+};
+
+/**
+ * Область на карте: круг, прямоугольник по широте/долготе или многоугольник
+ */
+USTRUCT(BlueprintType)
+struct FRadioGardenGeoArea
+{
+    GENERATED_BODY()
+
+    /** Форма области */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    ERadioGardenGeoAreaShape Shape = ERadioGardenGeoAreaShape::Radius;
+
+    /** Центр круга (Radius) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    FRadioGardenCoords Center;
+
+    /** Радиус круга в километрах (Radius) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    double RadiusKm = 100.0;
+
+    /** Юго-западный угол (Bounds). Долгота запада больше долготы востока - прямоугольник пересекает 180-й меридиан */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    FRadioGardenCoords SouthWest;
+
+    /** Северо-восточный угол (Bounds) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    FRadioGardenCoords NorthEast;
+
+    /** Вершины многоугольника (Polygon), рёбра - отрезки в координатах широта/долгота, может пересекать 180-й меридиан */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    TArray<FRadioGardenCoords> Polygon;
+
+    FRadioGardenGeoArea() = default;
+
+    static FRadioGardenGeoArea MakeRadius(const FRadioGardenCoords& InCenter, double InRadiusKm)
+    {
+        FRadioGardenGeoArea Area;
+        Area.Shape = ERadioGardenGeoAreaShape::Radius;
+        Area.Center = InCenter;
+        Area.RadiusKm = InRadiusKm;
+        return Area;
+    }
+
+    static FRadioGardenGeoArea MakeBounds(const FRadioGardenCoords& InSouthWest, const FRadioGardenCoords& InNorthEast)
+    {
+        FRadioGardenGeoArea Area;
+        Area.Shape = ERadioGardenGeoAreaShape::Bounds;
+        Area.SouthWest = InSouthWest;
+        Area.NorthEast = InNorthEast;
+        return Area;
+    }
+
+    static FRadioGardenGeoArea MakePolygon(const TArray<FRadioGardenCoords>& InPolygon)
+    {
+        FRadioGardenGeoArea Area;
+        Area.Shape = ERadioGardenGeoAreaShape::Polygon;
+        Area.Polygon = InPolygon;
+        return Area;
+    }
+};
+
+/**
+ * Маршрут: точки, соединённые дугами большого круга, и коридор вокруг них
+ */
+USTRUCT(BlueprintType)
+struct FRadioGardenRoute
+{
+    GENERATED_BODY()
+
+    /** Точки маршрута по порядку (от 2), соседние точки не должны быть диаметрально противоположными */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    TArray<FRadioGardenCoords> Waypoints;
+
+    /** Максимальное расстояние места от маршрута в километрах (половина ширины коридора) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    double MaxDistanceKm = 25.0;
+
+    FRadioGardenRoute() = default;
+};
+
 /**
  * Место (город/локация)
  */
@@ -469,6 +560,33 @@ struct FRadioGardenChannelWithDistance
     FRadioGardenChannelWithDistance() = default;
 };
 
+/**
+ * Ошибка получения станций одного места при поиске ближайших каналов
+ */
+USTRUCT(BlueprintType)
+struct FRadioGardenNearbyPlaceError
+{
+    GENERATED_BODY()
+
+    /** ID места */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    FString PlaceId;
+
+    /** Название места */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    FString PlaceTitle;
+
+    /** Статус запроса станций места (Timeout если место не успело ответить до дедлайна) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    ERadioGardenStatus Status = ERadioGardenStatus::UnknownError;
+
+    /** Сообщение об ошибке */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    FString ErrorMessage;
+
+    FRadioGardenNearbyPlaceError() = default;
+};
+
 /**
  * Результат получения ближайших каналов
  */
@@ -481,6 +599,14 @@ struct FRadioGardenNearbyChannelsResponse : public FRadioGardenApiResponse
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
     TArray<FRadioGardenChannelWithDistance> Channels;
 
+    /** Результат частичный: дедлайн истёк до того, как ответили все нужные места */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    bool bPartial = false;
+
+    /** Места, станции которых получить не удалось */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    TArray<FRadioGardenNearbyPlaceError> PlaceErrors;
+
     FRadioGardenNearbyChannelsResponse() = default;
 };
 
@@ -488,3 +614,331 @@ struct FRadioGardenNearbyChannelsResponse : public FRadioGardenApiResponse
  * Делегат для асинхронного получения ближайших каналов
  */
 DECLARE_DYNAMIC_DELEGATE_OneParam(FOnRadioGardenNearbyChannelsReceived, FRadioGardenNearbyChannelsResponse, Response);
+
+/**
+ * Запрос ближайших каналов для пакетного поиска
+ */
+USTRUCT(BlueprintType)
+struct FRadioGardenNearbyQuery
+{
+    GENERATED_BODY()
+
+    /** Широта */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    double Latitude = 0.0;
+
+    /** Долгота */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    double Longitude = 0.0;
+
+    /** Количество каналов для получения */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int32 ChannelsCount = 10;
+
+    FRadioGardenNearbyQuery() = default;
+    FRadioGardenNearbyQuery(double InLatitude, double InLongitude, int32 InChannelsCount)
+        : Latitude(InLatitude), Longitude(InLongitude), ChannelsCount(InChannelsCount) {}
+};
+
+/**
+ * Результат пакетного поиска ближайших каналов
+ */
+USTRUCT(BlueprintType)
+struct FRadioGardenNearbyChannelsMultiResponse : public FRadioGardenApiResponse
+{
+    GENERATED_BODY()
+
+    /** Ответы в порядке запросов */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    TArray<FRadioGardenNearbyChannelsResponse> Responses;
+
+    FRadioGardenNearbyChannelsMultiResponse() = default;
+};
+
+/**
+ * Делегат для пакетного поиска ближайших каналов
+ */
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnRadioGardenNearbyChannelsMultiReceived, FRadioGardenNearbyChannelsMultiResponse, Response);
+
+/**
+ * Очередная порция ближайших каналов при потоковой выдаче
+ */
+USTRUCT(BlueprintType)
+struct FRadioGardenNearbyChannelsBatch
+{
+    GENERATED_BODY()
+
+    /** Каналы порции по возрастанию расстояния */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    TArray<FRadioGardenChannelWithDistance> Channels;
+
+    /** Граница (км): каналы следующих порций будут не ближе неё, выданный список окончателен до этого расстояния */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    double Watermark = 0.0;
+
+    FRadioGardenNearbyChannelsBatch() = default;
+};
+
+/**
+ * Делегат для порций ближайших каналов (вызывается несколько раз)
+ */
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnRadioGardenNearbyChannelsBatch, FRadioGardenNearbyChannelsBatch, Batch);
+
+/**
+ * Видимая часть глобуса
+ */
+USTRUCT(BlueprintType)
+struct FRadioGardenGlobeView
+{
+    GENERATED_BODY()
+
+    /** Точка глобуса в центре экрана */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    FRadioGardenCoords Center;
+
+    /** Радиус видимой сферической шапки вокруг центра (км) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    double VisibleRadiusKm = 5000.0;
+
+    /** Уровень детализации: чем больше, тем мельче кластеры; выше максимального показываются отдельные места */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int32 ZoomLevel = 0;
+
+    /**
+     * Плоскости пирамиды видимости камеры в системе единичного глобуса
+     * (X - 0° долготы на экваторе, Y - 90° в.д., Z - северный полюс), нормали наружу.
+     * Пустой массив - только сферическая шапка
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    TArray<FPlane> FrustumPlanes;
+
+    FRadioGardenGlobeView() = default;
+};
+
+/**
+ * Маркер на глобусе: место или кластер мест
+ */
+USTRUCT(BlueprintType)
+struct FRadioGardenGlobeMarker
+{
+    GENERATED_BODY()
+
+    /** Идентификатор маркера, неизменный, пока не сменилась версия каталога */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 Id = 0;
+
+    /** Координаты (для кластера - центр, взвешенный по количеству станций) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    FRadioGardenCoords Geo;
+
+    /** Маркер объединяет несколько мест */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    bool bCluster = false;
+
+    /** Количество мест */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int32 PlaceCount = 0;
+
+    /** Количество станций (для кластера - сумма по местам) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int32 Size = 0;
+
+    /** ID места (для кластера - самого крупного места) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    FString PlaceId;
+
+    /** Название места (для кластера - самого крупного места) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    FString Title;
+
+    /** Страна */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    FString Country;
+
+    FRadioGardenGlobeMarker() = default;
+};
+
+/**
+ * Изменение видимых маркеров относительно предыдущего обновления вида
+ */
+USTRUCT(BlueprintType)
+struct FRadioGardenGlobeViewResponse : public FRadioGardenApiResponse
+{
+    GENERATED_BODY()
+
+    /** Маркеры, ставшие видимыми */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    TArray<FRadioGardenGlobeMarker> Added;
+
+    /** Идентификаторы маркеров, переставших быть видимыми */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    TArray<int64> Removed;
+
+    /** Сменилась версия каталога: все прежние маркеры нужно убрать, Added содержит все видимые */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    bool bReset = false;
+
+    /** Сколько маркеров видно после обновления */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int32 VisibleCount = 0;
+
+    /** Уровень детализации, по которому построен ответ */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int32 ZoomLevel = 0;
+
+    FRadioGardenGlobeViewResponse() = default;
+};
+
+/**
+ * Делегат обновления видимых маркеров глобуса
+ */
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnRadioGardenGlobeViewUpdated, FRadioGardenGlobeViewResponse, Response);
+
+/**
+ * Дескриптор вида глобуса
+ */
+USTRUCT(BlueprintType)
+struct FRadioGardenGlobeViewHandle
+{
+    GENERATED_BODY()
+
+    /** Идентификатор вида (0 - недействителен) */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Radio Garden")
+    int32 Id = 0;
+
+    FRadioGardenGlobeViewHandle() = default;
+
+    bool IsValid() const { return Id != 0; }
+};
+
+/**
+ * Дескриптор асинхронного вызова (для отмены)
+ */
+USTRUCT(BlueprintType)
+struct FRadioGardenRequestHandle
+{
+    GENERATED_BODY()
+
+    /** Идентификатор вызова (0 - недействителен) */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Radio Garden")
+    int32 Id = 0;
+
+    FRadioGardenRequestHandle() = default;
+
+    bool IsValid() const { return Id != 0; }
+};
+
+/**
+ * Статистика запросов к API
+ */
+USTRUCT(BlueprintType)
+struct FRadioGardenRequestStats
+{
+    GENERATED_BODY()
+
+    /** Количество дублирующих запросов, присоединённых к уже выполняющимся */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 CoalescedRequests = 0;
+
+    /** Ответы, отданные из кэша без запроса */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 CacheHits = 0;
+
+    /** Запросы, для которых в кэше не нашлось записи */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 CacheMisses = 0;
+
+    /** Записи кэша, подтверждённые ответом 304 Not Modified */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 CacheRevalidations = 0;
+
+    /** Записи, вытесненные из кэша по бюджету памяти */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 CacheEvictions = 0;
+
+    /** Текущий объём кэша ответов (байты) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 CacheBytes = 0;
+
+    /** Ответы, повторный парсинг которых пропущен */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 ParseSkips = 0;
+
+    /** Поиски ближайших станций, результат которых взят из кэша ячейки геохэша */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 NearbyCacheHits = 0;
+
+    /** Поиски ближайших станций, для ячейки которых в кэше не нашлось результата */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 NearbyCacheMisses = 0;
+
+    /** Упреждающие запросы станций мест по траектории */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 PrefetchRequests = 0;
+
+    /** Запросы станций мест, место которых уже загружено упреждением */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 PrefetchHits = 0;
+
+    /** Запросы станций мест, не покрытые упреждением (пока оно включено): места без упреждения, повторные и устаревшие */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 PrefetchMisses = 0;
+
+    /** Загруженные упреждением места, которые устарели неиспользованными */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 PrefetchWasted = 0;
+
+    /** Объём загруженных упреждением и ещё не использованных ответов (байты) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 PrefetchBytes = 0;
+
+    /** Доля попаданий упреждения: PrefetchHits / (PrefetchHits + PrefetchMisses) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    float PrefetchHitRate = 0.0f;
+
+    /** Повторные попытки запросов после временных ошибок */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 Retries = 0;
+
+    /** Запросы, отклонённые открытым предохранителем хоста */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 CircuitBreakerRejections = 0;
+
+    /** Отправленные дубли задержавшихся запросов */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 HedgedRequests = 0;
+
+    /** Дубли, ответившие раньше исходного запроса */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 HedgeWins = 0;
+
+    /** Запросы, ожидавшие в очереди планировщика (ограничение частоты или одновременности) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 ThrottledRequests = 0;
+
+    /** Уменьшения предела одновременных запросов из-за 429, 5xx и таймаутов */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 ConcurrencyBackoffs = 0;
+
+    /** Запросы, обошедшие в очереди более приоритетные из-за долгого ожидания */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 AgedRequests = 0;
+
+    /** Текущий предел одновременных сетевых запросов */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 ConcurrencyLimit = 0;
+
+    /** Сетевые запросы в работе */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 InFlightRequests = 0;
+
+    /** Запросы в очереди планировщика */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 QueuedRequests = 0;
+
+    /** Асинхронные вызовы, отменённые через CancelRequest */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Radio Garden")
+    int64 CancelledRequests = 0;
+
+    FRadioGardenRequestStats() = default;
+};
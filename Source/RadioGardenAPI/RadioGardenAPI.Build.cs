@@ -1,3 +1,4 @@
+using System.IO;
 using UnrealBuildTool;
 
 public class RadioGardenAPI : ModuleRules
@@ -13,7 +14,15 @@ public class RadioGardenAPI : ModuleRules
 
         PrivateDependencyModuleNames.AddRange(new string[]
         {
-            "JsonUtilities"
+            "JsonUtilities", "Projects"
         });
+
+        // Снимок каталога мест, поставляемый со сборкой (создаётся командой RadioGarden.Catalog.SaveBundled).
+        // Кладётся отдельным файлом вне pak, чтобы читаться с диска без распаковки
+        string BundledCatalog = Path.Combine(PluginDirectory, "Resources", "Catalog", "Places.rgcat");
+        if (File.Exists(BundledCatalog))
+        {
+            RuntimeDependencies.Add(BundledCatalog, StagedFileType.NonUFS);
+        }
     }
 }